@@ -0,0 +1,28 @@
+/*
+ * This source file is part of an OSTIS project. For the latest info, see http://ostis.net
+ * Distributed under the MIT License
+ * (See accompanying file COPYING.MIT or copy at http://opensource.org/licenses/MIT)
+ */
+
+#pragma once
+
+#include <sc-memory/sc_agent.hpp>
+
+namespace inference
+{
+/**
+ * Cancels direct inference action that is the first argument, cancelled inference finishes unsuccessfully. Initiated
+ * action that is not started yet is cancelled when its agent starts it
+ */
+class CancelInferenceAgent : public ScActionInitiatedAgent
+{
+public:
+  ScAddr GetActionClass() const override;
+
+  ScResult DoProgram(ScActionInitiatedEvent const & event, ScAction & action) override;
+
+private:
+  bool IsInitiatedAndNotFinished(ScAddr const & inferenceAction) const;
+};
+
+}  // namespace inference
@@ -13,8 +13,6 @@ namespace inference
 class DirectInferenceAgent : public ScActionInitiatedAgent
 {
 public:
-  DirectInferenceAgent();
-
   ScAddr GetActionClass() const override;
 
   ScResult DoProgram(ScActionInitiatedEvent const & event, ScAction & action) override;
@@ -0,0 +1,91 @@
+/*
+ * This source file is part of an OSTIS project. For the latest info, see http://ostis.net
+ * Distributed under the MIT License
+ * (See accompanying file COPYING.MIT or copy at http://opensource.org/licenses/MIT)
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <sc-memory/sc_addr.hpp>
+
+namespace inference
+{
+/// Flag to stop inference run from other thread. Inference checks it between formulas, search results and generations
+class CancellationToken
+{
+public:
+  void Cancel()
+  {
+    isCancelled = true;
+  }
+
+  bool IsCancelled() const
+  {
+    return isCancelled;
+  }
+
+private:
+  std::atomic<bool> isCancelled{false};
+};
+
+/**
+ * Cancellation tokens of running inference actions. Cancellation of initiated action that is not registered yet is
+ * kept until the action is registered or unregistered. It is kept forever if the action is never performed
+ */
+class InferenceCancellationRegistry
+{
+public:
+  /// Registration of action while it is performed, action is unregistered on any exit from the scope
+  class Registration
+  {
+  public:
+    explicit Registration(ScAddr const & action);
+
+    ~Registration();
+
+    Registration(Registration const &) = delete;
+    Registration & operator=(Registration const &) = delete;
+
+    std::shared_ptr<CancellationToken> const & GetToken() const;
+
+  private:
+    ScAddr const action;
+    std::shared_ptr<CancellationToken> const token;
+  };
+
+  static InferenceCancellationRegistry & GetInstance();
+
+  /**
+   * Create token for the action, token is shared by all registrations of the same action. Token is cancelled if
+   * cancellation of the action is pending
+   */
+  std::shared_ptr<CancellationToken> Register(ScAddr const & action);
+
+  /// Remove token and pending cancellation of the action
+  void Unregister(ScAddr const & action);
+
+  /// Cancel action if it is running, returns false if action is not registered
+  bool Cancel(ScAddr const & action);
+
+  /// Keep cancellation of action that is not registered yet, its token is cancelled on registration
+  void CancelOnRegistration(ScAddr const & action);
+
+  size_t Size() const;
+
+  size_t GetPendingCancellationsAmount() const;
+
+private:
+  InferenceCancellationRegistry() = default;
+
+  mutable std::mutex mutex;
+  std::unordered_map<ScAddr, std::shared_ptr<CancellationToken>, ScAddrHashFunc> tokens;
+  std::unordered_set<ScAddr, ScAddrHashFunc> pendingCancellations;
+};
+
+}  // namespace inference
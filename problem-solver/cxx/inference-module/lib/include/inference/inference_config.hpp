@@ -6,6 +6,9 @@
 
 #pragma once
 
+#include <chrono>
+#include <string>
+
 #include <sc-memory/sc_addr.hpp>
 
 #include "inference/types.hpp"
@@ -28,7 +31,8 @@ enum SolutionTreeType
 {
   TREE_FULL = 1,
   TREE_ONLY_SUCCESS_BRANCH = 2,
-  TREE_ONLY_OUTPUT_STRUCTURE = 3
+  TREE_ONLY_OUTPUT_STRUCTURE = 3,
+  TREE_COMPACT = 4
 };
 
 enum SearchType
@@ -47,7 +51,32 @@ enum OutputStructureFillingType
 enum AtomicLogicalFormulaSearchBeforeGenerationType
 {
   SEARCH_WITH_REPLACEMENTS = 1,
-  SEARCH_WITHOUT_REPLACEMENTS = 2
+  SEARCH_WITHOUT_REPLACEMENTS = 2,
+  CHECK_REPLACEMENTS_EXISTENCE = 3
+};
+
+enum DisjunctionComputationType
+{
+  COMPUTE_SEQUENTIALLY = 1,
+  COMPUTE_IN_PARALLEL = 2
+};
+
+enum SearchResultsMemoizationType
+{
+  DONT_MEMOIZE_SEARCH_RESULTS = 1,
+  MEMOIZE_SEARCH_RESULTS = 2
+};
+
+enum FormulasApplicationType
+{
+  APPLY_SEQUENTIALLY = 1,
+  APPLY_PIPELINED = 2
+};
+
+enum InferenceIterationType
+{
+  ITERATE_ONCE = 1,
+  ITERATE_UNTIL_FIXPOINT = 2
 };
 
 struct InferenceConfig
@@ -58,6 +87,37 @@ struct InferenceConfig
   SearchType searchType;
   OutputStructureFillingType fillingType;
   AtomicLogicalFormulaSearchBeforeGenerationType atomicLogicalFormulaSearchBeforeGenerationType;
+  DisjunctionComputationType disjunctionComputationType;
+  SearchResultsMemoizationType searchResultsMemoizationType;
+  FormulasApplicationType formulasApplicationType;
+  InferenceIterationType iterationType;
+};
+
+/// Limits of one inference run, zero value means that limit is not set
+struct InferenceBudget
+{
+  /// Maximum amount of replacements columns of atomic logical formula search result or join of operands
+  size_t maxReplacementsColumns = 0;
+  /// Maximum amount of constructions generated by atomic logical formulas
+  size_t maxGeneratedConstructions = 0;
+  std::chrono::milliseconds timeLimit = std::chrono::milliseconds::zero();
+  /// Maximum size in bytes of sc-addresses stored in one replacements table
+  size_t maxReplacementsMemory = 0;
+  /// Maximum amount of rounds of formulas applying when inference is iterated until fixpoint
+  size_t maxRounds = 0;
+};
+
+/// Explain mode of one inference run, executed operators of formulas are recorded if any output is set
+struct InferenceExplainParams
+{
+  /// Path of JSON file to write executed operators tree to
+  std::string traceFilePath;
+  /// Generate structure with executed operators tree and connect it with solution by nrel_inference_trace
+  bool generateTraceStructure = false;
+  /// Path of JSON file in Chrome trace event format to write sc-memory calls issued by formulas to
+  std::string memoryProfileFilePath;
+  /// Measure sc-memory calls issued by formulas even if they are not written to file
+  bool profileMemoryCalls = false;
 };
 
 struct InferenceParams
@@ -67,5 +127,7 @@ struct InferenceParams
   ScAddrUnorderedSet inputStructures;
   ScAddr outputStructure;
   ScAddr targetStructure;
+  InferenceBudget budget;
+  InferenceExplainParams explain;
 };
 }  // namespace inference
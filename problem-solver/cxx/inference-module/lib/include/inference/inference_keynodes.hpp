@@ -15,10 +15,14 @@ class InferenceKeynodes : public ScKeynodes
 public:
   static inline ScKeynode const action_direct_inference{"action_direct_inference"};
 
+  static inline ScKeynode const action_cancel_inference{"action_cancel_inference"};
+
   static inline ScKeynode const concept_solution{"concept_solution"};
 
   static inline ScKeynode const concept_success_solution{"concept_success_solution"};
 
+  static inline ScKeynode const concept_partial_solution{"concept_partial_solution"};
+
   static inline ScKeynode const concept_template_with_links{"concept_template_with_links"};
 
   static inline ScKeynode const concept_template_for_generation{"concept_template_for_generation"};
@@ -40,6 +44,10 @@ public:
   static inline ScKeynode const rrel_then{"rrel_then"};
 
   static inline ScKeynode const nrel_output_structure{"nrel_output_structure"};
+
+  static inline ScKeynode const nrel_inference_trace{"nrel_inference_trace"};
+
+  static inline ScKeynode const concept_compact_replacements{"concept_compact_replacements"};
 };
 
 }  // namespace inference
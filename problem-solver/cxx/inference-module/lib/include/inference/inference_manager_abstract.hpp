@@ -11,10 +11,21 @@
 #include "inference/inference_config.hpp"
 #include "inference/solution_tree_manager_abstract.hpp"
 
+namespace utils
+{
+class ScMemoryProfiler;
+}  // namespace utils
+
 namespace inference
 {
 class TemplateManagerAbstract;
 class TemplateSearcherAbstract;
+class ThreadPool;
+class AtomSearchResultsMemo;
+class FormulaMetadataCache;
+class InferenceBudgetTracker;
+class CancellationToken;
+class ExplainTrace;
 class LogicFormulaResult;
 
 using ScAddrQueue = std::queue<ScAddr>;
@@ -30,9 +41,29 @@ public:
   void SetTemplateSearcher(std::shared_ptr<TemplateSearcherAbstract> searcher);
   void SetTemplateManager(std::shared_ptr<TemplateManagerAbstract> manager);
   void SetSolutionTreeManager(std::shared_ptr<SolutionTreeManagerAbstract> manager);
+  /// Set pool to compute independent parts of formulas concurrently, formulas are computed sequentially without it
+  void SetThreadPool(std::shared_ptr<ThreadPool> pool);
+  /// Set memo to reuse search results of atomic logical formulas with the same structure during inference run
+  void SetSearchResultsMemo(std::shared_ptr<AtomSearchResultsMemo> memo);
+  /// Set formulas metadata cache shared with other managers, template searcher must be set before
+  void SetFormulaMetadataCache(std::shared_ptr<FormulaMetadataCache> const & cache);
+  /// Set token to stop inference run from other thread, stopped inference generates partial solution
+  void SetCancellationToken(std::shared_ptr<CancellationToken const> token);
 
   std::shared_ptr<SolutionTreeManagerAbstract> GetSolutionTreeManager();
 
+  /// Check if the last inference run was stopped because its budget is exhausted, its solution is partial then
+  bool IsBudgetExhausted() const;
+
+  /// Get amount of rounds of formulas applying started by the last inference run
+  size_t GetRoundsAmount() const;
+
+  /// Get executed operators tree of the last inference run, it is recorded only if explain output is set in params
+  std::shared_ptr<ExplainTrace const> GetExplainTrace() const;
+
+  /// Get sc-memory calls of the last inference run by formulas, they are measured only if profiling is set in params
+  std::shared_ptr<utils::ScMemoryProfiler const> GetMemoryProfiler() const;
+
   /**
    * @brief Iterate over formulas set and use formulas to generate knowledge
    * @param formulasSet is an oriented set of formulas sets to apply
@@ -45,9 +76,13 @@ public:
   // TODO: Need to implement common logic of inference rules (e.g. modus ponens)
   LogicFormulaResult UseFormula(ScAddr const & formula, ScAddr const & outputStructure);
 
-  void FillFormulaFixedArgumentsIdentifiers(ScAddr const & formula, ScAddr const & firstFixedArgument) const;
+  /**
+   * @brief Read formula fixed arguments from rrel_1, rrel_2 etc. in one pass over formula outgoing arcs
+   * @returns fixed arguments ordered by role relations numbers until the first missing number
+   */
+  ScAddrVector GetFormulaFixedArguments(ScAddr const & formula) const;
 
-  void FormTemplateManagerFixedArguments(ScAddr const & formula, ScAddr const & firstFixedArgument);
+  void FormTemplateManagerFixedArguments(ScAddrVector const & fixedArguments);
   void ResetTemplateManager(std::shared_ptr<TemplateManagerAbstract> otherTemplateManager);
 
   std::vector<ScAddrQueue> CreateFormulasQueuesListByPriority(ScAddr const & formulasSet);
@@ -55,12 +90,34 @@ public:
   ScAddrQueue CreateQueue(ScAddr const & set);
 
 protected:
+  /// Start tracking budget of inference run, must be called before formulas are applied
+  void StartBudgetTracking(InferenceBudget const & budget);
+
+  /// Check if inference run should stop applying formulas
+  bool ShouldStop();
+
+  /// Mark solution as partial if budget is exhausted
+  void FinishBudgetTracking();
+
+  /// Start recording executed operators of formulas and measuring sc-memory calls if explain output is set
+  void StartExplain(InferenceExplainParams const & params);
+
+  /// Write recorded operators and measured sc-memory calls to explain outputs
+  void FinishExplain();
+
   ScMemoryContext * context;
   utils::ScLogger * logger;
 
   std::shared_ptr<TemplateManagerAbstract> templateManager;
   std::shared_ptr<TemplateSearcherAbstract> templateSearcher;
   std::shared_ptr<SolutionTreeManagerAbstract> solutionTreeManager;
+  std::shared_ptr<ThreadPool> threadPool;
+  std::shared_ptr<AtomSearchResultsMemo> searchResultsMemo;
+  std::shared_ptr<InferenceBudgetTracker> budgetTracker;
+  std::shared_ptr<CancellationToken const> cancellationToken;
+  std::shared_ptr<ExplainTrace> explainTrace;
+  std::shared_ptr<utils::ScMemoryProfiler> memoryProfiler;
+  InferenceExplainParams explainParams;
 
   std::unordered_set<ScAddr, ScAddrHashFunc> outputStructureElements;
 };
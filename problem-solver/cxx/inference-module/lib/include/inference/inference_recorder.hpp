@@ -0,0 +1,92 @@
+/*
+ * This source file is part of an OSTIS project. For the latest info, see http://ostis.net
+ * Distributed under the MIT License
+ * (See accompanying file COPYING.MIT or copy at http://opensource.org/licenses/MIT)
+ */
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+#include <sc-memory/sc_memory.hpp>
+
+#include "inference/inference_config.hpp"
+
+namespace inference
+{
+/// Inference request restored from snapshot, its params refer to elements generated by loading
+struct InferenceSnapshot
+{
+  InferenceConfig config;
+  InferenceParams params;
+};
+
+/**
+ * Records inference request with knowledge base neighbourhood of its elements into a binary snapshot, that can be
+ * loaded into other sc-memory to reproduce inference without the whole knowledge base.
+ * Layout: magic (uint32), format version (uint32), config fields (uint32 each), budget limits (uint64 each), elements
+ * amount (uint64) and elements, then params as elements indices. Element is written as its type (uint32), indices of
+ * source and target (uint64 each) if it is a connector, content if it is a link and system identifier. Ends of
+ * connector are written before it. Strings are written as length (uint64) and bytes, all numbers are written in the
+ * host byte order.
+ */
+class InferenceRecorder
+{
+public:
+  /**
+   * @param maxDepth is a maximum amount of connectors and elements passed from elements of request or formulas to
+   * recorded element
+   * @param maxElementConnectors is a maximum amount of connectors of element to record its neighbourhood, elements with
+   * more connectors, like keynodes of common relations, are recorded without their neighbourhood. Elements of request
+   * and formulas reached from formulas set are recorded with their neighbourhood whatever amount of connectors they have
+   */
+  explicit InferenceRecorder(ScMemoryContext * context, size_t maxDepth = 8, size_t maxElementConnectors = 1000);
+
+  /// Serialize config, budget, formulas set, arguments, structures of params and elements reachable from them
+  std::string Record(InferenceConfig const & config, InferenceParams const & params);
+
+  void RecordToFile(InferenceConfig const & config, InferenceParams const & params, std::string const & filePath);
+
+  /**
+   * @brief Generate elements of snapshot in sc-memory
+   * @param snapshot is a content written by `Record`
+   * @returns config and params of recorded request. Elements with system identifiers that already exist are reused,
+   * explain params are not recorded
+   */
+  static InferenceSnapshot Load(ScMemoryContext * context, std::string const & snapshot);
+
+  static InferenceSnapshot LoadFromFile(ScMemoryContext * context, std::string const & filePath);
+
+private:
+  static inline uint32_t const MAGIC = 0x534C4353;  // "SCLS"
+  static inline uint32_t const FORMAT_VERSION = 1;
+
+  /// Elements of request and formulas are always expanded, roles are ordered by priority
+  enum class ElementRole
+  {
+    NEIGHBOURHOOD,
+    REQUEST,
+    FORMULA
+  };
+
+  uint64_t AddElement(ScAddr const & element);
+
+  /// Get outgoing connectors of element followed by incoming ones, returns false if there are more than maxConnectors
+  bool GetConnectors(
+      ScAddr const & element,
+      size_t maxConnectors,
+      ScAddrVector & connectors,
+      size_t & outgoingConnectorsAmount) const;
+
+  void RecordNeighbourhood(ScAddr const & formulasSet, ScAddrVector const & requestElements);
+
+  ScMemoryContext * context;
+  size_t const maxDepth;
+  size_t const maxElementConnectors;
+
+  std::unordered_map<ScAddr, uint64_t, ScAddrHashFunc> elementsIndices;
+  std::string elementsContent;
+};
+
+}  // namespace inference
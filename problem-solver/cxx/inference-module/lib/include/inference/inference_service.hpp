@@ -0,0 +1,122 @@
+/*
+ * This source file is part of an OSTIS project. For the latest info, see http://ostis.net
+ * Distributed under the MIT License
+ * (See accompanying file COPYING.MIT or copy at http://opensource.org/licenses/MIT)
+ */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <sc-memory/sc_memory.hpp>
+#include <sc-memory/sc_event_subscription.hpp>
+
+#include "inference/inference_manager_abstract.hpp"
+
+namespace inference
+{
+class FormulaMetadataCache;
+
+/**
+ * Persistent state shared by inference requests: formulas metadata with classes of formulas variables and thread
+ * pool. Managers constructed by the service reuse it, so warm-up work is not repeated for every request. Metadata of
+ * formula is invalidated when it is added to or erased from formulas sets used by requests or their subsets, metadata
+ * of atomic logical formula is invalidated when its structure is changed. Atomic logical formulas of formula that
+ * leaves all watched sets are not watched anymore. Arguments of classes depend on request arguments, so they are
+ * indexed by every request. The service is thread safe, managers constructed by it can be used concurrently
+ */
+class InferenceService
+{
+public:
+  static InferenceService & GetInstance();
+
+  ~InferenceService();
+
+  void Start();
+
+  /// Stop watching formulas sets and release shared state, managers constructed before keep working with it
+  void Stop();
+
+  bool IsRunning() const;
+
+  std::unique_ptr<InferenceManagerAbstract> ConstructDirectInferenceManagerAll(
+      ScMemoryContext * context,
+      utils::ScLogger * logger,
+      InferenceConfig const & inferenceFlowConfig,
+      ScAddr const & formulasSet);
+
+  std::unique_ptr<InferenceManagerAbstract> ConstructDirectInferenceManagerTarget(
+      ScMemoryContext * context,
+      utils::ScLogger * logger,
+      InferenceConfig const & inferenceFlowConfig,
+      ScAddr const & formulasSet);
+
+  std::shared_ptr<FormulaMetadataCache> GetFormulaMetadataCache() const;
+
+  size_t GetWatchedFormulasSetsAmount() const;
+
+  /// Get amount of watched formulas sets and their subsets
+  size_t GetWatchedSetsAmount() const;
+
+  size_t GetWatchedFormulasAmount() const;
+
+private:
+  using Subscriptions = std::vector<std::shared_ptr<ScEventSubscription>>;
+
+  InferenceService() = default;
+
+  void Share(std::unique_ptr<InferenceManagerAbstract> & manager, InferenceConfig const & inferenceFlowConfig);
+
+  /// Subscribe to changes of formulas set and its subsets of formulas
+  void Watch(ScAddr const & formulasSet);
+
+  /// @param isFormulasSet is true if subsets added to the set should be watched too
+  void WatchSet(ScAddr const & set, bool isFormulasSet);
+
+  void WatchAddedSet(ScAddr const & set);
+
+  /// Subscribe to changes of structure of atomic logical formula which metadata is in the given cache
+  void WatchFormula(FormulaMetadataCache const * cache, ScAddr const & formula);
+
+  void OnFormulaAdded(ScAddr const & formula);
+
+  /**
+   * @brief Invalidate metadata of element erased from watched set. If formula leaves all watched sets, or subset leaves
+   * all formulas sets with its formulas, then their atomic logical formulas are not watched anymore
+   * @param erasedArc is arc from set to element that is being erased
+   * @param isFormulasSet is true if element is erased from formulas set, so it is a subset of formulas
+   */
+  void OnFormulaErased(ScAddr const & element, ScAddr const & erasedArc, bool isFormulasSet);
+
+  void OnFormulaChanged(ScAddr const & formula);
+
+  /// Check if any of the sets contains element by arc other than the erased one
+  bool IsInSets(ScAddr const & element, ScAddr const & erasedArc, ScAddrUnorderedSet const & sets) const;
+
+  /// Collect formula with its main key element, operands of its connectives and atomic logical formulas
+  void CollectFormulaElements(ScAddr const & formula, ScAddrUnorderedSet & elements) const;
+
+  /// Move subscriptions of element to released ones, they are destroyed outside of event callbacks
+  void ReleaseSubscriptions(
+      std::unordered_map<ScAddr, Subscriptions, ScAddrHashFunc> & subscriptions,
+      ScAddr const & element);
+
+  static InferenceConfig WithoutOwnThreadPool(InferenceConfig inferenceFlowConfig);
+
+  mutable std::mutex mutex;
+  bool isRunning = false;
+  std::unique_ptr<ScMemoryContext> context;
+  std::shared_ptr<FormulaMetadataCache> formulaMetadataCache;
+  std::shared_ptr<ThreadPool> threadPool;
+  ScAddrUnorderedSet watchedFormulasSets;
+  ScAddrUnorderedSet watchedSets;
+  std::unordered_map<ScAddr, Subscriptions, ScAddrHashFunc> setsSubscriptions;
+  std::unordered_map<ScAddr, Subscriptions, ScAddrHashFunc> formulasSubscriptions;
+  /// Subscriptions can't be destroyed by callbacks of events, so they are destroyed by the next watch or stop
+  Subscriptions releasedSubscriptions;
+};
+
+}  // namespace inference
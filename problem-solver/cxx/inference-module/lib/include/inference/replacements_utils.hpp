@@ -6,18 +6,53 @@
 
 #pragma once
 
+#include <memory>
+#include <memory_resource>
+
 #include <sc-memory/sc_addr.hpp>
 #include <sc-memory/sc_template.hpp>
 
 #include <inference/types.hpp>
 
-using ReplacementsHashes = std::unordered_map<size_t, std::vector<size_t>>;
+using ReplacementsHashes = std::pmr::unordered_map<size_t, std::pmr::vector<size_t>>;
 
 namespace inference
 {
 class ReplacementsUtils
 {
 public:
+  /**
+   * Pool for temporary containers of replacements operations on the current thread while scope exists. Scope is
+   * created for each inference run, so memory of hashes and column indices is reused by all operations of the run
+   */
+  class ScratchScope
+  {
+  public:
+    ScratchScope();
+
+    ~ScratchScope();
+
+    ScratchScope(ScratchScope const & other) = delete;
+
+    ScratchScope & operator=(ScratchScope const & other) = delete;
+
+  private:
+    std::unique_ptr<std::pmr::unsynchronized_pool_resource> pool;
+    std::pmr::memory_resource * previousResource;
+  };
+
+  /// Combine hash of value into seed, result depends on order of combined values
+  static size_t CombineHash(size_t seed, size_t value);
+
+  /// Hash of values of several variables in one column, values are combined in order
+  struct ColumnHashFunc
+  {
+    size_t operator()(ScAddrVector const & column) const;
+  };
+
+  /// Get pool of the innermost scratch scope of the current thread or default memory resource if there is no scope
+  static std::pmr::memory_resource * GetScratchResource();
+
   static void IntersectReplacements(
       Replacements const & first,
       Replacements const & second,
@@ -25,6 +60,10 @@ public:
   static void UniteReplacements(Replacements const & first, Replacements const & second, Replacements & unionResult);
   static void SubtractReplacements(Replacements const & first, Replacements const & second, Replacements & difference);
   static Replacements removeRows(Replacements const & replacements, ScAddrUnorderedSet & keysToRemove);
+  static void ProjectReplacements(
+      Replacements const & replacements,
+      ScAddrUnorderedSet const & keys,
+      Replacements & projection);
   static void GetReplacementsToScTemplateParams(
       Replacements const & replacements,
       std::vector<ScTemplateParams> & templateParams);
@@ -41,7 +80,20 @@ private:
   static void CalculateHashesForCommonKeys(
       Replacements const & replacements,
       ScAddrUnorderedSet const & commonKeys,
-      ReplacementsHashes & hashes);
+      ReplacementsHashes & hashes,
+      std::pmr::vector<size_t> & unboundColumns);
+  static void GetSortedColumns(
+      ScAddrVector const & row,
+      std::pmr::vector<std::pair<size_t, size_t>> & columns,
+      std::pmr::vector<size_t> & unboundColumns);
+  static bool HasUnboundValues(Replacements const & replacements, size_t columnIndex, ScAddrUnorderedSet const & keys);
+  static bool AreColumnsCompatible(
+      Replacements const & first,
+      size_t columnIndexInFirst,
+      Replacements const & second,
+      size_t columnIndexInSecond,
+      ScAddrUnorderedSet const & commonKeys);
+  static bool CompareValues(std::pair<size_t, size_t> const & first, std::pair<size_t, size_t> const & second);
 };
 
 }  // namespace inference
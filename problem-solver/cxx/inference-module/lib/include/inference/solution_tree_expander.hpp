@@ -0,0 +1,37 @@
+/*
+ * This source file is part of an OSTIS project. For the latest info, see http://ostis.net
+ * Distributed under the MIT License
+ * (See accompanying file COPYING.MIT or copy at http://opensource.org/licenses/MIT)
+ */
+
+#pragma once
+
+#include <sc-memory/sc_memory.hpp>
+
+#include "inference/types.hpp"
+
+namespace inference
+{
+/// Expands solution generated with `TREE_COMPACT` to the solution tree generated with `TREE_FULL`
+class SolutionTreeExpander
+{
+public:
+  explicit SolutionTreeExpander(ScMemoryContext * context);
+
+  /**
+   * @brief Replace every compact node of solution with nodes of full solution tree, one node per formula application.
+   * Order of solution nodes is kept
+   * @param solution is a solution generated by inference
+   * @returns true if solution had compact nodes and all of them were expanded
+   */
+  bool Expand(ScAddr const & solution);
+
+  bool IsCompactSolutionNode(ScAddr const & solutionNode) const;
+
+private:
+  ScAddrVector GetSolutionNodes(ScAddr const & solution) const;
+
+  ScMemoryContext * context;
+};
+
+}  // namespace inference
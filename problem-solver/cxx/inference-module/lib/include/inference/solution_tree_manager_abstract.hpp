@@ -30,6 +30,12 @@ public:
 
   ScAddr GenerateSolution(ScAddr const & outputStructure, bool targetAchieved);
 
+  /// Partial solution is generated when inference is stopped before all formulas are applied
+  void SetSolutionPartial(bool isPartial);
+
+  /// Set structure with executed operators tree of inference to connect with solution, empty address resets it
+  void SetSolutionTrace(ScAddr const & trace);
+
   bool CheckIfSolutionNodeExists(
       ScAddr const & formula,
       ScTemplateParams const & templateParams,
@@ -38,6 +44,8 @@ public:
 protected:
   std::unique_ptr<SolutionTreeGenerator> solutionTreeGenerator;
   std::unique_ptr<SolutionTreeSearcher> solutionTreeSearcher;
+  bool isSolutionPartial = false;
+  ScAddr solutionTrace;
 };
 
 }  // namespace inference
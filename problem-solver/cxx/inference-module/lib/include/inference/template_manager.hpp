@@ -20,5 +20,8 @@ public:
   explicit TemplateManager(ScMemoryContext * ms_context);
 
   std::vector<ScTemplateParams> CreateTemplateParams(ScAddr const & scTemplate) override;
+
+private:
+  ScAddrVector const & GetArgumentsOfClass(ScAddr const & argumentsClass);
 };
 }  // namespace inference
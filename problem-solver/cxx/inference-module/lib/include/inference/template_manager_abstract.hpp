@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include <sc-memory/sc_memory.hpp>
@@ -14,6 +16,8 @@
 
 namespace inference
 {
+class FormulaMetadataCache;
+
 /// Class to create template params to search and generate atomic logical formulas.
 /// Control generation with flow with `generateOnlyFirst` and `generateOnlyUnique` flags
 class TemplateManagerAbstract
@@ -36,6 +40,11 @@ public:
     fixedArguments.push_back(fixedArgument);
   }
 
+  void SetFixedArguments(ScAddrVector const & otherFixedArguments)
+  {
+    fixedArguments = otherFixedArguments;
+  }
+
   ReplacementsUsingType GetReplacementsUsingType() const
   {
     return replacementsUsingType;
@@ -64,6 +73,20 @@ public:
   void SetArguments(ScAddrVector const & otherArguments)
   {
     arguments = otherArguments;
+    argumentsByClass.clear();
+  }
+
+  /// Set cache to get classes of formula variables from, classes are searched in formula if cache is not set
+  void SetFormulaMetadataCache(std::shared_ptr<FormulaMetadataCache> otherFormulaMetadataCache)
+  {
+    formulaMetadataCache = std::move(otherFormulaMetadataCache);
+  }
+
+  /// Forget arguments of classes, that may get new elements, because generated formula contains them
+  void InvalidateArgumentsOfClasses(ScAddrUnorderedSet const & classes)
+  {
+    for (ScAddr const & argumentsClass : classes)
+      argumentsByClass.erase(argumentsClass);
   }
 
   void SetGenerationType(GenerationType otherGenType)
@@ -84,5 +107,8 @@ protected:
   OutputStructureFillingType fillingType;
   GenerationType generationType;
   ScAddrVector fixedArguments;
+  std::shared_ptr<FormulaMetadataCache> formulaMetadataCache;
+  /// Arguments that belong to classes, memberships of every class are checked once until it is invalidated
+  std::unordered_map<ScAddr, ScAddrVector, ScAddrHashFunc> argumentsByClass;
 };
 }  // namespace inference
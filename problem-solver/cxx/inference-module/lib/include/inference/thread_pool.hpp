@@ -0,0 +1,86 @@
+/*
+ * This source file is part of an OSTIS project. For the latest info, see http://ostis.net
+ * Distributed under the MIT License
+ * (See accompanying file COPYING.MIT or copy at http://opensource.org/licenses/MIT)
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include <sc-memory/sc_memory.hpp>
+
+namespace inference
+{
+/// Fixed amount of workers that execute submitted tasks, used to compute independent parts of formulas concurrently
+class ThreadPool
+{
+public:
+  explicit ThreadPool(size_t workersAmount = std::thread::hardware_concurrency());
+
+  ~ThreadPool();
+
+  ThreadPool(ThreadPool const & other) = delete;
+
+  ThreadPool & operator=(ThreadPool const & other) = delete;
+
+  size_t GetWorkersAmount() const;
+
+  /**
+   * @brief Get sc-memory context of pool worker running the current thread, it is generated once and kept until pool
+   * is destroyed, so that tasks don't generate their own contexts
+   * @returns nullptr if the current thread is not a worker of this pool, like thread that runs tasks while it waits
+   */
+  ScMemoryContext * GetWorkerContext();
+
+  template <typename TTask>
+  std::future<std::invoke_result_t<TTask>> Submit(TTask && task)
+  {
+    using TResult = std::invoke_result_t<TTask>;
+    auto packagedTask = std::make_shared<std::packaged_task<TResult()>>(std::forward<TTask>(task));
+    std::future<TResult> future = packagedTask->get_future();
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      tasks.emplace([packagedTask]() {
+        (*packagedTask)();
+      });
+    }
+    condition.notify_one();
+    return future;
+  }
+
+  /// Wait for result of submitted task, queued tasks are executed by waiting thread meanwhile to avoid deadlocks when
+  /// task is waited from another task of this pool
+  template <typename TResult>
+  TResult Await(std::future<TResult> & future)
+  {
+    while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    {
+      if (!RunPendingTask())
+        future.wait_for(std::chrono::milliseconds(1));
+    }
+    return future.get();
+  }
+
+private:
+  bool RunPendingTask();
+
+  void Run(size_t workerIndex);
+
+  std::mutex mutex;
+  std::condition_variable condition;
+  std::queue<std::function<void()>> tasks;
+  std::vector<std::thread> workers;
+  /// Every context is generated and used only by worker with its index
+  std::vector<std::unique_ptr<ScMemoryContext>> workersContexts;
+  bool isStopped = false;
+};
+
+}  // namespace inference
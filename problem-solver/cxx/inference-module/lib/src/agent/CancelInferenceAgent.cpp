@@ -0,0 +1,53 @@
+/*
+ * This source file is part of an OSTIS project. For the latest info, see http://ostis.net
+ * Distributed under the MIT License
+ * (See accompanying file COPYING.MIT or copy at http://opensource.org/licenses/MIT)
+ */
+
+#include "inference/cancel_inference_agent.hpp"
+
+#include "inference/inference_cancellation.hpp"
+#include "inference/inference_keynodes.hpp"
+
+namespace inference
+{
+
+ScResult CancelInferenceAgent::DoProgram(ScActionInitiatedEvent const & event, ScAction & action)
+{
+  ScAddr const & inferenceAction = action.GetArgument(1);
+  if (!m_context.IsElement(inferenceAction))
+  {
+    m_logger.Error("Action to cancel is not valid.");
+    return action.FinishWithError();
+  }
+
+  InferenceCancellationRegistry & cancellationRegistry = InferenceCancellationRegistry::GetInstance();
+  if (cancellationRegistry.Cancel(inferenceAction))
+    return action.FinishSuccessfully();
+
+  if (!IsInitiatedAndNotFinished(inferenceAction))
+  {
+    m_logger.Warning("Action to cancel is not running.");
+    return action.FinishUnsuccessfully();
+  }
+  // Inference action is initiated, but its agent hasn't registered it yet
+  cancellationRegistry.CancelOnRegistration(inferenceAction);
+  if (m_context.CheckConnector(ScKeynodes::action_finished, inferenceAction, ScType::ConstPermPosArc))
+    cancellationRegistry.Unregister(inferenceAction);
+  m_logger.Debug("Action to cancel is not started, it is cancelled on start.");
+  return action.FinishSuccessfully();
+}
+
+ScAddr CancelInferenceAgent::GetActionClass() const
+{
+  return InferenceKeynodes::action_cancel_inference;
+}
+
+bool CancelInferenceAgent::IsInitiatedAndNotFinished(ScAddr const & inferenceAction) const
+{
+  return m_context.CheckConnector(InferenceKeynodes::action_direct_inference, inferenceAction, ScType::ConstPermPosArc) &&
+         m_context.CheckConnector(ScKeynodes::action_initiated, inferenceAction, ScType::ConstPermPosArc) &&
+         !m_context.CheckConnector(ScKeynodes::action_finished, inferenceAction, ScType::ConstPermPosArc);
+}
+
+}  // namespace inference
@@ -7,36 +7,41 @@
 #include "inference/direct_inference_agent.hpp"
 
 #include "inference/inference_manager_abstract.hpp"
-#include "inference/inference_manager_factory.hpp"
+#include "inference/inference_service.hpp"
+#include "inference/inference_cancellation.hpp"
 #include "inference/inference_keynodes.hpp"
 
 #include <sc-agents-common/utils/IteratorUtils.hpp>
 
+#include <string>
+
 namespace inference
 {
-
-DirectInferenceAgent::DirectInferenceAgent()
+ScResult DirectInferenceAgent::DoProgram(ScActionInitiatedEvent const & event, ScAction & action)
 {
-  m_logger = utils::ScLogger(
+  // Actions are performed concurrently, so every action has its own logger that appends lines prefixed with action
+  // hash to one log file. Managers and expression nodes write into it too, so all lines of action are attributed
+  utils::ScLogger logger(
       utils::ScLogger::ScLogType::File, "logs/DirectInferenceAgent.log", utils::ScLogLevel::Debug, true);
-}
+  logger.SetPrefix("Action " + std::to_string(action.Hash()) + ": ");
+  // Action can be cancelled by `CancelInferenceAgent` while inference is applied, action is registered from the start
+  // so that its pending cancellation is removed on any exit
+  InferenceCancellationRegistry::Registration const cancellationRegistration(action);
 
-ScResult DirectInferenceAgent::DoProgram(ScActionInitiatedEvent const & event, ScAction & action)
-{
   auto const [targetStructure, formulasSet, arguments, inputStructure] = action.GetArguments<4>();
 
   if (!IsSetValidAndNotEmpty(targetStructure))
   {
-    m_logger.Warning("Target structure is not valid or empty.");
+    logger.Warning("Target structure is not valid or empty.");
   }
   if (!IsSetValidAndNotEmpty(formulasSet))
   {
-    m_logger.Error("Formulas set is not valid or empty.");
+    logger.Error("Formulas set is not valid or empty.");
     return action.FinishUnsuccessfully();
   }
   if (!arguments.IsValid())
   {
-    m_logger.Error("Arguments are not valid.");
+    logger.Error("Arguments are not valid.");
     return action.FinishUnsuccessfully();
   }
 
@@ -54,21 +59,32 @@ ScResult DirectInferenceAgent::DoProgram(ScActionInitiatedEvent const & event, S
   ScAddr const & outputStructure = m_context.GenerateNode(ScType::ConstNodeStructure);
   InferenceParams const & inferenceParams{
       formulasSet, argumentVector, inputStructures, outputStructure, targetStructure};
+  // Service shares formulas caches between actions, without started service manager owns them
   std::unique_ptr<InferenceManagerAbstract> inferenceManager =
-      InferenceManagerFactory::ConstructDirectInferenceManagerTarget(&m_context, &m_logger, inferenceConfig);
+      InferenceService::GetInstance().ConstructDirectInferenceManagerTarget(
+          &m_context, &logger, inferenceConfig, formulasSet);
+  std::shared_ptr<CancellationToken> const & cancellationToken = cancellationRegistration.GetToken();
+  inferenceManager->SetCancellationToken(cancellationToken);
   bool targetAchieved;
+  logger.Debug("Apply inference");
   try
   {
     targetAchieved = inferenceManager->ApplyInference(inferenceParams);
   }
   catch (utils::ScException const & exception)
   {
-    m_logger.Error(exception.Message());
+    logger.Error(exception.Message());
     return action.FinishUnsuccessfully();
   }
+  logger.Debug("Inference is applied, target is ", targetAchieved ? "achieved" : "not achieved");
   ScAddr solutionNode = inferenceManager->GetSolutionTreeManager()->GenerateSolution(outputStructure, targetAchieved);
 
   action.FormResult(solutionNode);
+  if (cancellationToken->IsCancelled() && inferenceManager->IsBudgetExhausted())
+  {
+    logger.Warning("Inference is cancelled, solution is partial.");
+    return action.FinishUnsuccessfully();
+  }
   return action.FinishSuccessfully();
 }
 
@@ -8,9 +8,27 @@
 
 #include <sc-agents-common/utils/CommonUtils.hpp>
 
+#include <sc-memory-profiler/sc_memory_profiler.hpp>
+
+using utils::ScMemoryCallType;
+using utils::ScMemoryProfiler;
+
 namespace inference
 {
-int FormulaClassifier::typeOfFormula(ScMemoryContext * ms_context, utils::ScLogger * logger, ScAddr const & formula)
+namespace
+{
+bool IsFormulaOfClass(ScMemoryContext * ms_context, ScAddr const & formulaClass, ScAddr const & formula)
+{
+  ScMemoryProfiler::Scope const profilerScope(ScMemoryCallType::CHECK_CONNECTOR);
+  return ms_context->CheckConnector(formulaClass, formula, ScType::ConstPermPosArc);
+}
+}  // namespace
+
+int FormulaClassifier::typeOfFormula(
+    ScMemoryContext * ms_context,
+    utils::ScLogger * logger,
+    ScAddr const & formula,
+    FormulaMetadataCache * metadataCache)
 {
   if (!formula.IsValid())
   {
@@ -19,20 +37,19 @@ int FormulaClassifier::typeOfFormula(ScMemoryContext * ms_context, utils::ScLogg
   }
 
   // TODO(MksmOrlov): implement the agent of logical formulas verification, check types and number of operands
-  bool isAtomicFormula =
-      ms_context->CheckConnector(InferenceKeynodes::atomic_logical_formula, formula, ScType::ConstPermPosArc);
+  bool isAtomicFormula = IsFormulaOfClass(ms_context, InferenceKeynodes::atomic_logical_formula, formula);
   if (!isAtomicFormula)
   {
-    if (ms_context->GetElementType(formula) == ScType::ConstNodeStructure && isFormulaWithVar(ms_context, formula))
+    if (ms_context->GetElementType(formula) == ScType::ConstNodeStructure)
     {
-      isAtomicFormula = true;
+      isAtomicFormula = metadataCache ? metadataCache->Get(ms_context, formula)->hasVariables
+                                      : isFormulaWithVar(ms_context, formula);
     }
   }
   if (isAtomicFormula)
     return ATOMIC;
 
-  bool const isImplication =
-      ms_context->CheckConnector(InferenceKeynodes::nrel_implication, formula, ScType::ConstPermPosArc);
+  bool const isImplication = IsFormulaOfClass(ms_context, InferenceKeynodes::nrel_implication, formula);
   if (isImplication)
   {
     if (ms_context->GetElementType(formula) == ScType::ConstCommonArc)
@@ -42,23 +59,19 @@ int FormulaClassifier::typeOfFormula(ScMemoryContext * ms_context, utils::ScLogg
     return NONE;
   }
 
-  bool const isNegation =
-      ms_context->CheckConnector(InferenceKeynodes::nrel_negation, formula, ScType::ConstPermPosArc);
+  bool const isNegation = IsFormulaOfClass(ms_context, InferenceKeynodes::nrel_negation, formula);
   if (isNegation)
     return NEGATION;
 
-  bool const isConjunction =
-      ms_context->CheckConnector(InferenceKeynodes::nrel_conjunction, formula, ScType::ConstPermPosArc);
+  bool const isConjunction = IsFormulaOfClass(ms_context, InferenceKeynodes::nrel_conjunction, formula);
   if (isConjunction)
     return CONJUNCTION;
 
-  bool const isDisjunction =
-      ms_context->CheckConnector(InferenceKeynodes::nrel_disjunction, formula, ScType::ConstPermPosArc);
+  bool const isDisjunction = IsFormulaOfClass(ms_context, InferenceKeynodes::nrel_disjunction, formula);
   if (isDisjunction)
     return DISJUNCTION;
 
-  bool const isEquivalence =
-      ms_context->CheckConnector(InferenceKeynodes::nrel_equivalence, formula, ScType::ConstPermPosArc);
+  bool const isEquivalence = IsFormulaOfClass(ms_context, InferenceKeynodes::nrel_equivalence, formula);
   if (isEquivalence)
   {
     if (ms_context->GetElementType(formula) == ScType::ConstCommonEdge)
@@ -70,18 +83,9 @@ int FormulaClassifier::typeOfFormula(ScMemoryContext * ms_context, utils::ScLogg
   return NONE;
 }
 
-bool FormulaClassifier::isFormulaWithConst(ScMemoryContext * ms_context, ScAddr const & formula)
-{
-  ScIterator3Ptr constNodesIterator = ms_context->CreateIterator3(formula, ScType::ConstPermPosArc, ScType::ConstNode);
-  if (constNodesIterator->Next())
-    return true;
-  ScIterator3Ptr constLinksIterator =
-      ms_context->CreateIterator3(formula, ScType::ConstPermPosArc, ScType::ConstNodeLink);
-  return constLinksIterator->Next();
-}
-
 bool FormulaClassifier::isFormulaWithVar(ScMemoryContext * ms_context, ScAddr const & formula)
 {
+  ScMemoryProfiler::Scope const profilerScope(ScMemoryCallType::CREATE_ITERATOR);
   ScIterator3Ptr varNodesIterator = ms_context->CreateIterator3(formula, ScType::ConstPermPosArc, ScType::VarNode);
   if (varNodesIterator->Next())
     return true;
@@ -89,10 +93,4 @@ bool FormulaClassifier::isFormulaWithVar(ScMemoryContext * ms_context, ScAddr co
   return varLinksIterator->Next();
 }
 
-bool FormulaClassifier::isFormulaToGenerate(ScMemoryContext * ms_context, ScAddr const & formula)
-{
-  return ms_context->CheckConnector(
-      InferenceKeynodes::concept_template_for_generation, formula, ScType::ConstPermPosArc);
-}
-
 }  // namespace inference
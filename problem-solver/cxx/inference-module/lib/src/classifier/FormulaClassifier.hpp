@@ -8,6 +8,8 @@
 
 #include "inference/inference_keynodes.hpp"
 
+#include "FormulaMetadataCache.hpp"
+
 namespace inference
 {
 class FormulaClassifier
@@ -26,10 +28,17 @@ public:
     EQUIVALENCE_TUPLE = 8
   };
 
-  static int typeOfFormula(ScMemoryContext * ms_context, utils::ScLogger * logger, ScAddr const & formula);
-  static bool isFormulaWithConst(ScMemoryContext * ms_context, ScAddr const & formula);
+  /**
+   * @brief Get class of formula
+   * @param metadataCache is used to check variables of structures, classification with cache should be done by
+   * `FormulaMetadataCache::GetFormulaClass` to classify every formula once
+   */
+  static int typeOfFormula(
+      ScMemoryContext * ms_context,
+      utils::ScLogger * logger,
+      ScAddr const & formula,
+      FormulaMetadataCache * metadataCache = nullptr);
   static bool isFormulaWithVar(ScMemoryContext * ms_context, ScAddr const & formula);
-  static bool isFormulaToGenerate(ScMemoryContext * ms_context, ScAddr const & formula);
 };
 
 }  // namespace inference
@@ -0,0 +1,305 @@
+/*
+ * This source file is part of an OSTIS project. For the latest info, see http://ostis.net
+ * Distributed under the MIT License
+ * (See accompanying file COPYING.MIT or copy at http://opensource.org/licenses/MIT)
+ */
+
+#include "FormulaMetadataCache.hpp"
+
+#include <algorithm>
+
+#include <sc-memory-profiler/sc_memory_profiler.hpp>
+
+#include "inference/inference_keynodes.hpp"
+#include "inference/replacements_utils.hpp"
+
+#include "FormulaClassifier.hpp"
+
+using utils::ScMemoryCallType;
+using utils::ScMemoryProfiler;
+
+namespace
+{
+size_t HashType(ScType const & type)
+{
+  return std::hash<ScType::RealType>()(type);
+}
+
+/// Tags of elements written to canonical form of formula
+enum CanonicalFormTag : size_t
+{
+  CANONICAL_FORMULA = 0,
+  CANONICAL_CONSTANT = 1,
+  CANONICAL_VARIABLE = 2
+};
+}  // namespace
+
+namespace inference
+{
+size_t FormulaMetadata::GetVariableIndex(ScAddr const & variable) const
+{
+  auto const & variableIterator = std::lower_bound(
+      variables.cbegin(),
+      variables.cend(),
+      variable,
+      [](ScAddr const & first, ScAddr const & second)
+      {
+        return first.Hash() < second.Hash();
+      });
+  if (variableIterator == variables.cend() || *variableIterator != variable)
+    SC_THROW_EXCEPTION(utils::ExceptionItemNotFound, "Variable " << variable.Hash() << " is not in the formula");
+  return variableIterator - variables.cbegin();
+}
+
+std::shared_ptr<FormulaMetadata const> FormulaMetadataCache::Get(ScMemoryContext * context, ScAddr const & formula)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto const & metadataIterator = formulasMetadata.find(formula);
+    if (metadataIterator != formulasMetadata.cend())
+      return metadataIterator->second;
+  }
+  // Metadata is computed without lock, if other thread computed it first then its metadata is kept
+  std::shared_ptr<FormulaMetadata const> metadata = Compute(context, formula);
+  ComputeCallback callback;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto const & [metadataIterator, isAdded] = formulasMetadata.emplace(formula, std::move(metadata));
+    metadata = metadataIterator->second;
+    if (isAdded)
+      callback = computeCallback;
+  }
+  // Callback is called without lock, so it can use the cache
+  if (callback)
+    callback(formula);
+  return metadata;
+}
+
+int FormulaMetadataCache::GetFormulaClass(ScMemoryContext * context, utils::ScLogger * logger, ScAddr const & formula)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto const & classIterator = formulasClasses.find(formula);
+    if (classIterator != formulasClasses.cend())
+      return classIterator->second;
+  }
+  int const formulaClass = FormulaClassifier::typeOfFormula(context, logger, formula, this);
+  if (!formula.IsValid())
+    return formulaClass;
+  std::lock_guard<std::mutex> lock(mutex);
+  return formulasClasses.emplace(formula, formulaClass).first->second;
+}
+
+void FormulaMetadataCache::Invalidate(ScAddr const & formula)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  formulasMetadata.erase(formula);
+  formulasClasses.erase(formula);
+}
+
+void FormulaMetadataCache::Clear()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  formulasMetadata.clear();
+  formulasClasses.clear();
+}
+
+size_t FormulaMetadataCache::Size() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return formulasMetadata.size();
+}
+
+void FormulaMetadataCache::SetComputeCallback(ComputeCallback callback)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  computeCallback = std::move(callback);
+}
+
+std::shared_ptr<FormulaMetadata const> FormulaMetadataCache::Compute(ScMemoryContext * context, ScAddr const & formula)
+{
+  auto metadata = std::make_shared<FormulaMetadata>();
+  std::unordered_map<ScAddr, ScType, ScAddrHashFunc> elementsTypes;
+  std::vector<size_t> elementHashes;
+  {
+    ScMemoryProfiler::Scope const profilerScope(ScMemoryCallType::CREATE_ITERATOR);
+    ScIterator3Ptr const & elementsIterator =
+        context->CreateIterator3(formula, ScType::ConstPermPosArc, ScType::Unknown);
+    while (elementsIterator->Next())
+    {
+      ScAddr const & element = elementsIterator->Get(2);
+      ScType const & elementType = context->GetElementType(element);
+      elementsTypes.emplace(element, elementType);
+      elementHashes.push_back(ReplacementsUtils::CombineHash(element.Hash(), HashType(elementType)));
+
+      if (elementType.IsVar())
+      {
+        metadata->variablesSet.insert(element);
+        metadata->hasVariables |= elementType.IsNode() || elementType.IsLink();
+      }
+      else if (elementType.IsConst())
+      {
+        metadata->constants.insert(element);
+        metadata->hasConstants |= elementType.IsNode() || elementType.IsLink();
+      }
+      if (elementType.IsLink())
+      {
+        metadata->links.push_back(element);
+        std::string content;
+        if (context->GetLinkContent(element, content))
+          metadata->linksContent.emplace(element, content);
+      }
+    }
+  }
+
+  metadata->variables.assign(metadata->variablesSet.cbegin(), metadata->variablesSet.cend());
+  std::sort(
+      metadata->variables.begin(),
+      metadata->variables.end(),
+      [](ScAddr const & first, ScAddr const & second)
+      {
+        return first.Hash() < second.Hash();
+      });
+
+  std::sort(elementHashes.begin(), elementHashes.end());
+  for (size_t const elementHash : elementHashes)
+    metadata->fingerprint = ReplacementsUtils::CombineHash(metadata->fingerprint, elementHash);
+  ComputeCanonicalForm(context, formula, elementsTypes, *metadata);
+  metadata->variablesClasses = GetVariablesClasses(context, formula);
+
+  ScMemoryProfiler::Scope const profilerScope(ScMemoryCallType::CHECK_CONNECTOR);
+  metadata->isToGenerate =
+      context->CheckConnector(InferenceKeynodes::concept_template_for_generation, formula, ScType::ConstPermPosArc);
+  metadata->isTemplateWithLinks =
+      context->CheckConnector(InferenceKeynodes::concept_template_with_links, formula, ScType::ConstPermPosArc);
+  return metadata;
+}
+
+std::vector<std::pair<ScAddr, ScAddrVector>> FormulaMetadataCache::GetVariablesClasses(
+    ScMemoryContext * context,
+    ScAddr const & formula)
+{
+  ScMemoryProfiler::Scope const profilerScope(ScMemoryCallType::CREATE_ITERATOR);
+  std::vector<std::pair<ScAddr, ScAddrVector>> variablesClasses;
+  ScIterator3Ptr const & variablesIterator =
+      context->CreateIterator3(formula, ScType::ConstPermPosArc, ScType::VarNode);
+  while (variablesIterator->Next())
+  {
+    ScAddr const & variable = variablesIterator->Get(2);
+    ScAddrVector & classes = variablesClasses.emplace_back(variable, ScAddrVector()).second;
+    ScIterator5Ptr const & classesIterator = context->CreateIterator5(
+        ScType::ConstNode, ScType::VarPermPosArc, variable, ScType::ConstPermPosArc, formula);
+    while (classesIterator->Next())
+      classes.push_back(classesIterator->Get(0));
+  }
+  return variablesClasses;
+}
+
+/**
+ * @brief Order formula variables by structure of connectors they are incident to. Every connector is described by its
+ * type and its source and target, that are described by address if they are constants and by type if they are
+ * variables. If descriptions of all connectors are different, then variables are numbered in order of sorted connectors
+ * and formulas with the same descriptions and numbering are equal up to variables. Sorted connectors with numbered
+ * variables and sorted constants are written to canonical form, so that equality of formulas can be checked exactly
+ */
+void FormulaMetadataCache::ComputeCanonicalForm(
+    ScMemoryContext * context,
+    ScAddr const & formula,
+    std::unordered_map<ScAddr, ScType, ScAddrHashFunc> const & elementsTypes,
+    FormulaMetadata & metadata)
+{
+  metadata.canonicalVariables = metadata.variables;
+  metadata.canonicalFingerprint = ReplacementsUtils::CombineHash(metadata.fingerprint, metadata.fingerprint);
+  metadata.canonicalForm = {CANONICAL_FORMULA, formula.Hash()};
+
+  auto const & getType = [&context, &elementsTypes](ScAddr const & element) -> ScType
+  {
+    auto const & typeIterator = elementsTypes.find(element);
+    return typeIterator == elementsTypes.cend() ? context->GetElementType(element) : typeIterator->second;
+  };
+  auto const & describe = [&getType](ScAddr const & element) -> size_t
+  {
+    ScType const & type = getType(element);
+    return type.IsVar() ? ReplacementsUtils::CombineHash(1, HashType(type))
+                        : ReplacementsUtils::CombineHash(2, element.Hash());
+  };
+
+  struct ConnectorDescription
+  {
+    size_t description;
+    ScAddr connector;
+    ScAddr source;
+    ScAddr target;
+  };
+  std::vector<ConnectorDescription> connectors;
+  for (auto const & [element, type] : elementsTypes)
+  {
+    if (!type.IsConnector())
+      continue;
+    auto const & [source, target] = context->GetConnectorIncidentElements(element);
+    size_t description = ReplacementsUtils::CombineHash(HashType(type), describe(source));
+    description = ReplacementsUtils::CombineHash(description, describe(target));
+    connectors.push_back({description, element, source, target});
+  }
+  std::sort(
+      connectors.begin(),
+      connectors.end(),
+      [](ConnectorDescription const & first, ConnectorDescription const & second)
+      {
+        return first.description < second.description;
+      });
+  for (size_t i = 1; i < connectors.size(); ++i)
+  {
+    if (connectors[i - 1].description == connectors[i].description)
+      return;
+  }
+
+  std::unordered_map<ScAddr, size_t, ScAddrHashFunc> canonicalIndices;
+  ScAddrVector canonicalVariables;
+  std::vector<size_t> canonicalForm;
+  canonicalForm.reserve(connectors.size() * 9 + metadata.constants.size() * 2);
+  auto const & numerate = [&](ScAddr const & element) -> size_t
+  {
+    if (!metadata.variablesSet.count(element))
+    {
+      canonicalForm.insert(canonicalForm.end(), {CANONICAL_CONSTANT, element.Hash()});
+      return ReplacementsUtils::CombineHash(2, element.Hash());
+    }
+    auto const & [indexIterator, isNew] = canonicalIndices.emplace(element, canonicalVariables.size());
+    if (isNew)
+      canonicalVariables.push_back(element);
+    canonicalForm.insert(
+        canonicalForm.end(),
+        {CANONICAL_VARIABLE, static_cast<size_t>(ScType::RealType(getType(element))), indexIterator->second});
+    return ReplacementsUtils::CombineHash(1, indexIterator->second);
+  };
+  size_t canonicalFingerprint = 0;
+  for (ConnectorDescription const & connector : connectors)
+  {
+    canonicalFingerprint = ReplacementsUtils::CombineHash(canonicalFingerprint, connector.description);
+    canonicalFingerprint = ReplacementsUtils::CombineHash(canonicalFingerprint, numerate(connector.connector));
+    canonicalFingerprint = ReplacementsUtils::CombineHash(canonicalFingerprint, numerate(connector.source));
+    canonicalFingerprint = ReplacementsUtils::CombineHash(canonicalFingerprint, numerate(connector.target));
+  }
+  // Variables that are not incident to any connector can't be ordered
+  if (canonicalVariables.size() != metadata.variables.size())
+    return;
+
+  // Constants that are not incident to connectors are not written by connectors
+  ScAddrVector constants(metadata.constants.cbegin(), metadata.constants.cend());
+  std::sort(
+      constants.begin(),
+      constants.end(),
+      [](ScAddr const & first, ScAddr const & second)
+      {
+        return first.Hash() < second.Hash();
+      });
+  for (ScAddr const & constant : constants)
+    canonicalForm.insert(canonicalForm.end(), {CANONICAL_CONSTANT, constant.Hash()});
+
+  metadata.canonicalVariables = std::move(canonicalVariables);
+  metadata.canonicalFingerprint = canonicalFingerprint;
+  metadata.canonicalForm = std::move(canonicalForm);
+}
+
+}  // namespace inference
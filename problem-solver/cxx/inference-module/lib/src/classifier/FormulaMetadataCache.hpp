@@ -0,0 +1,97 @@
+/*
+ * This source file is part of an OSTIS project. For the latest info, see http://ostis.net
+ * Distributed under the MIT License
+ * (See accompanying file COPYING.MIT or copy at http://opensource.org/licenses/MIT)
+ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <sc-memory/sc_memory.hpp>
+
+namespace inference
+{
+/// Structural properties of atomic logical formula that don't change during inference
+struct FormulaMetadata
+{
+  /// Formula variables ordered by hash, index of variable in this vector is stable for the formula
+  ScAddrVector variables;
+  ScAddrUnorderedSet variablesSet;
+  ScAddrUnorderedSet constants;
+  /// Links of the formula and contents of links that have content
+  ScAddrVector links;
+  std::unordered_map<ScAddr, std::string, ScAddrHashFunc> linksContent;
+  bool hasConstants = false;
+  bool hasVariables = false;
+  bool isToGenerate = false;
+  bool isTemplateWithLinks = false;
+  /// Hash of formula elements and their types, equal for formulas with the same elements
+  size_t fingerprint = 0;
+  /**
+   * Hash of formula structure that doesn't depend on variables, equal for formulas that differ only by variables.
+   * Variables of such formulas correspond to each other by index in `canonicalVariables`. If formula variables can't be
+   * ordered unambiguously then this hash is unique for the formula and `canonicalVariables` are `variables`
+   */
+  size_t canonicalFingerprint = 0;
+  ScAddrVector canonicalVariables;
+  /**
+   * Structure which hash is `canonicalFingerprint`: connectors in canonical order with their sources and targets and
+   * sorted constants. Constants are written by address, variables by type and index in `canonicalVariables`. If
+   * variables can't be ordered then it contains only address of formula
+   */
+  std::vector<size_t> canonicalForm;
+  /// Variable nodes of the formula with constant classes they belong to in the formula
+  std::vector<std::pair<ScAddr, ScAddrVector>> variablesClasses;
+
+  size_t GetVariableIndex(ScAddr const & variable) const;
+};
+
+/**
+ * Thread safe store of formulas metadata and classes, metadata of every atomic logical formula and class of every
+ * formula are computed once on first request
+ */
+class FormulaMetadataCache
+{
+public:
+  using ComputeCallback = std::function<void(ScAddr const & formula)>;
+
+  std::shared_ptr<FormulaMetadata const> Get(ScMemoryContext * context, ScAddr const & formula);
+
+  /// Get class of formula computed by `FormulaClassifier`
+  int GetFormulaClass(ScMemoryContext * context, utils::ScLogger * logger, ScAddr const & formula);
+
+  void Invalidate(ScAddr const & formula);
+
+  void Clear();
+
+  size_t Size() const;
+
+  /// Set callback that is called with every formula which metadata is computed and added to cache
+  void SetComputeCallback(ComputeCallback callback);
+
+  /// Find variable nodes of formula and constant classes they belong to in the formula
+  static std::vector<std::pair<ScAddr, ScAddrVector>> GetVariablesClasses(
+      ScMemoryContext * context,
+      ScAddr const & formula);
+
+private:
+  mutable std::mutex mutex;
+  std::unordered_map<ScAddr, std::shared_ptr<FormulaMetadata const>, ScAddrHashFunc> formulasMetadata;
+  std::unordered_map<ScAddr, int, ScAddrHashFunc> formulasClasses;
+  ComputeCallback computeCallback;
+
+  static std::shared_ptr<FormulaMetadata const> Compute(ScMemoryContext * context, ScAddr const & formula);
+  static void ComputeCanonicalForm(
+      ScMemoryContext * context,
+      ScAddr const & formula,
+      std::unordered_map<ScAddr, ScType, ScAddrHashFunc> const & elementsTypes,
+      FormulaMetadata & metadata);
+};
+
+}  // namespace inference
@@ -6,14 +6,18 @@
 
 #include "inference/inference_manager_factory.hpp"
 
+#include "inference/thread_pool.hpp"
+
 #include "searcher/template-searcher/TemplateSearcherOnlyMembershipArcsInStructures.hpp"
 #include "searcher/template-searcher/TemplateSearcherInStructures.hpp"
 #include "searcher/template-searcher/TemplateSearcherGeneral.hpp"
 #include "manager/template-manager/TemplateManagerFixedArguments.hpp"
 #include "manager/solution-tree-manager/SolutionTreeManagerEmpty.hpp"
 #include "manager/solution-tree-manager/SolutionTreeManager.hpp"
+#include "manager/solution-tree-manager/SolutionTreeManagerCompact.hpp"
 #include "manager/inference-manager/DirectInferenceManagerAll.hpp"
 #include "manager/inference-manager/DirectInferenceManagerTarget.hpp"
+#include "logic/AtomSearchResultsMemo.hpp"
 
 using namespace inference;
 
@@ -32,6 +36,10 @@ std::unique_ptr<InferenceManagerAbstract> InferenceManagerFactory::ConstructDire
   {
     solutionTreeManager = std::make_unique<SolutionTreeManagerEmpty>(context);
   }
+  else if (inferenceFlowConfig.solutionTreeType == TREE_COMPACT)
+  {
+    solutionTreeManager = std::make_unique<SolutionTreeManagerCompact>(context);
+  }
   strategyAll->SetSolutionTreeManager(solutionTreeManager);
 
   std::shared_ptr<TemplateManagerAbstract> templateManager = std::make_shared<TemplateManagerFixedArguments>(context);
@@ -59,6 +67,16 @@ std::unique_ptr<InferenceManagerAbstract> InferenceManagerFactory::ConstructDire
       inferenceFlowConfig.atomicLogicalFormulaSearchBeforeGenerationType);
   strategyAll->SetTemplateSearcher(templateSearcher);
 
+  if (inferenceFlowConfig.disjunctionComputationType == COMPUTE_IN_PARALLEL)
+    strategyAll->SetThreadPool(std::make_shared<ThreadPool>());
+
+  // Search results of prefetched premises are passed to formulas application through memo
+  if (inferenceFlowConfig.searchResultsMemoizationType == MEMOIZE_SEARCH_RESULTS ||
+      inferenceFlowConfig.formulasApplicationType == APPLY_PIPELINED)
+    strategyAll->SetSearchResultsMemo(std::make_shared<AtomSearchResultsMemo>());
+  strategyAll->SetFormulasApplicationType(inferenceFlowConfig.formulasApplicationType);
+  strategyAll->SetIterationType(inferenceFlowConfig.iterationType);
+
   return strategyAll;
 }
 
@@ -79,6 +97,10 @@ std::unique_ptr<InferenceManagerAbstract> InferenceManagerFactory::ConstructDire
   {
     solutionTreeManager = std::make_unique<SolutionTreeManagerEmpty>(context);
   }
+  else if (inferenceFlowConfig.solutionTreeType == TREE_COMPACT)
+  {
+    solutionTreeManager = std::make_unique<SolutionTreeManagerCompact>(context);
+  }
   strategyTarget->SetSolutionTreeManager(solutionTreeManager);
 
   std::shared_ptr<TemplateManagerAbstract> templateManager = std::make_shared<TemplateManager>(context);
@@ -105,6 +127,13 @@ std::unique_ptr<InferenceManagerAbstract> InferenceManagerFactory::ConstructDire
   templateSearcher->setAtomicLogicalFormulaSearchBeforeGenerationType(
       inferenceFlowConfig.atomicLogicalFormulaSearchBeforeGenerationType);
   strategyTarget->SetTemplateSearcher(templateSearcher);
+  templateManager->SetFormulaMetadataCache(templateSearcher->getFormulaMetadataCache());
+
+  if (inferenceFlowConfig.disjunctionComputationType == COMPUTE_IN_PARALLEL)
+    strategyTarget->SetThreadPool(std::make_shared<ThreadPool>());
+
+  if (inferenceFlowConfig.searchResultsMemoizationType == MEMOIZE_SEARCH_RESULTS)
+    strategyTarget->SetSearchResultsMemo(std::make_shared<AtomSearchResultsMemo>());
 
   return strategyTarget;
 }
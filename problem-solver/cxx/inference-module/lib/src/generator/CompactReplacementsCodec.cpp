@@ -0,0 +1,98 @@
+/*
+ * This source file is part of an OSTIS project. For the latest info, see http://ostis.net
+ * Distributed under the MIT License
+ * (See accompanying file COPYING.MIT or copy at http://opensource.org/licenses/MIT)
+ */
+
+#include "CompactReplacementsCodec.hpp"
+
+#include <cstring>
+
+#include "inference/replacements_utils.hpp"
+
+namespace inference
+{
+namespace
+{
+template <typename TValue>
+void Write(std::string & content, TValue const & value)
+{
+  content.append(reinterpret_cast<char const *>(&value), sizeof(TValue));
+}
+
+template <typename TValue>
+bool Read(std::string const & content, size_t & position, TValue & value)
+{
+  if (position + sizeof(TValue) > content.size())
+    return false;
+  std::memcpy(&value, content.data() + position, sizeof(TValue));
+  position += sizeof(TValue);
+  return true;
+}
+}  // namespace
+
+std::string CompactReplacementsCodec::Encode(Replacements const & replacements)
+{
+  uint32_t const variablesAmount = static_cast<uint32_t>(replacements.size());
+  uint64_t const rowsAmount = ReplacementsUtils::GetColumnsAmount(replacements);
+
+  std::string content;
+  content.reserve(
+      sizeof(uint32_t) * 2 + sizeof(uint64_t) + (variablesAmount + variablesAmount * rowsAmount) * sizeof(uint64_t));
+  Write(content, FORMAT_VERSION);
+  Write(content, variablesAmount);
+  Write(content, rowsAmount);
+
+  std::vector<ScAddrVector const *> columns;
+  columns.reserve(variablesAmount);
+  for (auto const & pair : replacements)
+  {
+    Write(content, static_cast<uint64_t>(pair.first.Hash()));
+    columns.push_back(&pair.second);
+  }
+  for (size_t rowIndex = 0; rowIndex < rowsAmount; ++rowIndex)
+  {
+    for (ScAddrVector const * column : columns)
+      Write(content, static_cast<uint64_t>(column->at(rowIndex).Hash()));
+  }
+  return content;
+}
+
+bool CompactReplacementsCodec::Decode(
+    std::string const & content,
+    ScAddrVector & variables,
+    std::vector<ScAddrVector> & rows)
+{
+  size_t position = 0;
+  uint32_t version = 0;
+  uint32_t variablesAmount = 0;
+  uint64_t rowsAmount = 0;
+  if (!Read(content, position, version) || version != FORMAT_VERSION || !Read(content, position, variablesAmount)
+      || !Read(content, position, rowsAmount))
+    return false;
+  if ((content.size() - position) / sizeof(uint64_t) != variablesAmount + variablesAmount * rowsAmount)
+    return false;
+
+  uint64_t hash = 0;
+  variables.reserve(variablesAmount);
+  for (uint32_t variableIndex = 0; variableIndex < variablesAmount; ++variableIndex)
+  {
+    Read(content, position, hash);
+    variables.emplace_back(static_cast<ScAddr::HashType>(hash));
+  }
+  rows.reserve(rowsAmount);
+  for (uint64_t rowIndex = 0; rowIndex < rowsAmount; ++rowIndex)
+  {
+    ScAddrVector row;
+    row.reserve(variablesAmount);
+    for (uint32_t variableIndex = 0; variableIndex < variablesAmount; ++variableIndex)
+    {
+      Read(content, position, hash);
+      row.emplace_back(static_cast<ScAddr::HashType>(hash));
+    }
+    rows.push_back(std::move(row));
+  }
+  return true;
+}
+
+}  // namespace inference
@@ -0,0 +1,41 @@
+/*
+ * This source file is part of an OSTIS project. For the latest info, see http://ostis.net
+ * Distributed under the MIT License
+ * (See accompanying file COPYING.MIT or copy at http://opensource.org/licenses/MIT)
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <sc-memory/sc_addr.hpp>
+
+#include "inference/types.hpp"
+
+namespace inference
+{
+/**
+ * Packs replacements of one formula application into a binary table that is stored as a single sc-link content.
+ * Layout: format version (uint32), variables amount (uint32), rows amount (uint64), variables hashes, then values
+ * hashes row by row. All numbers are written in the host byte order.
+ */
+class CompactReplacementsCodec
+{
+public:
+  static std::string Encode(Replacements const & replacements);
+
+  /**
+   * @brief Restore variables and rows of replacements packed with `Encode`
+   * @param content is a content of compact replacements link
+   * @param variables out param, variables in the order of table columns
+   * @param rows out param, values of variables for every formula application
+   * @returns false if content is not a valid packed table
+   */
+  static bool Decode(std::string const & content, ScAddrVector & variables, std::vector<ScAddrVector> & rows);
+
+private:
+  static uint32_t const FORMAT_VERSION = 1;
+};
+
+}  // namespace inference
@@ -0,0 +1,167 @@
+/*
+ * This source file is part of an OSTIS project. For the latest info, see http://ostis.net
+ * Distributed under the MIT License
+ * (See accompanying file COPYING.MIT or copy at http://opensource.org/licenses/MIT)
+ */
+
+#include "GenerationStaging.hpp"
+
+#include <sc-memory-profiler/sc_memory_profiler.hpp>
+
+#include <algorithm>
+#include <set>
+
+using utils::ScMemoryCallType;
+using utils::ScMemoryProfiler;
+
+namespace inference
+{
+void GenerationStagingBuffer::Stage(ScAddr const & formula, GenerationBindings bindings)
+{
+  stagedGenerations.emplace_back(formula, std::move(bindings));
+}
+
+size_t GenerationStagingBuffer::GetStagedAmount() const
+{
+  return stagedGenerations.size();
+}
+
+GenerationStaging::GenerationStaging(ScMemoryContext * context, size_t workersAmount)
+  : context(context)
+  , buffers(workersAmount)
+{
+}
+
+GenerationStagingBuffer & GenerationStaging::GetBuffer(size_t workerIndex)
+{
+  return buffers.at(workerIndex);
+}
+
+size_t GenerationStaging::Commit()
+{
+  std::lock_guard<std::mutex> lock(commitMutex);
+  committedElements.clear();
+
+  // Generation is identified by formula and values of variables sorted by variables
+  std::set<std::pair<ScAddr::HashType, std::vector<std::pair<ScAddr::HashType, ScAddr::HashType>>>> stagedKeys;
+  size_t generatedAmount = 0;
+  try
+  {
+    for (GenerationStagingBuffer & buffer : buffers)
+    {
+      for (auto & [formula, bindings] : buffer.stagedGenerations)
+      {
+        std::vector<std::pair<ScAddr::HashType, ScAddr::HashType>> bindingsKey;
+        bindingsKey.reserve(bindings.size());
+        for (auto const & [variable, value] : bindings)
+          bindingsKey.emplace_back(variable.Hash(), value.Hash());
+        std::sort(bindingsKey.begin(), bindingsKey.end());
+        if (!stagedKeys.emplace(formula.Hash(), std::move(bindingsKey)).second)
+          continue;
+
+        // Formula generated by previous staged generation can be found too
+        ScTemplateParams params;
+        for (auto const & [variable, value] : bindings)
+          params.Add(variable, value);
+        if (isFormulaGenerated(formula, params))
+          continue;
+        generateFormula(formula, bindings);
+        ++generatedAmount;
+      }
+    }
+  }
+  catch (...)
+  {
+    eraseCommittedElements();
+    Rollback();
+    throw;
+  }
+  Rollback();
+  return generatedAmount;
+}
+
+void GenerationStaging::Rollback()
+{
+  for (GenerationStagingBuffer & buffer : buffers)
+    buffer.stagedGenerations.clear();
+}
+
+ScAddrVector const & GenerationStaging::GetCommittedElements() const
+{
+  return committedElements;
+}
+
+bool GenerationStaging::isFormulaGenerated(ScAddr const & formula, ScTemplateParams const & params) const
+{
+  ScTemplate searchTemplate;
+  {
+    ScMemoryProfiler::Scope const profilerScope(ScMemoryCallType::BUILD_TEMPLATE);
+    context->BuildTemplate(searchTemplate, formula, params);
+  }
+  bool isFound = false;
+  ScMemoryProfiler::Scope const profilerScope(ScMemoryCallType::SEARCH_BY_TEMPLATE);
+  context->SearchByTemplateInterruptibly(
+      searchTemplate, [&isFound](ScTemplateSearchResultItem const &) -> ScTemplateSearchRequest {
+        isFound = true;
+        return ScTemplateSearchRequest::STOP;
+      });
+  return isFound;
+}
+
+void GenerationStaging::generateFormula(ScAddr const & formula, GenerationBindings const & bindings)
+{
+  ScTemplate generationTemplate;
+  ScTemplateParams params;
+  for (auto const & [variable, value] : bindings)
+    params.Add(variable, value);
+  {
+    ScMemoryProfiler::Scope const profilerScope(ScMemoryCallType::BUILD_TEMPLATE);
+    context->BuildTemplate(generationTemplate, formula, params);
+  }
+  ScTemplateGenResult generationResult;
+  try
+  {
+    ScMemoryProfiler::Scope const profilerScope(ScMemoryCallType::GENERATE_BY_TEMPLATE);
+    context->GenerateByTemplate(generationTemplate, generationResult);
+  }
+  catch (...)
+  {
+    // Elements generated before generation failed are erased by rollback of commit too
+    recordGeneratedElements(formula, bindings, generationResult);
+    throw;
+  }
+  recordGeneratedElements(formula, bindings, generationResult);
+}
+
+void GenerationStaging::recordGeneratedElements(
+    ScAddr const & formula,
+    GenerationBindings const & bindings,
+    ScTemplateGenResult const & generationResult)
+{
+  // Only elements of variables that are not bound are created by generation
+  ScIterator3Ptr const & elementsIterator = context->CreateIterator3(formula, ScType::ConstPermPosArc, ScType::Unknown);
+  while (elementsIterator->Next())
+  {
+    ScAddr const & element = elementsIterator->Get(2);
+    bool const isBound = std::any_of(bindings.cbegin(), bindings.cend(), [&element](auto const & binding) {
+      return binding.first == element;
+    });
+    ScAddr generatedElement;
+    if (!isBound && context->GetElementType(element).IsVar() && generationResult.Get(element, generatedElement)
+        && generatedElement.IsValid())
+      committedElements.push_back(generatedElement);
+  }
+}
+
+void GenerationStaging::eraseCommittedElements()
+{
+  // Erased element erases its connectors, so some generated elements can be already erased
+  for (auto element = committedElements.crbegin(); element != committedElements.crend(); ++element)
+  {
+    if (context->IsElement(*element))
+      context->EraseElement(*element);
+  }
+  committedElements.clear();
+}
+
+}  // namespace inference
@@ -0,0 +1,78 @@
+/*
+ * This source file is part of an OSTIS project. For the latest info, see http://ostis.net
+ * Distributed under the MIT License
+ * (See accompanying file COPYING.MIT or copy at http://opensource.org/licenses/MIT)
+ */
+
+#pragma once
+
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <sc-memory/sc_memory.hpp>
+
+#include "inference/types.hpp"
+
+namespace inference
+{
+/// Values of formula variables to generate formula with
+using GenerationBindings = std::vector<std::pair<ScAddr, ScAddr>>;
+
+/// Generations staged by one worker. Buffer is used by one thread, so it has no synchronization
+class GenerationStagingBuffer
+{
+public:
+  void Stage(ScAddr const & formula, GenerationBindings bindings);
+
+  size_t GetStagedAmount() const;
+
+private:
+  friend class GenerationStaging;
+
+  std::vector<std::pair<ScAddr, GenerationBindings>> stagedGenerations;
+};
+
+/**
+ * Buffers generations of atomic logical formulas made by parallel workers instead of writing them into sc-memory.
+ * On commit staged generations of all workers are deduplicated, every generation is checked against knowledge base
+ * and only formulas that don't exist are generated. If any generation fails, all constructions generated by the commit
+ * are erased, so commit is applied completely or not applied at all
+ */
+class GenerationStaging
+{
+public:
+  GenerationStaging(ScMemoryContext * context, size_t workersAmount);
+
+  /// Get buffer of the worker, every worker must use only its own buffer
+  GenerationStagingBuffer & GetBuffer(size_t workerIndex);
+
+  /**
+   * @brief Generate staged formulas of all workers in the order of workers and clear buffers. Must be called when
+   * workers don't stage generations, commits are serialized
+   * @returns amount of generated formulas
+   */
+  size_t Commit();
+
+  /// Drop staged generations of all workers, must be called when workers don't stage generations
+  void Rollback();
+
+  /// Get elements generated by the last commit, elements bound by generation bindings are not included
+  ScAddrVector const & GetCommittedElements() const;
+
+private:
+  ScMemoryContext * context;
+  std::vector<GenerationStagingBuffer> buffers;
+  ScAddrVector committedElements;
+  std::mutex commitMutex;
+
+  bool isFormulaGenerated(ScAddr const & formula, ScTemplateParams const & params) const;
+  void generateFormula(ScAddr const & formula, GenerationBindings const & bindings);
+  void recordGeneratedElements(
+      ScAddr const & formula,
+      GenerationBindings const & bindings,
+      ScTemplateGenResult const & generationResult);
+  void eraseCommittedElements();
+};
+
+}  // namespace inference
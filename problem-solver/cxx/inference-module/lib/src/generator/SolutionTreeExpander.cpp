@@ -0,0 +1,103 @@
+/*
+ * This source file is part of an OSTIS project. For the latest info, see http://ostis.net
+ * Distributed under the MIT License
+ * (See accompanying file COPYING.MIT or copy at http://opensource.org/licenses/MIT)
+ */
+
+#include "inference/solution_tree_expander.hpp"
+
+#include <sc-agents-common/utils/IteratorUtils.hpp>
+
+#include "inference/inference_keynodes.hpp"
+
+#include "CompactReplacementsCodec.hpp"
+#include "SolutionTreeGenerator.hpp"
+
+using namespace inference;
+
+SolutionTreeExpander::SolutionTreeExpander(ScMemoryContext * context)
+  : context(context)
+{
+}
+
+bool SolutionTreeExpander::Expand(ScAddr const & solution)
+{
+  ScAddrVector const & solutionNodes = GetSolutionNodes(solution);
+  bool hasCompactNodes = false;
+  for (ScAddr const & solutionNode : solutionNodes)
+    hasCompactNodes |= IsCompactSolutionNode(solutionNode);
+  if (!hasCompactNodes)
+    return false;
+
+  // Sequence is regenerated from scratch, arcs from solution carry both rrel_1 and nrel_basic_sequence connectors
+  for (ScAddr const & solutionNode : solutionNodes)
+  {
+    ScIterator3Ptr const & solutionNodeArcIterator =
+        context->CreateIterator3(solution, ScType::ConstPermPosArc, solutionNode);
+    while (solutionNodeArcIterator->Next())
+      context->EraseElement(solutionNodeArcIterator->Get(1));
+  }
+
+  bool result = true;
+  SolutionTreeGenerator solutionTreeGenerator(context, solution);
+  for (ScAddr const & solutionNode : solutionNodes)
+  {
+    if (!IsCompactSolutionNode(solutionNode))
+    {
+      result &= solutionTreeGenerator.AddSolutionNode(solutionNode);
+      continue;
+    }
+
+    ScAddr const & formula = utils::IteratorUtils::getAnyByOutRelation(context, solutionNode, ScKeynodes::rrel_1);
+    ScAddr const & replacementsLink =
+        utils::IteratorUtils::getAnyByOutRelation(context, solutionNode, ScKeynodes::rrel_2);
+    std::string content;
+    context->GetLinkContent(replacementsLink, content);
+    ScAddrVector variables;
+    std::vector<ScAddrVector> rows;
+    if (!CompactReplacementsCodec::Decode(content, variables, rows))
+      SC_THROW_EXCEPTION(
+          utils::ExceptionInvalidState,
+          "SolutionTreeExpander: solution node " << solutionNode.Hash() << " has corrupted compact replacements");
+
+    for (ScAddrVector const & row : rows)
+    {
+      ScTemplateParams templateParams;
+      ScAddrUnorderedSet boundVariables;
+      for (size_t variableIndex = 0; variableIndex < variables.size(); ++variableIndex)
+      {
+        if (row[variableIndex].IsValid())
+        {
+          templateParams.Add(variables[variableIndex], row[variableIndex]);
+          boundVariables.insert(variables[variableIndex]);
+        }
+      }
+      result &= solutionTreeGenerator.AddNode(formula, templateParams, boundVariables);
+    }
+
+    context->EraseElement(replacementsLink);
+    context->EraseElement(solutionNode);
+  }
+
+  return result;
+}
+
+bool SolutionTreeExpander::IsCompactSolutionNode(ScAddr const & solutionNode) const
+{
+  ScAddr const & replacements = utils::IteratorUtils::getAnyByOutRelation(context, solutionNode, ScKeynodes::rrel_2);
+  return replacements.IsValid()
+         && context->CheckConnector(
+             InferenceKeynodes::concept_compact_replacements, replacements, ScType::ConstPermPosArc);
+}
+
+ScAddrVector SolutionTreeExpander::GetSolutionNodes(ScAddr const & solution) const
+{
+  ScAddrVector solutionNodes;
+  ScAddr solutionNode = utils::IteratorUtils::getAnyByOutRelation(context, solution, ScKeynodes::rrel_1);
+  while (solutionNode.IsValid())
+  {
+    solutionNodes.push_back(solutionNode);
+    solutionNode = utils::IteratorUtils::getNextFromSet(context, solution, solutionNode);
+  }
+  return solutionNodes;
+}
@@ -6,9 +6,9 @@
 
 #include "SolutionTreeGenerator.hpp"
 
-#include "inference/inference_keynodes.hpp"
+#include "CompactReplacementsCodec.hpp"
 
-#include <sc-agents-common/utils/GenerationUtils.hpp>
+#include "inference/inference_keynodes.hpp"
 
 #include <sc-memory/sc_addr.hpp>
 
@@ -16,9 +16,17 @@ using namespace inference;
 using namespace utils;
 SolutionTreeGenerator::SolutionTreeGenerator(ScMemoryContext * ms_context)
   : ms_context(ms_context)
+  , profiledContext(ms_context)
+{
+  solution = profiledContext.GenerateNode(ScType::ConstNode);
+  profiledContext.GenerateConnector(ScType::ConstPermPosArc, InferenceKeynodes::concept_solution, solution);
+}
+
+SolutionTreeGenerator::SolutionTreeGenerator(ScMemoryContext * ms_context, ScAddr const & solution)
+  : ms_context(ms_context)
+  , profiledContext(ms_context)
+  , solution(solution)
 {
-  solution = ms_context->GenerateNode(ScType::ConstNode);
-  ms_context->GenerateConnector(ScType::ConstPermPosArc, InferenceKeynodes::concept_solution, solution);
 }
 
 bool SolutionTreeGenerator::AddNode(
@@ -26,24 +34,36 @@ bool SolutionTreeGenerator::AddNode(
     ScTemplateParams const & templateParams,
     ScAddrUnorderedSet const & variables)
 {
-  ScAddr newSolutionNode = GenerateSolutionNode(formula, templateParams, variables);
+  return AddSolutionNode(GenerateSolutionNode(formula, templateParams, variables));
+}
+
+bool SolutionTreeGenerator::AddCompactNode(ScAddr const & formula, Replacements const & replacements)
+{
+  return AddSolutionNode(GenerateCompactSolutionNode(formula, replacements));
+}
+
+bool SolutionTreeGenerator::AddSolutionNode(ScAddr const & newSolutionNode)
+{
   bool result = newSolutionNode.IsValid();
   if (result)
   {
     if (!lastSolutionNode.IsValid())
     {
-      result = GenerationUtils::generateRelationBetween(ms_context, solution, newSolutionNode, ScKeynodes::rrel_1);
+      ScAddr const & newSolutionNodeArc = profiledContext.GenerateRelationBetween(
+          ScType::ConstPermPosArc, solution, newSolutionNode, ScKeynodes::rrel_1);
+      result = newSolutionNodeArc.IsValid();
     }
     else
     {
       ScIterator3Ptr lastSolutionNodeArcIterator =
-          ms_context->CreateIterator3(solution, ScType::ConstPermPosArc, lastSolutionNode);
+          profiledContext.CreateIterator3(solution, ScType::ConstPermPosArc, lastSolutionNode);
       if (lastSolutionNodeArcIterator->Next())
       {
         ScAddr lastSolutionNodeArc = lastSolutionNodeArcIterator->Get(1);
-        ScAddr newSolutionNodeArc = ms_context->GenerateConnector(ScType::ConstPermPosArc, solution, newSolutionNode);
-        GenerationUtils::generateRelationBetween(
-            ms_context, lastSolutionNodeArc, newSolutionNodeArc, ScKeynodes::nrel_basic_sequence);
+        ScAddr newSolutionNodeArc =
+            profiledContext.GenerateConnector(ScType::ConstPermPosArc, solution, newSolutionNode);
+        profiledContext.GenerateRelationBetween(
+            ScType::ConstCommonArc, lastSolutionNodeArc, newSolutionNodeArc, ScKeynodes::nrel_basic_sequence);
       }
       else
       {
@@ -61,21 +81,21 @@ ScAddr SolutionTreeGenerator::GenerateSolutionNode(
     ScTemplateParams const & templateParams,
     ScAddrUnorderedSet const & variables)
 {
-  ScAddr const & solutionNode = ms_context->GenerateNode(ScType::ConstNode);
-  GenerationUtils::generateRelationBetween(ms_context, solutionNode, formula, ScKeynodes::rrel_1);
-  ScAddr const & replacementsNode = ms_context->GenerateNode(ScType::ConstNode);
-  GenerationUtils::generateRelationBetween(ms_context, solutionNode, replacementsNode, ScKeynodes::rrel_2);
+  ScAddr const & solutionNode = profiledContext.GenerateNode(ScType::ConstNode);
+  profiledContext.GenerateRelationBetween(ScType::ConstPermPosArc, solutionNode, formula, ScKeynodes::rrel_1);
+  ScAddr const & replacementsNode = profiledContext.GenerateNode(ScType::ConstNode);
+  profiledContext.GenerateRelationBetween(ScType::ConstPermPosArc, solutionNode, replacementsNode, ScKeynodes::rrel_2);
   for (ScAddr const & variable : variables)
   {
     ScAddr replacement;
     templateParams.Get(variable, replacement);
     if (replacement.IsValid())
     {
-      ScAddr const & pair = ms_context->GenerateNode(ScType::ConstNode);
-      ms_context->GenerateConnector(ScType::ConstPermPosArc, replacementsNode, pair);
-      GenerationUtils::generateRelationBetween(ms_context, pair, replacement, ScKeynodes::rrel_1);
-      GenerationUtils::generateRelationBetween(ms_context, pair, variable, ScKeynodes::rrel_2);
-      ms_context->GenerateConnector(ScType::ConstTempPosArc, variable, replacement);
+      ScAddr const & pair = profiledContext.GenerateNode(ScType::ConstNode);
+      profiledContext.GenerateConnector(ScType::ConstPermPosArc, replacementsNode, pair);
+      profiledContext.GenerateRelationBetween(ScType::ConstPermPosArc, pair, replacement, ScKeynodes::rrel_1);
+      profiledContext.GenerateRelationBetween(ScType::ConstPermPosArc, pair, variable, ScKeynodes::rrel_2);
+      profiledContext.GenerateConnector(ScType::ConstTempPosArc, variable, replacement);
     }
     else
       SC_THROW_EXCEPTION(
@@ -88,12 +108,34 @@ ScAddr SolutionTreeGenerator::GenerateSolutionNode(
   return solutionNode;
 }
 
-ScAddr SolutionTreeGenerator::GenerateSolution(ScAddr const & outputStructure, bool targetAchieved)
+ScAddr SolutionTreeGenerator::GenerateCompactSolutionNode(ScAddr const & formula, Replacements const & replacements)
+{
+  ScAddr const & solutionNode = profiledContext.GenerateNode(ScType::ConstNode);
+  profiledContext.GenerateRelationBetween(ScType::ConstPermPosArc, solutionNode, formula, ScKeynodes::rrel_1);
+  ScAddr const & replacementsLink = profiledContext.GenerateLink(ScType::ConstNodeLink);
+  ms_context->SetLinkContent(replacementsLink, CompactReplacementsCodec::Encode(replacements), false);
+  profiledContext.GenerateConnector(
+      ScType::ConstPermPosArc, InferenceKeynodes::concept_compact_replacements, replacementsLink);
+  profiledContext.GenerateRelationBetween(ScType::ConstPermPosArc, solutionNode, replacementsLink, ScKeynodes::rrel_2);
+
+  return solutionNode;
+}
+
+ScAddr SolutionTreeGenerator::GenerateSolution(
+    ScAddr const & outputStructure,
+    bool targetAchieved,
+    bool isPartial,
+    ScAddr const & trace)
 {
   ScType arcType = targetAchieved ? ScType::ConstPermPosArc : ScType::ConstPermNegArc;
-  ms_context->GenerateConnector(arcType, InferenceKeynodes::concept_success_solution, solution);
-  GenerationUtils::generateRelationBetween(
-      ms_context, solution, outputStructure, InferenceKeynodes::nrel_output_structure);
+  profiledContext.GenerateConnector(arcType, InferenceKeynodes::concept_success_solution, solution);
+  if (isPartial)
+    profiledContext.GenerateConnector(ScType::ConstPermPosArc, InferenceKeynodes::concept_partial_solution, solution);
+  profiledContext.GenerateRelationBetween(
+      ScType::ConstCommonArc, solution, outputStructure, InferenceKeynodes::nrel_output_structure);
+  if (trace.IsValid())
+    profiledContext.GenerateRelationBetween(
+        ScType::ConstCommonArc, solution, trace, InferenceKeynodes::nrel_inference_trace);
 
   return solution;
 }
@@ -10,6 +10,8 @@
 
 #include <sc-memory/sc_agent.hpp>
 
+#include <sc-memory-profiler/sc_memory_profiled_context.hpp>
+
 #include <vector>
 #include <queue>
 
@@ -20,11 +22,24 @@ class SolutionTreeGenerator
 public:
   explicit SolutionTreeGenerator(ScMemoryContext * ms_context);
 
+  /// Continue sequence of nodes of already generated solution
+  SolutionTreeGenerator(ScMemoryContext * ms_context, ScAddr const & solution);
+
   ~SolutionTreeGenerator() = default;
 
   bool AddNode(ScAddr const & formula, ScTemplateParams const & templateParams, ScAddrUnorderedSet const & variables);
 
-  ScAddr GenerateSolution(ScAddr const & outputStructure, bool targetAchieved);
+  /// Add node with replacements of all formula applications packed into single link
+  bool AddCompactNode(ScAddr const & formula, Replacements const & replacements);
+
+  /// Append already generated solution node to the end of solution nodes sequence
+  bool AddSolutionNode(ScAddr const & solutionNode);
+
+  ScAddr GenerateSolution(
+      ScAddr const & outputStructure,
+      bool targetAchieved,
+      bool isPartial = false,
+      ScAddr const & trace = ScAddr::Empty);
 
 private:
   ScAddr GenerateSolutionNode(
@@ -32,7 +47,11 @@ private:
       ScTemplateParams const & templateParams,
       ScAddrUnorderedSet const & variables);
 
+  ScAddr GenerateCompactSolutionNode(ScAddr const & formula, Replacements const & replacements);
+
   ScMemoryContext * ms_context;
+  /// Every sc-memory call of solution generation is measured separately
+  utils::ScMemoryProfiledContext profiledContext;
   ScAddr solution;
   ScAddr lastSolutionNode;
 };
@@ -0,0 +1,85 @@
+/*
+ * This source file is part of an OSTIS project. For the latest info, see http://ostis.net
+ * Distributed under the MIT License
+ * (See accompanying file COPYING.MIT or copy at http://opensource.org/licenses/MIT)
+ */
+
+#include "TemplateBatchGenerator.hpp"
+
+#include <sc-memory-profiler/sc_memory_profiler.hpp>
+
+using utils::ScMemoryCallType;
+using utils::ScMemoryProfiler;
+
+namespace inference
+{
+TemplateBatchGenerator::TemplateBatchGenerator(
+    ScMemoryContext * context,
+    ScAddr const & formula,
+    ScAddrUnorderedSet const & variables,
+    size_t expectedGenerationsAmount,
+    bool isElementsCollected)
+  : context(context)
+  , formula(formula)
+  , isElementsCollected(isElementsCollected)
+{
+  // Rows are created before generations, so pointers to them stay valid
+  rows.reserve(variables.size());
+  for (ScAddr const & variable : variables)
+  {
+    ScAddrVector & row = replacements[variable];
+    row.reserve(expectedGenerationsAmount);
+    rows.emplace_back(variable, &row);
+  }
+}
+
+void TemplateBatchGenerator::Generate(ScTemplateParams const & params)
+{
+  // Template is built at the first generation, all formulas of batch can already exist
+  if (generationsAmount == 0)
+  {
+    ScMemoryProfiler::Scope const profilerScope(ScMemoryCallType::BUILD_TEMPLATE);
+    context->BuildTemplate(generationTemplate, formula);
+  }
+  ScTemplateGenResult generationResult;
+  {
+    ScMemoryProfiler::Scope const profilerScope(ScMemoryCallType::GENERATE_BY_TEMPLATE);
+    context->GenerateByTemplate(generationTemplate, generationResult, params);
+  }
+  ++generationsAmount;
+  for (auto const & [variable, row] : rows)
+  {
+    ScAddr outAddr;
+    if (generationResult.Get(variable, outAddr) || params.Get(variable, outAddr))
+      row->push_back(outAddr);
+    else
+      SC_THROW_EXCEPTION(
+          utils::ExceptionInvalidState,
+          "Generation result and template params do not have replacement for " << variable.Hash());
+  }
+  if (isElementsCollected)
+  {
+    for (size_t i = 0; i < generationResult.Size(); ++i)
+      generatedElements.push_back(generationResult[i]);
+  }
+}
+
+size_t TemplateBatchGenerator::GetGenerationsAmount() const
+{
+  return generationsAmount;
+}
+
+void TemplateBatchGenerator::MoveGeneratedReplacements(Replacements & generatedReplacements)
+{
+  rows.clear();
+  if (generationsAmount == 0)
+    return;
+  generatedReplacements = std::move(replacements);
+}
+
+ScAddrVector const & TemplateBatchGenerator::GetGeneratedElements() const
+{
+  return generatedElements;
+}
+
+}  // namespace inference
@@ -0,0 +1,62 @@
+/*
+ * This source file is part of an OSTIS project. For the latest info, see http://ostis.net
+ * Distributed under the MIT License
+ * (See accompanying file COPYING.MIT or copy at http://opensource.org/licenses/MIT)
+ */
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include <sc-memory/sc_memory.hpp>
+#include <sc-memory/sc_template.hpp>
+
+#include "inference/types.hpp"
+
+namespace inference
+{
+/**
+ * Generates atomic logical formula for many template params. Template of the formula is built once and every
+ * generation only substitutes params. Replacements of variables are appended to rows prepared before generations, and
+ * generated elements are collected to be added to output structure at once
+ */
+class TemplateBatchGenerator
+{
+public:
+  /**
+   * @param formula is an atomic logical formula to generate
+   * @param variables are variables of the formula which replacements are collected
+   * @param expectedGenerationsAmount is used to reserve memory for replacements
+   * @param isElementsCollected is true if generated elements should be collected for output structure
+   */
+  TemplateBatchGenerator(
+      ScMemoryContext * context,
+      ScAddr const & formula,
+      ScAddrUnorderedSet const & variables,
+      size_t expectedGenerationsAmount,
+      bool isElementsCollected);
+
+  /// Generate formula with params, params must bind only variables of the formula
+  void Generate(ScTemplateParams const & params);
+
+  size_t GetGenerationsAmount() const;
+
+  /// Move replacements of variables in all generations, generator must not be used after that
+  void MoveGeneratedReplacements(Replacements & generatedReplacements);
+
+  /// Get elements of all generations in generation order, elements can repeat
+  ScAddrVector const & GetGeneratedElements() const;
+
+private:
+  ScMemoryContext * context;
+  ScAddr formula;
+  ScTemplate generationTemplate;
+  Replacements replacements;
+  std::vector<std::pair<ScAddr, ScAddrVector *>> rows;
+  ScAddrVector generatedElements;
+  bool isElementsCollected;
+  size_t generationsAmount = 0;
+};
+
+}  // namespace inference
@@ -0,0 +1,215 @@
+/*
+ * This source file is part of an OSTIS project. For the latest info, see http://ostis.net
+ * Distributed under the MIT License
+ * (See accompanying file COPYING.MIT or copy at http://opensource.org/licenses/MIT)
+ */
+
+#include "AtomSearchResultsMemo.hpp"
+
+#include <algorithm>
+
+namespace inference
+{
+AtomSearchResultsMemo::InFlightSearch::InFlightSearch(AtomSearchResultsMemo & memo)
+  : memo(memo)
+  , version(memo.StartSearch())
+{
+}
+
+AtomSearchResultsMemo::InFlightSearch::~InFlightSearch()
+{
+  memo.FinishSearch(version);
+}
+
+size_t AtomSearchResultsMemo::InFlightSearch::GetVersion() const
+{
+  return version;
+}
+
+bool AtomSearchResultsMemo::Find(
+    FormulaMetadata const & metadata,
+    std::vector<ScTemplateParams> const & templateParamsVector,
+    ScAddrUnorderedSet const & inputStructures,
+    Replacements & result)
+{
+  Key const & key = CreateKey(metadata, templateParamsVector, inputStructures);
+  std::lock_guard<std::mutex> lock(mutex);
+  auto const & entryIterator = entries.find(key);
+  if (entryIterator == entries.cend())
+    return false;
+
+  result.clear();
+  for (auto const & [variableIndex, values] : entryIterator->second.values)
+    result.emplace(metadata.canonicalVariables[variableIndex], values);
+  ++hitsAmount;
+  return true;
+}
+
+void AtomSearchResultsMemo::Add(
+    FormulaMetadata const & metadata,
+    std::vector<ScTemplateParams> const & templateParamsVector,
+    ScAddrUnorderedSet const & inputStructures,
+    Replacements const & result)
+{
+  Key key = CreateKey(metadata, templateParamsVector, inputStructures);
+  Entry entry = CreateEntry(metadata, result);
+  std::lock_guard<std::mutex> lock(mutex);
+  entries.insert_or_assign(std::move(key), std::move(entry));
+}
+
+bool AtomSearchResultsMemo::Add(
+    FormulaMetadata const & metadata,
+    std::vector<ScTemplateParams> const & templateParamsVector,
+    ScAddrUnorderedSet const & inputStructures,
+    Replacements const & result,
+    size_t searchVersion)
+{
+  Key key = CreateKey(metadata, templateParamsVector, inputStructures);
+  Entry entry = CreateEntry(metadata, result);
+  std::lock_guard<std::mutex> lock(mutex);
+  if (lastClearVersion > searchVersion)
+    return false;
+  for (auto const & [invalidationVersion, constants] : invalidations)
+  {
+    if (invalidationVersion > searchVersion && IsTouched(entry.constants, constants))
+      return false;
+  }
+  entries.insert_or_assign(std::move(key), std::move(entry));
+  return true;
+}
+
+void AtomSearchResultsMemo::InvalidateByConstants(ScAddrUnorderedSet const & constants)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  ++version;
+  // Invalidations are checked only by results of searches that are in flight
+  if (!inFlightSearchesVersions.empty())
+    invalidations.emplace_back(version, constants);
+  for (auto entryIterator = entries.begin(); entryIterator != entries.end();)
+  {
+    if (IsTouched(entryIterator->second.constants, constants))
+      entryIterator = entries.erase(entryIterator);
+    else
+      ++entryIterator;
+  }
+}
+
+size_t AtomSearchResultsMemo::GetVersion() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return version;
+}
+
+size_t AtomSearchResultsMemo::GetInvalidationsAmount() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return invalidations.size();
+}
+
+size_t AtomSearchResultsMemo::StartSearch()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  inFlightSearchesVersions.insert(version);
+  return version;
+}
+
+void AtomSearchResultsMemo::FinishSearch(size_t searchVersion)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  inFlightSearchesVersions.erase(inFlightSearchesVersions.find(searchVersion));
+  if (inFlightSearchesVersions.empty())
+  {
+    invalidations.clear();
+    return;
+  }
+  // Only invalidations made after the oldest in-flight search was started can reject its result
+  size_t const oldestSearchVersion = *inFlightSearchesVersions.cbegin();
+  invalidations.erase(
+      std::remove_if(
+          invalidations.begin(),
+          invalidations.end(),
+          [oldestSearchVersion](auto const & invalidation)
+          {
+            return invalidation.first <= oldestSearchVersion;
+          }),
+      invalidations.end());
+}
+
+void AtomSearchResultsMemo::Clear()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  entries.clear();
+  invalidations.clear();
+  lastClearVersion = ++version;
+}
+
+size_t AtomSearchResultsMemo::Size() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return entries.size();
+}
+
+size_t AtomSearchResultsMemo::GetHitsAmount() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return hitsAmount;
+}
+
+AtomSearchResultsMemo::Entry AtomSearchResultsMemo::CreateEntry(
+    FormulaMetadata const & metadata,
+    Replacements const & result)
+{
+  Entry entry;
+  entry.constants = metadata.constants;
+  for (size_t variableIndex = 0; variableIndex < metadata.canonicalVariables.size(); ++variableIndex)
+  {
+    auto const & valuesIterator = result.find(metadata.canonicalVariables[variableIndex]);
+    if (valuesIterator != result.cend())
+      entry.values.emplace_back(variableIndex, valuesIterator->second);
+  }
+  return entry;
+}
+
+/// Results of formulas without constants can be changed by any generation
+bool AtomSearchResultsMemo::IsTouched(ScAddrUnorderedSet const & entryConstants, ScAddrUnorderedSet const & constants)
+{
+  return entryConstants.empty() || std::any_of(
+                                       entryConstants.cbegin(),
+                                       entryConstants.cend(),
+                                       [&constants](ScAddr const & constant)
+                                       {
+                                         return constants.count(constant);
+                                       });
+}
+
+AtomSearchResultsMemo::Key AtomSearchResultsMemo::CreateKey(
+    FormulaMetadata const & metadata,
+    std::vector<ScTemplateParams> const & templateParamsVector,
+    ScAddrUnorderedSet const & inputStructures)
+{
+  Key key;
+  key.reserve(
+      4 + metadata.canonicalForm.size() + inputStructures.size()
+      + templateParamsVector.size() * metadata.canonicalVariables.size());
+  key.push_back(metadata.canonicalFingerprint);
+  // Fingerprints of different formulas may collide, so formulas are compared by their canonical form
+  key.push_back(metadata.canonicalForm.size());
+  key.insert(key.end(), metadata.canonicalForm.cbegin(), metadata.canonicalForm.cend());
+  key.push_back(inputStructures.size());
+
+  size_t const inputStructuresBegin = key.size();
+  for (ScAddr const & inputStructure : inputStructures)
+    key.push_back(inputStructure.Hash());
+  std::sort(key.begin() + inputStructuresBegin, key.end());
+
+  key.push_back(templateParamsVector.size());
+  ScAddr value;
+  for (ScTemplateParams const & templateParams : templateParamsVector)
+  {
+    for (ScAddr const & variable : metadata.canonicalVariables)
+      key.push_back(templateParams.Get(variable, value) ? value.Hash() : 0);
+  }
+  return key;
+}
+
+}  // namespace inference
@@ -0,0 +1,124 @@
+/*
+ * This source file is part of an OSTIS project. For the latest info, see http://ostis.net
+ * Distributed under the MIT License
+ * (See accompanying file COPYING.MIT or copy at http://opensource.org/licenses/MIT)
+ */
+
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <set>
+#include <vector>
+
+#include <sc-memory/sc_template.hpp>
+
+#include "inference/types.hpp"
+
+#include "classifier/FormulaMetadataCache.hpp"
+
+namespace inference
+{
+/**
+ * Search results of atomic logical formulas during one inference run. Results are keyed by canonical form of formula,
+ * bound template params and input structures, so formulas that differ only by variables share results.
+ * Results are invalidated when generation touches constants of formula. Results can be added by other threads
+ */
+class AtomSearchResultsMemo
+{
+public:
+  /**
+   * Search performed by other thread while memo is invalidated. Invalidations are recorded only while any search is
+   * in flight, invalidations that can't touch in-flight searches are removed when search is finished
+   */
+  class InFlightSearch
+  {
+  public:
+    explicit InFlightSearch(AtomSearchResultsMemo & memo);
+
+    ~InFlightSearch();
+
+    InFlightSearch(InFlightSearch const &) = delete;
+    InFlightSearch & operator=(InFlightSearch const &) = delete;
+
+    /// Get version of memo when search is started, it is passed to `Add`
+    size_t GetVersion() const;
+
+  private:
+    AtomSearchResultsMemo & memo;
+    size_t const version;
+  };
+
+  bool Find(
+      FormulaMetadata const & metadata,
+      std::vector<ScTemplateParams> const & templateParamsVector,
+      ScAddrUnorderedSet const & inputStructures,
+      Replacements & result);
+
+  void Add(
+      FormulaMetadata const & metadata,
+      std::vector<ScTemplateParams> const & templateParamsVector,
+      ScAddrUnorderedSet const & inputStructures,
+      Replacements const & result);
+
+  /**
+   * @brief Add result of search started when memo had the given version. Result is not added if it was invalidated
+   * while formula was searched
+   * @param searchVersion is a version of in-flight search
+   * @returns true if result is added
+   */
+  bool Add(
+      FormulaMetadata const & metadata,
+      std::vector<ScTemplateParams> const & templateParamsVector,
+      ScAddrUnorderedSet const & inputStructures,
+      Replacements const & result,
+      size_t searchVersion);
+
+  /// Remove results of formulas that contain any of constants or don't contain constants at all
+  void InvalidateByConstants(ScAddrUnorderedSet const & constants);
+
+  /// Get version of memo, version is changed by every invalidation
+  size_t GetVersion() const;
+
+  /// Get amount of invalidations kept to check results of in-flight searches
+  size_t GetInvalidationsAmount() const;
+
+  void Clear();
+
+  size_t Size() const;
+
+  size_t GetHitsAmount() const;
+
+private:
+  using Key = std::vector<size_t>;
+
+  struct Entry
+  {
+    std::vector<std::pair<size_t, ScAddrVector>> values;
+    ScAddrUnorderedSet constants;
+  };
+
+  std::map<Key, Entry> entries;
+  size_t hitsAmount = 0;
+  size_t version = 0;
+  size_t lastClearVersion = 0;
+  /// Constants of invalidations made while searches were in flight with versions set by them
+  std::vector<std::pair<size_t, ScAddrUnorderedSet>> invalidations;
+  std::multiset<size_t> inFlightSearchesVersions;
+  mutable std::mutex mutex;
+
+  size_t StartSearch();
+
+  void FinishSearch(size_t searchVersion);
+
+  static Entry CreateEntry(FormulaMetadata const & metadata, Replacements const & result);
+
+  static bool IsTouched(ScAddrUnorderedSet const & entryConstants, ScAddrUnorderedSet const & constants);
+
+  static Key CreateKey(
+      FormulaMetadata const & metadata,
+      std::vector<ScTemplateParams> const & templateParamsVector,
+      ScAddrUnorderedSet const & inputStructures);
+};
+
+}  // namespace inference
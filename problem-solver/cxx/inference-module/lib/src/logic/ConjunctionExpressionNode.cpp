@@ -6,37 +6,55 @@
 
 #include "ConjunctionExpressionNode.hpp"
 
-#include "classifier/FormulaClassifier.hpp"
+#include "NegationExpressionNode.hpp"
+
 
 ConjunctionExpressionNode::ConjunctionExpressionNode(
     ScMemoryContext * context,
     utils::ScLogger * logger,
-    OperatorLogicExpressionNode::OperandsVector & operands)
-  : context(context), logger(logger)
+    OperatorLogicExpressionNode::OperandsVector & operands,
+    std::shared_ptr<InferenceBudgetTracker> budgetTracker,
+    bool isNegated)
+  : context(context), logger(logger), budgetTracker(std::move(budgetTracker)), isNegated(isNegated)
 {
   for (auto & operand : operands)
     this->operands.emplace_back(std::move(operand));
 }
 
 void ConjunctionExpressionNode::compute(LogicFormulaResult & result) const
+{
+  ExplainTrace::Scope explainScope(explainTrace, "conjunction");
+  computeOperands(result);
+  explainScope.SetRowsAmount(ReplacementsUtils::GetColumnsAmount(result.replacements));
+}
+
+void ConjunctionExpressionNode::computeOperands(LogicFormulaResult & result) const
 {
   result.value = false;
   std::vector<TemplateExpressionNode *> formulasWithoutConstants;
   std::vector<TemplateExpressionNode *> formulasToGenerate;
+  std::vector<NegationExpressionNode *> negations;
 
   for (auto const & operand : operands)
   {
     operand->setArgumentVector(argumentVector);
+    auto negation = dynamic_cast<NegationExpressionNode *>(operand.get());
+    if (negation)
+    {
+      logger->Debug("Found negation in conjunction");
+      negations.push_back(negation);
+      continue;
+    }
     auto atom = dynamic_cast<TemplateExpressionNode *>(operand.get());
     if (atom)
     {
-      if (!FormulaClassifier::isFormulaWithConst(context, atom->getFormula()))
+      if (!atom->hasConstants())
       {
         logger->Debug("Found formula without constants in conjunction");
         formulasWithoutConstants.push_back(atom);
         continue;
       }
-      if (FormulaClassifier::isFormulaToGenerate(context, atom->getFormula()))
+      if (atom->isToGenerate())
       {
         logger->Debug("Found formula to generate in conjunction");
         formulasToGenerate.push_back(atom);
@@ -53,10 +71,10 @@ void ConjunctionExpressionNode::compute(LogicFormulaResult & result) const
       return;
     }
     if (!result.value)  // this is true only when processing the first operand
-      result = lastResult;
+      result = std::move(lastResult);
     else
     {
-      ReplacementsUtils::IntersectReplacements(result.replacements, lastResult.replacements, result.replacements);
+      intersect(result.replacements, lastResult.replacements);
       if (result.replacements.empty())
       {
         result.value = false;
@@ -76,7 +94,7 @@ void ConjunctionExpressionNode::compute(LogicFormulaResult & result) const
       result.replacements = {};
       return;
     }
-    ReplacementsUtils::IntersectReplacements(result.replacements, lastResult.replacements, result.replacements);
+    intersect(result.replacements, lastResult.replacements);
     if (result.replacements.empty())
     {
       result.value = false;
@@ -85,6 +103,33 @@ void ConjunctionExpressionNode::compute(LogicFormulaResult & result) const
       return;
     }
   }
+  // negations are processed as anti-joins when bindings are found, else they are computed as independent operands
+  for (auto const & negation : negations)
+  {
+    if (ReplacementsUtils::GetColumnsAmount(result.replacements) == 0)
+    {
+      LogicFormulaResult lastResult;
+      negation->compute(lastResult);
+      if (!lastResult.value)
+      {
+        result.value = false;
+        result.isGenerated = false;
+        result.replacements = {};
+        return;
+      }
+      if (!result.value)
+        result = std::move(lastResult);
+      continue;
+    }
+    negation->filter(result.replacements, result.replacements);
+    if (ReplacementsUtils::GetColumnsAmount(result.replacements) == 0)
+    {
+      result.value = false;
+      result.isGenerated = false;
+      result.replacements = {};
+      return;
+    }
+  }
   for (auto const & formulaToGenerate : formulasToGenerate)  // atoms which should be generated are processed here
   {
     LogicFormulaResult lastResult;
@@ -96,7 +141,7 @@ void ConjunctionExpressionNode::compute(LogicFormulaResult & result) const
       result.replacements = {};
       return;
     }
-    ReplacementsUtils::IntersectReplacements(result.replacements, lastResult.replacements, result.replacements);
+    intersect(result.replacements, lastResult.replacements);
     if (result.replacements.empty())
     {
       result.value = false;
@@ -121,7 +166,7 @@ void ConjunctionExpressionNode::generate(Replacements & replacements, LogicFormu
       return;
     }
     result.isGenerated |= lastResult.isGenerated;
-    ReplacementsUtils::IntersectReplacements(result.replacements, lastResult.replacements, result.replacements);
+    intersect(result.replacements, lastResult.replacements);
     if (ReplacementsUtils::GetColumnsAmount(result.replacements) == 0)
     {
       result = fail;
@@ -130,6 +175,16 @@ void ConjunctionExpressionNode::generate(Replacements & replacements, LogicFormu
   }
 }
 
+void ConjunctionExpressionNode::intersect(Replacements & replacements, Replacements const & otherReplacements) const
+{
+  ExplainTrace::Scope explainScope(explainTrace, "intersect");
+  explainScope.SetInputRowsAmount(ReplacementsUtils::GetColumnsAmount(replacements));
+  ReplacementsUtils::IntersectReplacements(replacements, otherReplacements, replacements);
+  explainScope.SetRowsAmount(ReplacementsUtils::GetColumnsAmount(replacements));
+  if (budgetTracker && !budgetTracker->LimitReplacements(replacements, isNegated))
+    logger->Debug("Conjunction replacements are limited by inference budget");
+}
+
 ScAddr ConjunctionExpressionNode::getFormula() const
 {
   return ScAddr::Empty;
@@ -13,7 +13,13 @@ using namespace inference;
 class ConjunctionExpressionNode : public OperatorLogicExpressionNode
 {
 public:
-  explicit ConjunctionExpressionNode(ScMemoryContext * context, utils::ScLogger * logger, OperandsVector & operands);
+  /// @param isNegated is true if the conjunction is under negation, joined replacements are not limited by budget then
+  explicit ConjunctionExpressionNode(
+      ScMemoryContext * context,
+      utils::ScLogger * logger,
+      OperandsVector & operands,
+      std::shared_ptr<InferenceBudgetTracker> budgetTracker = nullptr,
+      bool isNegated = false);
 
   void compute(LogicFormulaResult & result) const override;
 
@@ -24,4 +30,11 @@ public:
 private:
   ScMemoryContext * context;
   utils::ScLogger * logger;
+  std::shared_ptr<InferenceBudgetTracker> budgetTracker;
+  bool isNegated;
+
+  void computeOperands(LogicFormulaResult & result) const;
+
+  /// Join operands results and limit joined replacements by budget
+  void intersect(Replacements & replacements, Replacements const & otherReplacements) const;
 };
@@ -6,13 +6,16 @@
 
 #include "DisjunctionExpressionNode.hpp"
 
-#include "classifier/FormulaClassifier.hpp"
+#include <sc-memory-profiler/sc_memory_profiler.hpp>
+
+using utils::ScMemoryProfiler;
 
 DisjunctionExpressionNode::DisjunctionExpressionNode(
     ScMemoryContext * context,
     utils::ScLogger * logger,
-    OperatorLogicExpressionNode::OperandsVector & operands)
-  : context(context), logger(logger)
+    OperatorLogicExpressionNode::OperandsVector & operands,
+    std::shared_ptr<ThreadPool> threadPool)
+  : context(context), logger(logger), threadPool(std::move(threadPool))
 {
   for (auto & operand : operands)
     this->operands.emplace_back(std::move(operand));
@@ -20,9 +23,14 @@ DisjunctionExpressionNode::DisjunctionExpressionNode(
 
 void DisjunctionExpressionNode::compute(LogicFormulaResult & result) const
 {
+  ExplainTrace::Scope explainScope(explainTrace, "disjunction");
+  explainScope.SetStrategy(threadPool ? "operands in parallel" : "operands sequentially");
   result.value = false;
   std::vector<TemplateExpressionNode *> formulasWithoutConstants;
   std::vector<TemplateExpressionNode *> formulasToGenerate;
+  std::vector<TemplateExpressionNode *> formulasToComputeInParallel;
+  std::vector<size_t> parallelResultsIndices;
+  std::vector<LogicFormulaResult> operandsResults;
 
   for (auto const & operand : operands)
   {
@@ -30,24 +38,34 @@ void DisjunctionExpressionNode::compute(LogicFormulaResult & result) const
     auto atom = dynamic_cast<TemplateExpressionNode *>(operand.get());
     if (atom)
     {
-      if (!FormulaClassifier::isFormulaWithConst(context, atom->getFormula()))
+      if (!atom->hasConstants())
       {
         logger->Debug("Found formula without constants in disjunction");
         formulasWithoutConstants.push_back(atom);
         continue;
       }
-      if (FormulaClassifier::isFormulaToGenerate(context, atom->getFormula()))
+      if (atom->isToGenerate())
       {
         logger->Debug("Found formula to generate in disjunction");
         formulasToGenerate.push_back(atom);
         continue;
       }
+      if (threadPool)
+      {
+        // Result is placed at position of operand, so that replacements are united in the same order as sequentially
+        formulasToComputeInParallel.push_back(atom);
+        parallelResultsIndices.push_back(operandsResults.size());
+        operandsResults.emplace_back();
+        continue;
+      }
     }
     LogicFormulaResult lastResult;
     operand->compute(lastResult);
-    result.value |= lastResult.value;
-    ReplacementsUtils::UniteReplacements(result.replacements, lastResult.replacements, result.replacements);
+    operandsResults.push_back(std::move(lastResult));
   }
+  computeInParallel(formulasToComputeInParallel, parallelResultsIndices, operandsResults);
+  uniteResults(operandsResults, result);
+
   if (result.replacements.empty())
   {
     result.value = false;
@@ -68,6 +86,93 @@ void DisjunctionExpressionNode::compute(LogicFormulaResult & result) const
     result.value |= lastResult.value;
     ReplacementsUtils::UniteReplacements(result.replacements, lastResult.replacements, result.replacements);
   }
+  explainScope.SetRowsAmount(ReplacementsUtils::GetColumnsAmount(result.replacements));
+}
+
+/**
+ * Atoms are only searched, so every atom is computed by pool worker with sc-memory context of the worker. Atom that is
+ * run by waiting thread instead of pool worker is computed with its own context
+ */
+void DisjunctionExpressionNode::computeInParallel(
+    std::vector<TemplateExpressionNode *> const & atoms,
+    std::vector<size_t> const & resultsIndices,
+    std::vector<LogicFormulaResult> & operandsResults) const
+{
+  if (atoms.empty())
+    return;
+  logger->Debug("Compute ", atoms.size(), " atomic logical formulas of disjunction in parallel");
+
+  std::vector<std::vector<ScTemplateParams>> templateParamsVectors;
+  templateParamsVectors.reserve(atoms.size());
+  for (TemplateExpressionNode const * atom : atoms)
+    templateParamsVectors.push_back(atom->createComputeTemplateParams());
+
+  // Calls of pool workers are profiled for the same formula as calls of the current thread
+  ScMemoryProfiler * profiler = ScMemoryProfiler::GetActive();
+  ScAddr const formula = ScMemoryProfiler::GetActiveFormula();
+  std::vector<ExplainTrace::Operator> tracedOperators(atoms.size());
+  std::vector<std::future<LogicFormulaResult>> futures;
+  futures.reserve(atoms.size());
+  for (size_t i = 0; i < atoms.size(); ++i)
+  {
+    futures.push_back(threadPool->Submit(
+        [atom = atoms[i],
+         &templateParamsVector = templateParamsVectors[i],
+         &tracedOperator = tracedOperators[i],
+         pool = threadPool.get(),
+         profiler,
+         formula]() {
+          ScMemoryProfiler::Activation const profilerActivation(profiler, formula);
+          ScMemoryContext * workerContext = pool->GetWorkerContext();
+          if (workerContext)
+            return atom->computeInContext(workerContext, templateParamsVector, tracedOperator);
+          ScMemoryContext taskContext;
+          return atom->computeInContext(&taskContext, templateParamsVector, tracedOperator);
+        }));
+  }
+  for (size_t i = 0; i < futures.size(); ++i)
+    operandsResults[resultsIndices[i]] = threadPool->Await(futures[i]);
+  if (explainTrace)
+  {
+    for (ExplainTrace::Operator const & tracedOperator : tracedOperators)
+      explainTrace->AddOperator(tracedOperator);
+  }
+}
+
+/// Results of operands are united pairwise, pairs of each level are united concurrently if pool is set
+void DisjunctionExpressionNode::uniteResults(
+    std::vector<LogicFormulaResult> & operandsResults,
+    LogicFormulaResult & result) const
+{
+  for (LogicFormulaResult const & operandResult : operandsResults)
+    result.value |= operandResult.value;
+
+  if (threadPool)
+  {
+    while (operandsResults.size() > 2)
+    {
+      std::vector<std::future<Replacements>> futures;
+      for (size_t i = 0; i + 1 < operandsResults.size(); i += 2)
+      {
+        futures.push_back(threadPool->Submit(
+            [&first = operandsResults[i].replacements, &second = operandsResults[i + 1].replacements]() {
+              Replacements united;
+              ReplacementsUtils::UniteReplacements(first, second, united);
+              return united;
+            }));
+      }
+      std::vector<LogicFormulaResult> unitedResults;
+      unitedResults.reserve(futures.size() + 1);
+      for (auto & future : futures)
+        unitedResults.push_back({true, false, threadPool->Await(future)});
+      if (operandsResults.size() % 2 == 1)
+        unitedResults.push_back(std::move(operandsResults.back()));
+      operandsResults = std::move(unitedResults);
+    }
+  }
+
+  for (LogicFormulaResult const & operandResult : operandsResults)
+    ReplacementsUtils::UniteReplacements(result.replacements, operandResult.replacements, result.replacements);
 }
 
 void DisjunctionExpressionNode::generate(Replacements & replacements, LogicFormulaResult & result)
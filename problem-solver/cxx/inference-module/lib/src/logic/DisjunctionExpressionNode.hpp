@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include "inference/thread_pool.hpp"
+
 #include "TemplateExpressionNode.hpp"
 
 using namespace inference;
@@ -13,7 +15,11 @@ using namespace inference;
 class DisjunctionExpressionNode : public OperatorLogicExpressionNode
 {
 public:
-  explicit DisjunctionExpressionNode(ScMemoryContext * context, utils::ScLogger * logger, OperandsVector & operands);
+  explicit DisjunctionExpressionNode(
+      ScMemoryContext * context,
+      utils::ScLogger * logger,
+      OperandsVector & operands,
+      std::shared_ptr<ThreadPool> threadPool = nullptr);
 
   void compute(LogicFormulaResult & result) const override;
 
@@ -24,4 +30,13 @@ public:
 private:
   ScMemoryContext * context;
   utils::ScLogger * logger;
+  std::shared_ptr<ThreadPool> threadPool;
+
+  /// Compute atoms concurrently and put their results into operands results at the given indices
+  void computeInParallel(
+      std::vector<TemplateExpressionNode *> const & atoms,
+      std::vector<size_t> const & resultsIndices,
+      std::vector<LogicFormulaResult> & operandsResults) const;
+
+  void uniteResults(std::vector<LogicFormulaResult> & operandsResults, LogicFormulaResult & result) const;
 };
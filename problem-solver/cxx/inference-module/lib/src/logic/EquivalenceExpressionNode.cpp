@@ -6,7 +6,6 @@
 
 #include "EquivalenceExpressionNode.hpp"
 
-#include "classifier/FormulaClassifier.hpp"
 
 EquivalenceExpressionNode::EquivalenceExpressionNode(
     ScMemoryContext * context,
@@ -20,6 +19,7 @@ EquivalenceExpressionNode::EquivalenceExpressionNode(
 
 void EquivalenceExpressionNode::compute(LogicFormulaResult & result) const
 {
+  ExplainTrace::Scope explainScope(explainTrace, "equivalence");
   std::vector<LogicFormulaResult> subFormulaResults;
   result.value = false;
 
@@ -30,13 +30,13 @@ void EquivalenceExpressionNode::compute(LogicFormulaResult & result) const
     auto atom = dynamic_cast<TemplateExpressionNode *>(operand.get());
     if (atom)
     {
-      if (!FormulaClassifier::isFormulaWithConst(context, atom->getFormula()))
+      if (!atom->hasConstants())
       {
         logger->Debug("Found formula without constants in equivalence");
         formulasWithoutConstants.push_back(atom);
         continue;
       }
-      if (FormulaClassifier::isFormulaToGenerate(context, atom->getFormula()))
+      if (atom->isToGenerate())
       {
         logger->Debug("Found formula to generate in equivalence");
         formulasToGenerate.push_back(atom);
@@ -76,13 +76,13 @@ void EquivalenceExpressionNode::compute(LogicFormulaResult & result) const
   return;
 
   auto leftAtom = dynamic_cast<TemplateExpressionNode *>(operands[0].get());
-  bool isLeftGenerated = (leftAtom) && FormulaClassifier::isFormulaToGenerate(context, leftAtom->getFormula());
+  bool isLeftGenerated = (leftAtom) && leftAtom->isToGenerate();
 
   auto rightAtom = dynamic_cast<TemplateExpressionNode *>(operands[1].get());
-  bool isRightGenerated = (rightAtom) && FormulaClassifier::isFormulaToGenerate(context, rightAtom->getFormula());
+  bool isRightGenerated = (rightAtom) && rightAtom->isToGenerate();
 
-  bool leftHasConstants = (leftAtom) && FormulaClassifier::isFormulaWithConst(context, leftAtom->getFormula());
-  bool rightHasConstants = (rightAtom) && FormulaClassifier::isFormulaWithConst(context, rightAtom->getFormula());
+  bool leftHasConstants = (leftAtom) && leftAtom->hasConstants();
+  bool rightHasConstants = (rightAtom) && rightAtom->hasConstants();
 
   logger->Debug("Left has constants = ", leftHasConstants);
   logger->Debug("Right has constants = ", rightHasConstants);
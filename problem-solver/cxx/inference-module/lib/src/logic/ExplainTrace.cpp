@@ -0,0 +1,215 @@
+/*
+ * This source file is part of an OSTIS project. For the latest info, see http://ostis.net
+ * Distributed under the MIT License
+ * (See accompanying file COPYING.MIT or copy at http://opensource.org/licenses/MIT)
+ */
+
+#include "ExplainTrace.hpp"
+
+#include <cstdio>
+
+namespace inference
+{
+namespace
+{
+void WriteJsonString(std::string & json, std::string const & value)
+{
+  json += '"';
+  for (char const symbol : value)
+  {
+    switch (symbol)
+    {
+    case '"':
+      json += "\\\"";
+      break;
+    case '\\':
+      json += "\\\\";
+      break;
+    case '\n':
+      json += "\\n";
+      break;
+    case '\t':
+      json += "\\t";
+      break;
+    default:
+      if (static_cast<unsigned char>(symbol) < 0x20)
+      {
+        char escaped[7];
+        std::snprintf(escaped, sizeof(escaped), "\\u%04x", symbol);
+        json += escaped;
+      }
+      else
+        json += symbol;
+    }
+  }
+  json += '"';
+}
+}  // namespace
+
+ExplainTrace::Scope::Scope(
+    std::shared_ptr<ExplainTrace> const & trace,
+    std::string const & name,
+    ScAddr const & formula)
+{
+  if (!trace || trace->ownerThread != std::this_thread::get_id())
+    return;
+  this->trace = trace.get();
+  operatorIndex = this->trace->Open(name, formula);
+  start = std::chrono::steady_clock::now();
+}
+
+ExplainTrace::Scope::~Scope()
+{
+  if (trace)
+    trace->Close(
+        operatorIndex,
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start));
+}
+
+void ExplainTrace::Scope::SetStrategy(std::string const & strategy)
+{
+  if (trace)
+    trace->operators[operatorIndex].strategy = strategy;
+}
+
+void ExplainTrace::Scope::SetParamsAmount(size_t amount)
+{
+  if (trace)
+    trace->operators[operatorIndex].paramsAmount = amount;
+}
+
+void ExplainTrace::Scope::SetInputRowsAmount(size_t amount)
+{
+  if (trace)
+    trace->operators[operatorIndex].inputRowsAmount = amount;
+}
+
+void ExplainTrace::Scope::SetRowsAmount(size_t amount)
+{
+  if (trace)
+    trace->operators[operatorIndex].rowsAmount = amount;
+}
+
+void ExplainTrace::Scope::SetGeneratedAmount(size_t amount)
+{
+  if (trace)
+    trace->operators[operatorIndex].generatedAmount = amount;
+}
+
+ExplainTrace::ExplainTrace(ScMemoryContext * context)
+  : context(context)
+  , ownerThread(std::this_thread::get_id())
+{
+}
+
+std::vector<ExplainTrace::Operator> const & ExplainTrace::GetOperators() const
+{
+  return operators;
+}
+
+void ExplainTrace::AddOperator(Operator const & completedOperator)
+{
+  if (ownerThread != std::this_thread::get_id())
+    return;
+  size_t const operatorIndex = Open(completedOperator.name, completedOperator.formula);
+  Operator & addedOperator = operators[operatorIndex];
+  addedOperator.strategy = completedOperator.strategy;
+  addedOperator.paramsAmount = completedOperator.paramsAmount;
+  addedOperator.inputRowsAmount = completedOperator.inputRowsAmount;
+  addedOperator.rowsAmount = completedOperator.rowsAmount;
+  addedOperator.generatedAmount = completedOperator.generatedAmount;
+  Close(operatorIndex, completedOperator.duration);
+}
+
+std::vector<size_t> const & ExplainTrace::GetRoots() const
+{
+  return roots;
+}
+
+std::string ExplainTrace::ToJson() const
+{
+  std::string json = "{\"operators\":[";
+  for (size_t i = 0; i < roots.size(); ++i)
+  {
+    if (i > 0)
+      json += ',';
+    WriteJson(json, roots[i]);
+  }
+  json += "]}";
+  return json;
+}
+
+ScAddr ExplainTrace::GenerateStructure() const
+{
+  ScAddr const & structure = context->GenerateNode(ScType::ConstNodeStructure);
+  ScAddr const & traceLink = context->GenerateLink(ScType::ConstNodeLink);
+  context->SetLinkContent(traceLink, ToJson(), false);
+  context->GenerateConnector(ScType::ConstPermPosArc, structure, traceLink);
+  for (size_t const root : roots)
+  {
+    ScAddr const & formula = operators[root].formula;
+    if (formula.IsValid() && !context->CheckConnector(structure, formula, ScType::ConstPermPosArc))
+      context->GenerateConnector(ScType::ConstPermPosArc, structure, formula);
+  }
+  return structure;
+}
+
+size_t ExplainTrace::Open(std::string const & name, ScAddr const & formula)
+{
+  size_t const operatorIndex = operators.size();
+  Operator & newOperator = operators.emplace_back();
+  newOperator.name = name;
+  newOperator.formula = formula;
+  if (formula.IsValid())
+  {
+    newOperator.formulaIdentifier = context->GetElementSystemIdentifier(formula);
+    if (newOperator.formulaIdentifier.empty())
+      newOperator.formulaIdentifier = std::to_string(formula.Hash());
+  }
+
+  if (openedOperators.empty())
+    roots.push_back(operatorIndex);
+  else
+    operators[openedOperators.back()].children.push_back(operatorIndex);
+  openedOperators.push_back(operatorIndex);
+  return operatorIndex;
+}
+
+void ExplainTrace::Close(size_t operatorIndex, std::chrono::microseconds duration)
+{
+  operators[operatorIndex].duration = duration;
+  // Scopes are destroyed in reverse order of construction, so the closed operator is the last opened one
+  openedOperators.pop_back();
+}
+
+void ExplainTrace::WriteJson(std::string & json, size_t operatorIndex) const
+{
+  Operator const & traceOperator = operators[operatorIndex];
+  json += "{\"operator\":";
+  WriteJsonString(json, traceOperator.name);
+  if (traceOperator.formula.IsValid())
+  {
+    json += ",\"formula\":";
+    WriteJsonString(json, traceOperator.formulaIdentifier);
+  }
+  if (!traceOperator.strategy.empty())
+  {
+    json += ",\"strategy\":";
+    WriteJsonString(json, traceOperator.strategy);
+  }
+  json += ",\"params\":" + std::to_string(traceOperator.paramsAmount);
+  json += ",\"inputRows\":" + std::to_string(traceOperator.inputRowsAmount);
+  json += ",\"rows\":" + std::to_string(traceOperator.rowsAmount);
+  json += ",\"generated\":" + std::to_string(traceOperator.generatedAmount);
+  json += ",\"durationUs\":" + std::to_string(traceOperator.duration.count());
+  json += ",\"children\":[";
+  for (size_t i = 0; i < traceOperator.children.size(); ++i)
+  {
+    if (i > 0)
+      json += ',';
+    WriteJson(json, traceOperator.children[i]);
+  }
+  json += "]}";
+}
+
+}  // namespace inference
@@ -0,0 +1,93 @@
+/*
+ * This source file is part of an OSTIS project. For the latest info, see http://ostis.net
+ * Distributed under the MIT License
+ * (See accompanying file COPYING.MIT or copy at http://opensource.org/licenses/MIT)
+ */
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sc-memory/sc_memory.hpp>
+
+namespace inference
+{
+/**
+ * Tree of operators executed while formulas are applied. Every operator records its formula, chosen strategy, amounts
+ * of template params, input and result rows, amount of generations and duration. Scopes are recorded only on the
+ * thread that created the trace, operators computed by pool workers are added by this thread when it awaits them
+ */
+class ExplainTrace
+{
+public:
+  struct Operator
+  {
+    std::string name;
+    ScAddr formula;
+    std::string formulaIdentifier;
+    std::string strategy;
+    size_t paramsAmount = 0;
+    size_t inputRowsAmount = 0;
+    size_t rowsAmount = 0;
+    size_t generatedAmount = 0;
+    std::chrono::microseconds duration{0};
+    std::vector<size_t> children;
+  };
+
+  /// Record operator from construction until destruction, nothing is recorded if trace is not set
+  class Scope
+  {
+  public:
+    Scope(std::shared_ptr<ExplainTrace> const & trace, std::string const & name, ScAddr const & formula = ScAddr::Empty);
+
+    ~Scope();
+
+    Scope(Scope const & other) = delete;
+    Scope & operator=(Scope const & other) = delete;
+
+    void SetStrategy(std::string const & strategy);
+    void SetParamsAmount(size_t amount);
+    void SetInputRowsAmount(size_t amount);
+    void SetRowsAmount(size_t amount);
+    void SetGeneratedAmount(size_t amount);
+
+  private:
+    ExplainTrace * trace = nullptr;
+    size_t operatorIndex = 0;
+    std::chrono::steady_clock::time_point start;
+  };
+
+  explicit ExplainTrace(ScMemoryContext * context);
+
+  std::vector<Operator> const & GetOperators() const;
+
+  /// Add operator completed by pool worker as a child of the current scope, nothing is added on other threads
+  void AddOperator(Operator const & completedOperator);
+
+  /// Get indices of operators without parent, one for every applied formula
+  std::vector<size_t> const & GetRoots() const;
+
+  std::string ToJson() const;
+
+  /// Generate structure with JSON trace in link and applied formulas
+  ScAddr GenerateStructure() const;
+
+private:
+  ScMemoryContext * context;
+  std::thread::id const ownerThread;
+  std::vector<Operator> operators;
+  std::vector<size_t> roots;
+  std::vector<size_t> openedOperators;
+
+  size_t Open(std::string const & name, ScAddr const & formula);
+
+  void Close(size_t operatorIndex, std::chrono::microseconds duration);
+
+  void WriteJson(std::string & json, size_t operatorIndex) const;
+};
+
+}  // namespace inference
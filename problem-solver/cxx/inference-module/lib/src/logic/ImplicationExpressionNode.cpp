@@ -25,6 +25,7 @@ ImplicationExpressionNode::ImplicationExpressionNode(
  */
 void ImplicationExpressionNode::compute(LogicFormulaResult & result) const
 {
+  ExplainTrace::Scope explainScope(explainTrace, "implication");
   LogicExpressionNode * premiseAtom = operands[0].get();
   premiseAtom->setArgumentVector(argumentVector);
 
@@ -45,6 +46,8 @@ void ImplicationExpressionNode::compute(LogicFormulaResult & result) const
   if (conclusionResult.value)
     ReplacementsUtils::IntersectReplacements(
         premiseResult.replacements, conclusionResult.replacements, result.replacements);
+  explainScope.SetInputRowsAmount(ReplacementsUtils::GetColumnsAmount(premiseResult.replacements));
+  explainScope.SetRowsAmount(ReplacementsUtils::GetColumnsAmount(result.replacements));
 }
 
 void ImplicationExpressionNode::generate(Replacements & replacements, LogicFormulaResult & result)
@@ -16,6 +16,11 @@
 #include "EquivalenceExpressionNode.hpp"
 #include "TemplateExpressionNode.hpp"
 
+#include <sc-memory-profiler/sc_memory_profiler.hpp>
+
+using utils::ScMemoryCallType;
+using utils::ScMemoryProfiler;
+
 LogicExpression::LogicExpression(
     ScMemoryContext * context,
     utils::ScLogger * logger,
@@ -32,9 +37,36 @@ LogicExpression::LogicExpression(
 {
 }
 
+void LogicExpression::setThreadPool(std::shared_ptr<ThreadPool> otherThreadPool)
+{
+  threadPool = std::move(otherThreadPool);
+}
+
+void LogicExpression::setSearchResultsMemo(std::shared_ptr<AtomSearchResultsMemo> otherSearchResultsMemo)
+{
+  searchResultsMemo = std::move(otherSearchResultsMemo);
+}
+
+void LogicExpression::setBudgetTracker(std::shared_ptr<InferenceBudgetTracker> otherBudgetTracker)
+{
+  budgetTracker = std::move(otherBudgetTracker);
+}
+
+void LogicExpression::setExplainTrace(std::shared_ptr<ExplainTrace> otherExplainTrace)
+{
+  explainTrace = std::move(otherExplainTrace);
+}
+
 std::shared_ptr<LogicExpressionNode> LogicExpression::build(ScAddr const & formula)
 {
-  int formulaType = FormulaClassifier::typeOfFormula(context, logger, formula);
+  std::shared_ptr<LogicExpressionNode> node = buildByFormulaType(formula);
+  node->setExplainTrace(explainTrace);
+  return node;
+}
+
+std::shared_ptr<LogicExpressionNode> LogicExpression::buildByFormulaType(ScAddr const & formula)
+{
+  int formulaType = templateSearcher->getFormulaMetadataCache()->GetFormulaClass(context, logger, formula);
   switch (formulaType)
   {
   case FormulaClassifier::ATOMIC:
@@ -63,15 +95,23 @@ std::shared_ptr<LogicExpressionNode> LogicExpression::build(ScAddr const & formu
 
 OperatorLogicExpressionNode::OperandsVector LogicExpression::resolveTupleOperands(ScAddr const & tuple)
 {
-  ScIterator3Ptr operandsIterator = context->CreateIterator3(tuple, ScType::ConstPermPosArc, ScType::Unknown);
+  // Operands are collected before they are built, so that sc-memory calls of building are not measured as iteration
+  ScAddrVector operands;
+  {
+    ScMemoryProfiler::Scope const profilerScope(ScMemoryCallType::CREATE_ITERATOR);
+    ScIterator3Ptr operandsIterator = context->CreateIterator3(tuple, ScType::ConstPermPosArc, ScType::Unknown);
+    while (operandsIterator->Next())
+    {
+      if (operandsIterator->Get(2).IsValid())
+        operands.push_back(operandsIterator->Get(2));
+    }
+  }
 
   OperatorLogicExpressionNode::OperandsVector operandsVector;
 
-  while (operandsIterator->Next())
+  for (ScAddr const & operand : operands)
   {
-    if (!operandsIterator->Get(2).IsValid())
-      continue;
-    std::shared_ptr<LogicExpressionNode> op = build(operandsIterator->Get(2));
+    std::shared_ptr<LogicExpressionNode> op = build(operand);
     operandsVector.emplace_back(std::move(op));
   }
   logger->Debug("Amount of operands in ", context->GetElementSystemIdentifier(tuple), ": ", operandsVector.size());
@@ -128,8 +168,11 @@ std::shared_ptr<LogicExpressionNode> LogicExpression::buildAtomicFormula(ScAddr
     }
   }
 
-  return std::make_shared<TemplateExpressionNode>(
+  auto atom = std::make_shared<TemplateExpressionNode>(
       context, logger, templateSearcher, templateManager, solutionTreeManager, outputStructure, formula);
+  atom->setSearchResultsMemo(searchResultsMemo);
+  atom->setBudgetTracker(budgetTracker, negationDepth > 0);
+  return atom;
 }
 
 std::shared_ptr<LogicExpressionNode> LogicExpression::buildConjunctionFormula(ScAddr const & formula)
@@ -137,7 +180,7 @@ std::shared_ptr<LogicExpressionNode> LogicExpression::buildConjunctionFormula(Sc
   logger->Debug(context->GetElementSystemIdentifier(formula), " is a conjunction tuple");
   OperatorLogicExpressionNode::OperandsVector operands = resolveTupleOperands(formula);
   if (!operands.empty())
-    return std::make_unique<ConjunctionExpressionNode>(context, logger, operands);
+    return std::make_unique<ConjunctionExpressionNode>(context, logger, operands, budgetTracker, negationDepth > 0);
   else
     SC_THROW_EXCEPTION(utils::ExceptionItemNotFound, "Conjunction must have operands");
 }
@@ -147,7 +190,7 @@ std::shared_ptr<LogicExpressionNode> LogicExpression::buildDisjunctionFormula(Sc
   logger->Debug(context->GetElementSystemIdentifier(formula), " is a disjunction tuple");
   OperatorLogicExpressionNode::OperandsVector operands = resolveTupleOperands(formula);
   if (!operands.empty())
-    return std::make_unique<DisjunctionExpressionNode>(context, logger, operands);
+    return std::make_unique<DisjunctionExpressionNode>(context, logger, operands, threadPool);
   else
     SC_THROW_EXCEPTION(utils::ExceptionItemNotFound, "Disjunction must have operands");
 }
@@ -155,7 +198,9 @@ std::shared_ptr<LogicExpressionNode> LogicExpression::buildDisjunctionFormula(Sc
 std::shared_ptr<LogicExpressionNode> LogicExpression::buildNegationFormula(ScAddr const & formula)
 {
   logger->Debug(context->GetElementSystemIdentifier(formula), " is a negation tuple");
+  ++negationDepth;
   OperatorLogicExpressionNode::OperandsVector operands = resolveTupleOperands(formula);
+  --negationDepth;
   if (operands.size() == 1)
     return std::make_shared<NegationExpressionNode>(logger, operands[0]);
   else
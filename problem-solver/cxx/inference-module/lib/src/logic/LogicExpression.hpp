@@ -15,12 +15,15 @@
 #include "inference/inference_keynodes.hpp"
 #include "inference/template_manager.hpp"
 #include "inference/replacements_utils.hpp"
+#include "inference/thread_pool.hpp"
 
 #include "manager/solution-tree-manager/SolutionTreeManager.hpp"
+#include "manager/inference-manager/InferenceBudgetTracker.hpp"
 
 #include "searcher/template-searcher/TemplateSearcherAbstract.hpp"
 
 #include "LogicExpressionNode.hpp"
+#include "AtomSearchResultsMemo.hpp"
 
 using namespace inference;
 
@@ -35,6 +38,14 @@ public:
       std::shared_ptr<SolutionTreeManagerAbstract> solutionTreeManager,
       ScAddr const & outputStructure);
 
+  void setThreadPool(std::shared_ptr<ThreadPool> otherThreadPool);
+
+  void setSearchResultsMemo(std::shared_ptr<AtomSearchResultsMemo> otherSearchResultsMemo);
+
+  void setBudgetTracker(std::shared_ptr<InferenceBudgetTracker> otherBudgetTracker);
+
+  void setExplainTrace(std::shared_ptr<ExplainTrace> otherExplainTrace);
+
   std::shared_ptr<LogicExpressionNode> build(ScAddr const & formula);
 
   std::shared_ptr<LogicExpressionNode> buildAtomicFormula(ScAddr const & formula);
@@ -58,6 +69,14 @@ private:
   std::shared_ptr<TemplateSearcherAbstract> templateSearcher;
   std::shared_ptr<TemplateManagerAbstract> templateManager;
   std::shared_ptr<SolutionTreeManagerAbstract> solutionTreeManager;
+  std::shared_ptr<ThreadPool> threadPool;
+  std::shared_ptr<AtomSearchResultsMemo> searchResultsMemo;
+  std::shared_ptr<InferenceBudgetTracker> budgetTracker;
+  std::shared_ptr<ExplainTrace> explainTrace;
 
   ScAddr outputStructure;
+  /// Amount of negations around the built formula, replacements under negation are not limited by budget
+  size_t negationDepth = 0;
+
+  std::shared_ptr<LogicExpressionNode> buildByFormulaType(ScAddr const & formula);
 };
@@ -9,6 +9,8 @@
 #include "inference/types.hpp"
 #include <memory>
 
+#include "ExplainTrace.hpp"
+
 namespace inference
 {
 
@@ -40,9 +42,16 @@ public:
     outputStructureElements = otherOutputStructureElements;
   }
 
+  /// Set trace to record executed operators of the node
+  void setExplainTrace(std::shared_ptr<ExplainTrace> otherExplainTrace)
+  {
+    explainTrace = std::move(otherExplainTrace);
+  }
+
 protected:
   ScAddrVector argumentVector;
   std::unordered_set<ScAddr, ScAddrHashFunc> outputStructureElements;
+  std::shared_ptr<ExplainTrace> explainTrace;
 };
 
 class OperatorLogicExpressionNode : public LogicExpressionNode
@@ -14,6 +14,7 @@ NegationExpressionNode::NegationExpressionNode(utils::ScLogger * logger, std::sh
 
 void NegationExpressionNode::compute(LogicFormulaResult & result) const
 {
+  ExplainTrace::Scope explainScope(explainTrace, "negation");
   operands[0]->compute(result);
   logger->Debug("Sub formula in negation returned ", (result.value ? "true" : "false"));
   result.value = !result.value;
@@ -24,6 +25,124 @@ void NegationExpressionNode::generate(Replacements & replacements, LogicFormulaR
   result = {false, false, {}};
 }
 
+void NegationExpressionNode::filter(Replacements const & replacements, Replacements & result) const
+{
+  if (ReplacementsUtils::GetColumnsAmount(replacements) == 0)
+  {
+    result = replacements;
+    return;
+  }
+
+  ExplainTrace::Scope explainScope(explainTrace, "subtract");
+  explainScope.SetInputRowsAmount(ReplacementsUtils::GetColumnsAmount(replacements));
+  operands[0]->setArgumentVector(argumentVector);
+  auto const * atom = dynamic_cast<TemplateExpressionNode const *>(operands[0].get());
+  if (atom)
+  {
+    explainScope.SetStrategy("anti-join by distinct bindings of negated atom");
+    filterByAtom(atom, replacements, result);
+  }
+  else
+  {
+    explainScope.SetStrategy("anti-join with computed negated formula");
+    filterByComputedOperand(replacements, result);
+  }
+  explainScope.SetRowsAmount(ReplacementsUtils::GetColumnsAmount(result));
+  logger->Debug(
+      "Negation kept ",
+      ReplacementsUtils::GetColumnsAmount(result),
+      " of ",
+      ReplacementsUtils::GetColumnsAmount(replacements),
+      " replacements");
+}
+
+void NegationExpressionNode::filterByAtom(
+    TemplateExpressionNode const * atom,
+    Replacements const & replacements,
+    Replacements & result) const
+{
+  ScAddrUnorderedSet const atomVariables = atom->getVariables();
+  ScAddrVector sharedVariables;
+  for (auto const & pair : replacements)
+  {
+    if (atomVariables.count(pair.first))
+      sharedVariables.push_back(pair.first);
+  }
+
+  // Group columns by binding of shared variables, so the atom is probed once per distinct binding
+  size_t const columnsAmount = ReplacementsUtils::GetColumnsAmount(replacements);
+  std::unordered_map<ScAddrVector, size_t, ReplacementsUtils::ColumnHashFunc> bindingIndices;
+  std::vector<size_t> columnBindings;
+  columnBindings.reserve(columnsAmount);
+  std::vector<ScTemplateParams> probeParams;
+  for (size_t column = 0; column < columnsAmount; ++column)
+  {
+    ScAddrVector binding;
+    binding.reserve(sharedVariables.size());
+    for (ScAddr const & variable : sharedVariables)
+      binding.push_back(replacements.at(variable)[column]);
+
+    auto const & [bindingIterator, isNewBinding] = bindingIndices.emplace(std::move(binding), probeParams.size());
+    if (isNewBinding)
+    {
+      ScTemplateParams params;
+      for (size_t i = 0; i < sharedVariables.size(); ++i)
+      {
+        ScAddr const & value = bindingIterator->first[i];
+        if (value.IsValid())
+          params.Add(sharedVariables[i], value);
+      }
+      probeParams.push_back(std::move(params));
+    }
+    columnBindings.push_back(bindingIterator->second);
+  }
+
+  std::vector<bool> const bindingsWithMatch = atom->checkReplacementsExistence(probeParams);
+  logger->Debug("Negated atom is probed for ", probeParams.size(), " distinct bindings");
+
+  Replacements filtered;
+  for (auto const & pair : replacements)
+    filtered[pair.first].reserve(columnsAmount);
+  for (size_t column = 0; column < columnsAmount; ++column)
+  {
+    if (bindingsWithMatch[columnBindings[column]])
+      continue;
+    for (auto const & pair : replacements)
+      filtered.at(pair.first).push_back(pair.second[column]);
+  }
+  result = std::move(filtered);
+}
+
+void NegationExpressionNode::filterByComputedOperand(Replacements const & replacements, Replacements & result) const
+{
+  LogicFormulaResult operandResult;
+  operands[0]->compute(operandResult);
+  if (!operandResult.value)
+  {
+    result = replacements;
+    return;
+  }
+
+  ScAddrUnorderedSet replacementsKeys;
+  ReplacementsUtils::GetKeySet(replacements, replacementsKeys);
+  bool hasSharedVariables = false;
+  for (auto const & pair : operandResult.replacements)
+  {
+    if (replacementsKeys.count(pair.first))
+    {
+      hasSharedVariables = true;
+      break;
+    }
+  }
+  // Operand that doesn't share variables with replacements excludes all of them once it is true
+  if (!hasSharedVariables)
+  {
+    result = {};
+    return;
+  }
+  ReplacementsUtils::SubtractReplacements(replacements, operandResult.replacements, result);
+}
+
 ScAddr NegationExpressionNode::getFormula() const
 {
   return ScAddr::Empty;
@@ -19,8 +19,23 @@ public:
 
   void generate(Replacements & replacements, LogicFormulaResult & result) override;
 
+  /**
+   * @brief Anti-join (negation as failure): keep columns of replacements for which negated operand has no replacements.
+   * Atomic operand is probed once per distinct binding of variables shared with replacements, probe is stopped at the
+   * first found replacement. Other operands are computed once and subtracted from replacements
+   * @param replacements is a bindings to filter
+   * @param result is a columns of replacements that negated operand does not match
+   */
+  void filter(Replacements const & replacements, Replacements & result) const;
+
   ScAddr getFormula() const override;
 
 private:
   utils::ScLogger * logger;
+
+  void filterByAtom(
+      TemplateExpressionNode const * atom,
+      Replacements const & replacements,
+      Replacements & result) const;
+  void filterByComputedOperand(Replacements const & replacements, Replacements & result) const;
 };
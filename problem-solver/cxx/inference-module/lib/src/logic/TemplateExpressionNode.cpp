@@ -6,12 +6,21 @@
 
 #include "TemplateExpressionNode.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <optional>
+
 #include <sc-agents-common/utils/GenerationUtils.hpp>
 
+#include <sc-memory-profiler/sc_memory_profiler.hpp>
+
 #include "inference/inference_config.hpp"
 
 #include "searcher/template-searcher/TemplateSearcherGeneral.hpp"
 
+using utils::ScMemoryCallType;
+using utils::ScMemoryProfiler;
+
 TemplateExpressionNode::TemplateExpressionNode(
     ScMemoryContext * context,
     utils::ScLogger * logger,
@@ -28,7 +37,10 @@ TemplateExpressionNode::TemplateExpressionNode(
   , outputStructure(outputStructure)
   , formula(formula)
 {
+  this->metadata = this->templateSearcher->getFormulaMetadata(formula);
   this->templateSearcherGeneral = std::make_unique<TemplateSearcherGeneral>(context);
+  this->templateSearcherGeneral->setFormulaMetadataCache(this->templateSearcher->getFormulaMetadataCache());
+  this->templateSearcherGeneral->setCancellationToken(this->templateSearcher->getCancellationToken());
   this->templateSearcherGeneral->SetReplacementsUsingType(this->templateSearcher->GetReplacementsUsingType());
   this->templateSearcherGeneral->setOutputStructureFillingType(this->templateSearcher->getOutputStructureFillingType());
 }
@@ -38,23 +50,48 @@ ScAddr TemplateExpressionNode::getFormula() const
   return formula;
 }
 
+void TemplateExpressionNode::setSearchResultsMemo(std::shared_ptr<AtomSearchResultsMemo> otherSearchResultsMemo)
+{
+  searchResultsMemo = std::move(otherSearchResultsMemo);
+  isOutputStructureSearched = outputStructure.IsValid() && templateSearcher->getInputStructures().count(outputStructure);
+}
+
+void TemplateExpressionNode::setBudgetTracker(
+    std::shared_ptr<InferenceBudgetTracker> otherBudgetTracker,
+    bool isNegated)
+{
+  budgetTracker = std::move(otherBudgetTracker);
+  this->isNegated = isNegated;
+}
+
 void TemplateExpressionNode::compute(LogicFormulaResult & result) const
 {
   logger->Debug(
       "TemplateExpressionNode: compute for ", (argumentVector.empty() ? "empty" : std::to_string(argumentVector.size())), " arguments");
-  ScAddrUnorderedSet variables;
+  ExplainTrace::Scope explainScope(explainTrace, "search", formula);
+  ScAddrUnorderedSet const & variables = metadata->variablesSet;
   result.replacements.clear();
-  templateSearcher->getVariables(formula, variables);
   // Template params should be created only if argument vector is not empty. Else search with any possible replacements
-  if (!argumentVector.empty())
+  std::vector<ScTemplateParams> const & templateParamsVector = createComputeTemplateParams();
+  explainScope.SetParamsAmount(templateParamsVector.size());
+  if (searchResultsMemo &&
+      searchResultsMemo->Find(*metadata, templateParamsVector, templateSearcher->getInputStructures(), result.replacements))
   {
-    std::vector<ScTemplateParams> const & templateParamsVector = templateManager->CreateTemplateParams(formula);
-    templateSearcher->searchTemplate(formula, templateParamsVector, variables, result.replacements);
+    logger->Debug("Search results of ", context->GetElementSystemIdentifier(formula), " are reused");
+    explainScope.SetStrategy("reused memoized search result");
   }
   else
   {
-    templateSearcher->searchTemplate(formula, ScTemplateParams(), variables, result.replacements);
+    explainScope.SetStrategy(argumentVector.empty() ? "search without params" : "search by arguments");
+    if (!argumentVector.empty())
+      templateSearcher->searchTemplate(formula, templateParamsVector, variables, result.replacements);
+    else
+      templateSearcher->searchTemplate(formula, templateParamsVector.front(), variables, result.replacements);
+    if (searchResultsMemo)
+      searchResultsMemo->Add(*metadata, templateParamsVector, templateSearcher->getInputStructures(), result.replacements);
   }
+  limitSearchResult(result.replacements);
+  explainScope.SetRowsAmount(ReplacementsUtils::GetColumnsAmount(result.replacements));
 
   result.value = !result.replacements.empty();
   logger->Debug(
@@ -62,17 +99,119 @@ void TemplateExpressionNode::compute(LogicFormulaResult & result) const
                                         , (result.value ? " true" : " false"));
 }
 
+std::vector<ScTemplateParams> TemplateExpressionNode::createComputeTemplateParams() const
+{
+  // Search with any possible replacements if there are no arguments
+  if (argumentVector.empty())
+    return {ScTemplateParams()};
+  return templateManager->CreateTemplateParams(formula);
+}
+
+LogicFormulaResult TemplateExpressionNode::computeInContext(
+    ScMemoryContext * otherContext,
+    std::vector<ScTemplateParams> const & templateParamsVector,
+    ExplainTrace::Operator & tracedOperator) const
+{
+  auto const start = std::chrono::steady_clock::now();
+  tracedOperator.name = "search";
+  tracedOperator.formula = formula;
+  tracedOperator.paramsAmount = templateParamsVector.size();
+  LogicFormulaResult result;
+  if (searchResultsMemo &&
+      searchResultsMemo->Find(*metadata, templateParamsVector, templateSearcher->getInputStructures(), result.replacements))
+  {
+    tracedOperator.strategy = "reused memoized search result";
+  }
+  else
+  {
+    tracedOperator.strategy = "search on pool worker";
+    // Memo may be invalidated by other threads while formula is searched
+    std::optional<AtomSearchResultsMemo::InFlightSearch> inFlightSearch;
+    if (searchResultsMemo)
+      inFlightSearch.emplace(*searchResultsMemo);
+    std::unique_ptr<TemplateSearcherAbstract> const searcher = templateSearcher->clone(otherContext);
+    searcher->searchTemplate(formula, templateParamsVector, metadata->variablesSet, result.replacements);
+    if (inFlightSearch)
+      searchResultsMemo->Add(
+          *metadata,
+          templateParamsVector,
+          templateSearcher->getInputStructures(),
+          result.replacements,
+          inFlightSearch->GetVersion());
+  }
+  if (budgetTracker)
+    budgetTracker->LimitReplacements(result.replacements, isNegated);
+  tracedOperator.rowsAmount = ReplacementsUtils::GetColumnsAmount(result.replacements);
+  tracedOperator.duration =
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+  result.value = !result.replacements.empty();
+  return result;
+}
+
+ScAddrUnorderedSet TemplateExpressionNode::getVariables() const
+{
+  return metadata->variablesSet;
+}
+
+bool TemplateExpressionNode::hasConstants() const
+{
+  return metadata->hasConstants;
+}
+
+bool TemplateExpressionNode::isToGenerate() const
+{
+  return metadata->isToGenerate;
+}
+
+std::vector<bool> TemplateExpressionNode::checkReplacementsExistence(
+    std::vector<ScTemplateParams> const & templateParamsVector) const
+{
+  Replacements probeResult;
+  return searchFirstReplacements(*templateSearcher, templateParamsVector, probeResult);
+}
+
+/**
+ * @brief Search formula with every template params until the first found replacement
+ * @param searcher is cloned to search formula regardless of the configured replacements using type
+ * @param foundReplacements out param, found replacement of every params is appended here
+ * @return vector of flags, i-th flag is true if formula has replacement with i-th params
+ */
+std::vector<bool> TemplateExpressionNode::searchFirstReplacements(
+    TemplateSearcherAbstract const & searcher,
+    std::vector<ScTemplateParams> const & templateParamsVector,
+    Replacements & foundReplacements) const
+{
+  std::unique_ptr<TemplateSearcherAbstract> const probeSearcher = searcher.clone(context);
+  probeSearcher->SetReplacementsUsingType(REPLACEMENTS_FIRST);
+  ScAddrUnorderedSet const & variables = metadata->variablesSet;
+
+  std::vector<bool> existence;
+  existence.reserve(templateParamsVector.size());
+  for (ScTemplateParams const & templateParams : templateParamsVector)
+  {
+    size_t const previousAmountOfColumns = ReplacementsUtils::GetColumnsAmount(foundReplacements);
+    probeSearcher->searchTemplate(formula, templateParams, variables, foundReplacements);
+    existence.push_back(ReplacementsUtils::GetColumnsAmount(foundReplacements) > previousAmountOfColumns);
+  }
+  return existence;
+}
+
 LogicFormulaResult TemplateExpressionNode::search(Replacements & replacements) const
 {
+  ExplainTrace::Scope explainScope(explainTrace, "search", formula);
+  explainScope.SetStrategy("search by replacements");
+  explainScope.SetInputRowsAmount(ReplacementsUtils::GetColumnsAmount(replacements));
   LogicFormulaResult result;
   std::vector<ScTemplateParams> paramsVector;
   ReplacementsUtils::GetReplacementsToScTemplateParams(replacements, paramsVector);
+  explainScope.SetParamsAmount(paramsVector.size());
   result.replacements.clear();
-  ScAddrUnorderedSet variables;
-  templateSearcher->getVariables(formula, variables);
+  ScAddrUnorderedSet const & variables = metadata->variablesSet;
   logger->Debug(
       "TemplateExpressionNode: call search for ", (paramsVector.empty() ? "empty" : std::to_string(paramsVector.size())), " params");
   templateSearcher->searchTemplate(formula, paramsVector, variables, result.replacements);
+  limitSearchResult(result.replacements);
+  explainScope.SetRowsAmount(ReplacementsUtils::GetColumnsAmount(result.replacements));
   result.value = !result.replacements.empty();
 
   std::string const idtf = context->GetElementSystemIdentifier(formula);
@@ -88,6 +227,8 @@ LogicFormulaResult TemplateExpressionNode::search(Replacements & replacements) c
  */
 void TemplateExpressionNode::generate(Replacements & replacements, LogicFormulaResult & result)
 {
+  ExplainTrace::Scope explainScope(explainTrace, "generate", formula);
+  explainScope.SetInputRowsAmount(ReplacementsUtils::GetColumnsAmount(replacements));
   result = {};
   if (ReplacementsUtils::GetColumnsAmount(replacements) == 0)
   {
@@ -95,8 +236,7 @@ void TemplateExpressionNode::generate(Replacements & replacements, LogicFormulaR
     return;
   }
 
-  ScAddrUnorderedSet formulaVariables;
-  templateSearcher->getVariables(formula, formulaVariables);
+  ScAddrUnorderedSet const & formulaVariables = metadata->variablesSet;
   // existingFormulaReplacements stores all replacements for atomic logical formula searched with
   // TemplateSearcherGeneral if condition in getSearchResultWithoutReplacementsIfNeeded() is true
   Replacements const & existingFormulaReplacements = getSearchResultWithoutReplacementsIfNeeded();
@@ -104,8 +244,18 @@ void TemplateExpressionNode::generate(Replacements & replacements, LogicFormulaR
   size_t count = 0;
   Replacements searchResult;
   Replacements generatedReplacements;
-  if (templateManager->GetGenerationType() == GENERATE_UNIQUE_FORMULAS)
+  if (templateManager->GetGenerationType() == GENERATE_UNIQUE_FORMULAS &&
+      templateSearcher->getAtomicLogicalFormulaSearchBeforeGenerationType() == CHECK_REPLACEMENTS_EXISTENCE)
+  {
+    explainScope.SetStrategy("unique, existence is checked for distinct replacements");
+    generateByExistenceCheck(replacements, result, count, formulaVariables, searchResult, generatedReplacements);
+  }
+  else if (templateManager->GetGenerationType() == GENERATE_UNIQUE_FORMULAS)
   {
+    explainScope.SetStrategy(
+        templateSearcher->getAtomicLogicalFormulaSearchBeforeGenerationType() == SEARCH_WITHOUT_REPLACEMENTS
+            ? "unique, existing formulas are searched once without replacements"
+            : "unique, existence is checked for every replacement");
     // replacementsNotInKb stores all replacements from passed to TemplateExpressionNode::generate parameter that don't
     // have corresponding columns in existingFormulaReplacements
     Replacements replacementsNotInKb;
@@ -115,13 +265,26 @@ void TemplateExpressionNode::generate(Replacements & replacements, LogicFormulaR
     generateByReplacements(replacementsNotInKb, result, count, formulaVariables, searchResult, generatedReplacements);
   }
   else
+  {
+    explainScope.SetStrategy("all");
     generateByReplacements(replacements, result, count, formulaVariables, searchResult, generatedReplacements);
+  }
 
   fillOutputStructure(formulaVariables, replacements, existingFormulaReplacements, searchResult);
+  if (count > 0)
+  {
+    // Values of formula variables are touched too, e.g. class bound to variable gets new elements
+    ScAddrUnorderedSet touchedElements = metadata->constants;
+    for (auto const & [variable, values] : generatedReplacements)
+      touchedElements.insert(values.cbegin(), values.cend());
+    invalidateSearchResults(touchedElements);
+  }
 
   Replacements intermediateUniteResult;
   ReplacementsUtils::UniteReplacements(searchResult, existingFormulaReplacements, intermediateUniteResult);
   ReplacementsUtils::UniteReplacements(intermediateUniteResult, generatedReplacements, result.replacements);
+  explainScope.SetGeneratedAmount(count);
+  explainScope.SetRowsAmount(ReplacementsUtils::GetColumnsAmount(result.replacements));
 
   logger->Debug(
       "Atomic logical formula ", context->GetElementSystemIdentifier(formula), " is generated ", count
@@ -138,9 +301,8 @@ Replacements TemplateExpressionNode::getSearchResultWithoutReplacementsIfNeeded(
   Replacements resultWithoutReplacements;
   if (templateSearcher->getAtomicLogicalFormulaSearchBeforeGenerationType() == SEARCH_WITHOUT_REPLACEMENTS)
   {
-    ScAddrUnorderedSet variables;
-    templateSearcherGeneral->getVariables(formula, variables);
-    templateSearcherGeneral->searchTemplate(formula, ScTemplateParams(), variables, resultWithoutReplacements);
+    templateSearcherGeneral->searchTemplate(
+        formula, ScTemplateParams(), metadata->variablesSet, resultWithoutReplacements);
   }
   return resultWithoutReplacements;
 }
@@ -153,11 +315,70 @@ void TemplateExpressionNode::generateByReplacements(
     Replacements & searchResult,
     Replacements & generatedReplacements)
 {
+  // Template params of generation bind only formula variables
+  ScAddrUnorderedSet keysToRemove;
+  for (auto const & pair : replacements)
+  {
+    if (!formulaVariables.count(pair.first))
+      keysToRemove.insert(pair.first);
+  }
   std::vector<ScTemplateParams> paramsVector;
-  ReplacementsUtils::GetReplacementsToScTemplateParams(replacements, paramsVector);
+  ReplacementsUtils::GetReplacementsToScTemplateParams(
+      ReplacementsUtils::removeRows(replacements, keysToRemove), paramsVector);
   processTemplateParams(paramsVector, formulaVariables, result, count, searchResult, generatedReplacements);
 }
 
+/**
+ * @brief Generate atomic logical formula for replacements that don't have existing formula. Replacements are projected
+ * to formula variables and existence of formula is checked for every distinct column with search stopped at the first
+ * found replacement, so existing formulas are never enumerated
+ */
+void TemplateExpressionNode::generateByExistenceCheck(
+    Replacements const & replacements,
+    LogicFormulaResult & result,
+    size_t & count,
+    ScAddrUnorderedSet const & formulaVariables,
+    Replacements & searchResult,
+    Replacements & generatedReplacements)
+{
+  Replacements formulaReplacements;
+  ReplacementsUtils::ProjectReplacements(replacements, formulaVariables, formulaReplacements);
+  std::vector<ScTemplateParams> paramsVector;
+  ReplacementsUtils::GetReplacementsToScTemplateParams(formulaReplacements, paramsVector);
+  // Replacements don't bind formula variables, so formula is generated once if it doesn't exist
+  if (formulaReplacements.empty())
+    paramsVector.emplace_back();
+  std::vector<bool> const & existence = searchFirstReplacements(*templateSearcherGeneral, paramsVector, searchResult);
+
+  TemplateBatchGenerator generator(context, formula, formulaVariables, paramsVector.size(), outputStructure.IsValid());
+  for (size_t columnIndex = 0; columnIndex < paramsVector.size(); ++columnIndex)
+  {
+    if (existence[columnIndex])
+      continue;
+    if (templateManager->GetReplacementsUsingType() == REPLACEMENTS_FIRST && result.isGenerated)
+      break;
+    // Formula generated for other column can be found with params that don't bind some variables, so they are checked
+    // again. Columns with all variables bound differ from each other by a value and are not checked again
+    bool const hasUnboundValues = std::any_of(
+        formulaReplacements.cbegin(),
+        formulaReplacements.cend(),
+        [columnIndex](auto const & pair) {
+          return !pair.second[columnIndex].IsValid();
+        });
+    if (count > 0 && hasUnboundValues)
+    {
+      size_t const previousSearchSize = ReplacementsUtils::GetColumnsAmount(searchResult);
+      templateSearcherGeneral->searchTemplate(formula, paramsVector[columnIndex], formulaVariables, searchResult);
+      if (ReplacementsUtils::GetColumnsAmount(searchResult) != previousSearchSize)
+        continue;
+    }
+    if (budgetTracker && !budgetTracker->TryGenerate())
+      break;
+    generateByParams(generator, paramsVector[columnIndex], result, count);
+  }
+  finishGeneration(generator, generatedReplacements);
+}
+
 void TemplateExpressionNode::processTemplateParams(
     std::vector<ScTemplateParams> const & paramsVector,
     ScAddrUnorderedSet const & formulaVariables,
@@ -166,45 +387,43 @@ void TemplateExpressionNode::processTemplateParams(
     Replacements & searchResult,
     Replacements & generatedReplacements)
 {
+  TemplateBatchGenerator generator(context, formula, formulaVariables, paramsVector.size(), outputStructure.IsValid());
   for (ScTemplateParams const & params : paramsVector)
   {
     if (templateManager->GetReplacementsUsingType() == REPLACEMENTS_FIRST && result.isGenerated)
-      return;
+      break;
     size_t const previousSearchSize = ReplacementsUtils::GetColumnsAmount(searchResult);
     if (templateManager->GetGenerationType() == GENERATE_UNIQUE_FORMULAS)
       templateSearcherGeneral->searchTemplate(formula, params, formulaVariables, searchResult);
     if (templateManager->GetGenerationType() != GENERATE_UNIQUE_FORMULAS ||
         ReplacementsUtils::GetColumnsAmount(searchResult) == previousSearchSize)
-      generateByParams(params, formulaVariables, generatedReplacements, result, count);
+    {
+      if (budgetTracker && !budgetTracker->TryGenerate())
+        break;
+      generateByParams(generator, params, result, count);
+    }
   }
+  finishGeneration(generator, generatedReplacements);
 }
 
 void TemplateExpressionNode::generateByParams(
+    TemplateBatchGenerator & generator,
     ScTemplateParams const & params,
-    ScAddrUnorderedSet const & formulaVariables,
-    Replacements & generatedReplacements,
     LogicFormulaResult & result,
     size_t & count)
 {
-  ScTemplate generatedTemplate;
-  context->BuildTemplate(generatedTemplate, formula, params);
-
-  ScTemplateGenResult generationResult;
-  context->GenerateByTemplate(generatedTemplate, generationResult);
+  generator.Generate(params);
   ++count;
   result.isGenerated = true;
   result.value = true;
-  for (ScAddr const & variable : formulaVariables)
-  {
-    ScAddr outAddr;
-    if (generationResult.Get(variable, outAddr) || params.Get(variable, outAddr))
-      generatedReplacements[variable].push_back(outAddr);
-    else
-      SC_THROW_EXCEPTION(
-          utils::ExceptionInvalidState,
-          "Generation result and template params do not have replacement for " << variable.Hash());
-  }
-  addToOutputStructure(generationResult);
+}
+
+/// Generated elements of all generations are added to output structure at once
+void TemplateExpressionNode::finishGeneration(TemplateBatchGenerator & generator, Replacements & generatedReplacements)
+{
+  for (ScAddr const & element : generator.GetGeneratedElements())
+    addToOutputStructure(element);
+  generator.MoveGeneratedReplacements(generatedReplacements);
 }
 
 void TemplateExpressionNode::fillOutputStructure(
@@ -234,11 +453,28 @@ void TemplateExpressionNode::fillOutputStructure(
   }
 }
 
+void TemplateExpressionNode::invalidateSearchResults(ScAddrUnorderedSet const & touchedElements)
+{
+  // Arguments may become elements of generated classes
+  templateManager->InvalidateArgumentsOfClasses(touchedElements);
+  if (!searchResultsMemo)
+    return;
+  // Searched structure is changed, so any search result can be changed
+  if (isOutputStructureSearched)
+    searchResultsMemo->Clear();
+  else
+    searchResultsMemo->InvalidateByConstants(touchedElements);
+}
+
+void TemplateExpressionNode::limitSearchResult(Replacements & replacements) const
+{
+  if (budgetTracker && !budgetTracker->LimitReplacements(replacements, isNegated))
+    logger->Debug("Search result of ", context->GetElementSystemIdentifier(formula), " is limited by inference budget");
+}
+
 void TemplateExpressionNode::addFormulaConstantsToOutputStructure()
 {
-  ScAddrUnorderedSet formulaConstants;
-  templateSearcher->getConstants(formula, formulaConstants);
-  addToOutputStructure(formulaConstants);
+  addToOutputStructure(metadata->constants);
 }
 
 void TemplateExpressionNode::addToOutputStructure(
@@ -267,20 +503,14 @@ void TemplateExpressionNode::addToOutputStructure(ScAddrUnorderedSet const & ele
   }
 }
 
-void TemplateExpressionNode::addToOutputStructure(ScTemplateResultItem const & item)
-{
-  if (outputStructure.IsValid())
-  {
-    for (size_t i = 0; i < item.Size(); ++i)
-      addToOutputStructure(item[i]);
-  }
-}
-
 void TemplateExpressionNode::addToOutputStructure(ScAddr const & element)
 {
   if (outputStructureElements.find(element) == outputStructureElements.cend())
   {
+    ScMemoryProfiler::Scope const profilerScope(ScMemoryCallType::GENERATE_ELEMENT);
     context->GenerateConnector(ScType::ConstPermPosArc, outputStructure, element);
     outputStructureElements.insert(element);
+    if (isOutputStructureSearched && searchResultsMemo)
+      searchResultsMemo->Clear();
   }
 }
@@ -12,8 +12,11 @@
 #include "inference/template_manager_abstract.hpp"
 
 #include "LogicExpressionNode.hpp"
+#include "AtomSearchResultsMemo.hpp"
 
 #include "searcher/template-searcher/TemplateSearcherAbstract.hpp"
+#include "generator/TemplateBatchGenerator.hpp"
+#include "manager/inference-manager/InferenceBudgetTracker.hpp"
 
 
 using namespace inference;
@@ -31,6 +34,48 @@ public:
       ScAddr const & formula);
 
   void compute(LogicFormulaResult & result) const override;
+
+  /// Reuse search results of formulas with the same structure, memo is invalidated when the formula is generated
+  void setSearchResultsMemo(std::shared_ptr<AtomSearchResultsMemo> otherSearchResultsMemo);
+
+  /**
+   * Limit search results and generations of the formula by inference budget
+   * @param isNegated is true if the formula is under negation, its search results are not limited then
+   */
+  void setBudgetTracker(std::shared_ptr<InferenceBudgetTracker> otherBudgetTracker, bool isNegated = false);
+
+  /// Create template params to compute formula with, must be called by the thread that computes formula
+  std::vector<ScTemplateParams> createComputeTemplateParams() const;
+
+  /**
+   * @brief Compute formula with searcher working with other sc-memory context. Doesn't use node context and logger, so
+   * different nodes can be computed concurrently. Search results memo and budget are used as in `compute`
+   * @param otherContext is a context of the thread that computes formula
+   * @param templateParamsVector is a result of `createComputeTemplateParams`
+   * @param tracedOperator out param, search operator to be added to explain trace by the thread that owns it
+   */
+  LogicFormulaResult computeInContext(
+      ScMemoryContext * otherContext,
+      std::vector<ScTemplateParams> const & templateParamsVector,
+      ExplainTrace::Operator & tracedOperator) const;
+
+  /// Get variables of the formula
+  ScAddrUnorderedSet getVariables() const;
+
+  /// Check if formula has constant nodes or links, formulas without constants are searched after other operands
+  bool hasConstants() const;
+
+  /// Check if formula belongs to templates for generation
+  bool isToGenerate() const;
+
+  /**
+   * @brief Check for each template params if formula has at least one replacement with them. Search with every params
+   * is stopped at the first found replacement
+   * @param templateParamsVector is a vector of params to check formula with
+   * @return vector of flags, i-th flag is true if formula has replacement with i-th params
+   */
+  std::vector<bool> checkReplacementsExistence(std::vector<ScTemplateParams> const & templateParamsVector) const;
+
   // TODO: remove useless method. Use compute instead of search
   LogicFormulaResult search(Replacements & replacements) const;
   void generate(Replacements & replacements, LogicFormulaResult & result) override;
@@ -48,6 +93,12 @@ private:
 
   ScAddr outputStructure;
   ScAddr formula;
+  std::shared_ptr<FormulaMetadata const> metadata;
+  std::shared_ptr<AtomSearchResultsMemo> searchResultsMemo;
+  std::shared_ptr<InferenceBudgetTracker> budgetTracker;
+  bool isNegated = false;
+  bool isOutputStructureSearched = false;
+
   void generateByReplacements(
       Replacements const & replacements,
       LogicFormulaResult & result,
@@ -56,12 +107,24 @@ private:
       Replacements & searchResult,
       Replacements & generatedReplacements);
 
+  void generateByExistenceCheck(
+      Replacements const & replacements,
+      LogicFormulaResult & result,
+      size_t & count,
+      ScAddrUnorderedSet const & formulaVariables,
+      Replacements & searchResult,
+      Replacements & generatedReplacements);
+  std::vector<bool> searchFirstReplacements(
+      TemplateSearcherAbstract const & searcher,
+      std::vector<ScTemplateParams> const & templateParamsVector,
+      Replacements & foundReplacements) const;
+
   void generateByParams(
+      TemplateBatchGenerator & generator,
       ScTemplateParams const & params,
-      ScAddrUnorderedSet const & formulaVariables,
-      Replacements & generatedReplacements,
       LogicFormulaResult & result,
       size_t & count);
+  void finishGeneration(TemplateBatchGenerator & generator, Replacements & generatedReplacements);
   void processTemplateParams(
       std::vector<ScTemplateParams> const & paramsVector,
       ScAddrUnorderedSet const & formulaVariables,
@@ -75,9 +138,10 @@ private:
       Replacements const & replacements,
       Replacements const & resultWithoutReplacements,
       Replacements const & searchResult);
+  void invalidateSearchResults(ScAddrUnorderedSet const & touchedElements);
+  void limitSearchResult(Replacements & replacements) const;
   void addFormulaConstantsToOutputStructure();
   void addToOutputStructure(Replacements const & replacements, ScAddrUnorderedSet const & variables);
   void addToOutputStructure(ScAddrUnorderedSet const & elements);
-  void addToOutputStructure(ScTemplateResultItem const & item);
   void addToOutputStructure(ScAddr const & element);
 };
@@ -6,6 +6,8 @@
 
 #include "DirectInferenceManagerAll.hpp"
 
+#include <algorithm>
+
 #include "inference/inference_keynodes.hpp"
 
 #include "logic/LogicExpressionNode.hpp"
@@ -16,6 +18,14 @@
 
 #include "searcher/template-searcher/TemplateSearcherAbstract.hpp"
 
+#include "logic/AtomSearchResultsMemo.hpp"
+
+#include "inference/thread_pool.hpp"
+
+#include "PremisesPrefetcher.hpp"
+#include "FormulaDependencies.hpp"
+#include "InferenceBudgetTracker.hpp"
+
 using namespace inference;
 
 DirectInferenceManagerAll::DirectInferenceManagerAll(ScMemoryContext * context, utils::ScLogger * logger)
@@ -26,9 +36,15 @@ DirectInferenceManagerAll::DirectInferenceManagerAll(ScMemoryContext * context,
 bool DirectInferenceManagerAll::ApplyInference(InferenceParams const & inferenceParamsConfig)
 {
   bool result = false;
+  // Temporary containers of replacements operations reuse memory during the run
+  ReplacementsUtils::ScratchScope const scratchScope;
 
   templateManager->SetArguments(inferenceParamsConfig.arguments);
+  if (searchResultsMemo)
+    searchResultsMemo->Clear();
   templateSearcher->setInputStructures(inferenceParamsConfig.inputStructures);
+  StartBudgetTracking(inferenceParamsConfig.budget);
+  StartExplain(inferenceParamsConfig.explain);
 
   std::vector<ScAddrQueue> formulasQueuesByPriority =
       CreateFormulasQueuesListByPriority(inferenceParamsConfig.formulasSet);
@@ -37,23 +53,72 @@ bool DirectInferenceManagerAll::ApplyInference(InferenceParams const & inference
     SC_THROW_EXCEPTION(utils::ExceptionItemNotFound, "No formulas sets found.");
   }
 
+  std::unique_ptr<FormulaDependencies> formulaDependencies;
+  if (iterationType == ITERATE_UNTIL_FIXPOINT)
+    formulaDependencies = std::make_unique<FormulaDependencies>(context, logger, templateSearcher);
+
+  std::shared_ptr<ThreadPool> const & prefetchThreadPool = CreatePrefetchThreadPool(inferenceParamsConfig);
+  std::vector<ScAddrQueue> roundFormulasQueues = formulasQueuesByPriority;
+  ScAddrVector generatedFormulas;
+  while (budgetTracker->TryStartRound())
+  {
+    logger->Debug("Start round ", budgetTracker->GetRoundsAmount(), " of formulas applying");
+    generatedFormulas.clear();
+    bool const isStopped =
+        ApplyFormulas(inferenceParamsConfig, roundFormulasQueues, prefetchThreadPool, generatedFormulas);
+    result |= !generatedFormulas.empty();
+    if (isStopped || !formulaDependencies || generatedFormulas.empty())
+      break;
+
+    roundFormulasQueues = SelectTouchedFormulas(formulasQueuesByPriority, generatedFormulas, *formulaDependencies);
+    if (roundFormulasQueues.empty())
+      break;
+  }
+  FinishBudgetTracking();
+  FinishExplain();
+  return result;
+}
+
+/**
+ * @brief Apply formulas of one round
+ * @param formulasQueuesByPriority is a list of formulas queues to apply
+ * @param prefetchThreadPool is a pool to search premises ahead on, premises are not prefetched if it is nullptr
+ * @param generatedFormulas is a list to add formulas that generated something to
+ * @returns true if formulas applying is stopped because budget is exhausted
+ */
+bool DirectInferenceManagerAll::ApplyFormulas(
+    InferenceParams const & inferenceParamsConfig,
+    std::vector<ScAddrQueue> const & formulasQueuesByPriority,
+    std::shared_ptr<ThreadPool> const & prefetchThreadPool,
+    ScAddrVector & generatedFormulas)
+{
+  std::unique_ptr<PremisesPrefetcher> const premisesPrefetcher =
+      CreatePremisesPrefetcher(formulasQueuesByPriority, prefetchThreadPool);
   ScAddrQueue uncheckedFormulas;
   ScAddr formula;
   LogicFormulaResult formulaResult;
   logger->Debug("Start formulas applying. There is ", formulasQueuesByPriority.size(), " formulas sets");
-  for (size_t formulasQueueIndex = 0; formulasQueueIndex < formulasQueuesByPriority.size(); formulasQueueIndex++)
+  bool isStopped = false;
+  for (size_t formulasQueueIndex = 0; formulasQueueIndex < formulasQueuesByPriority.size() && !isStopped;
+       formulasQueueIndex++)
   {
     uncheckedFormulas = formulasQueuesByPriority[formulasQueueIndex];
     logger->Debug("There is ", uncheckedFormulas.size(), " formulas in ", (formulasQueueIndex + 1), " set");
     while (!uncheckedFormulas.empty())
     {
+      isStopped = ShouldStop();
+      if (isStopped)
+        break;
+
       formula = uncheckedFormulas.front();
+      if (premisesPrefetcher)
+        premisesPrefetcher->PrepareNextFormula();
       logger->Debug("Trying to generate by formula: ", context->GetElementSystemIdentifier(formula));
       formulaResult = UseFormula(formula, inferenceParamsConfig.outputStructure);
       logger->Debug("Logical formula is ", (formulaResult.isGenerated ? "generated" : "not generated"));
       if (formulaResult.isGenerated)
       {
-        result = true;
+        generatedFormulas.push_back(formula);
         solutionTreeManager->AddNode(formula, formulaResult.replacements);
       }
 
@@ -61,5 +126,95 @@ bool DirectInferenceManagerAll::ApplyInference(InferenceParams const & inference
     }
   }
   formulaResult.replacements.clear();
-  return result;
+  return isStopped;
+}
+
+/**
+ * @brief Select formulas to reapply in the next round. Premise of formula can become true only if conclusion of
+ * formula generated in the last round touched constants of the premise, e.g. relations or classes. Conclusion with
+ * connector from variable can touch any class or relation, so all formulas are reapplied then. Formulas keep their
+ * priority order
+ * @returns list of formulas queues without empty queues
+ */
+std::vector<ScAddrQueue> DirectInferenceManagerAll::SelectTouchedFormulas(
+    std::vector<ScAddrQueue> const & formulasQueuesByPriority,
+    ScAddrVector const & generatedFormulas,
+    FormulaDependencies & formulaDependencies) const
+{
+  ScAddrUnorderedSet touchedConstants;
+  for (ScAddr const & generatedFormula : generatedFormulas)
+  {
+    if (formulaDependencies.TouchesAll(generatedFormula))
+    {
+      logger->Debug("Conclusion of ", context->GetElementSystemIdentifier(generatedFormula), " can touch all formulas");
+      return formulasQueuesByPriority;
+    }
+    ScAddrUnorderedSet const & conclusionConstants = formulaDependencies.Get(generatedFormula).conclusionConstants;
+    touchedConstants.insert(conclusionConstants.cbegin(), conclusionConstants.cend());
+  }
+
+  std::vector<ScAddrQueue> touchedFormulasQueues;
+  size_t touchedFormulasAmount = 0;
+  for (ScAddrQueue formulasQueue : formulasQueuesByPriority)
+  {
+    ScAddrQueue touchedFormulas;
+    for (; !formulasQueue.empty(); formulasQueue.pop())
+    {
+      if (formulaDependencies.IsTouched(formulasQueue.front(), touchedConstants))
+        touchedFormulas.push(formulasQueue.front());
+    }
+    touchedFormulasAmount += touchedFormulas.size();
+    if (!touchedFormulas.empty())
+      touchedFormulasQueues.push_back(std::move(touchedFormulas));
+  }
+  logger->Debug(touchedFormulasAmount, " formulas have premises touched by the last round");
+  return touchedFormulasQueues;
+}
+
+void DirectInferenceManagerAll::SetIterationType(InferenceIterationType type)
+{
+  iterationType = type;
+}
+
+void DirectInferenceManagerAll::SetFormulasApplicationType(FormulasApplicationType type)
+{
+  formulasApplicationType = type;
+}
+
+/**
+ * @brief Get pool to search premises on if formulas are applied pipelined. Premises are searched with empty template
+ * params, so they are prefetched only for inference without arguments. Search results of premises are passed to
+ * formulas application through search results memo, so memo is required. Pool of manager is used if it is set, else
+ * pool is created once for all rounds of the run
+ * @returns pool or nullptr if formulas are applied sequentially
+ */
+std::shared_ptr<ThreadPool> DirectInferenceManagerAll::CreatePrefetchThreadPool(
+    InferenceParams const & inferenceParamsConfig) const
+{
+  if (formulasApplicationType != APPLY_PIPELINED || !searchResultsMemo || !inferenceParamsConfig.arguments.empty())
+    return nullptr;
+  return threadPool ? threadPool : std::make_shared<ThreadPool>();
+}
+
+/**
+ * @brief Create prefetcher of premises of formulas of one round
+ * @returns prefetcher or nullptr if there is no pool to search premises on
+ */
+std::unique_ptr<PremisesPrefetcher> DirectInferenceManagerAll::CreatePremisesPrefetcher(
+    std::vector<ScAddrQueue> const & formulasQueuesByPriority,
+    std::shared_ptr<ThreadPool> const & prefetchThreadPool)
+{
+  if (!prefetchThreadPool)
+    return nullptr;
+
+  std::vector<ScAddr> formulas;
+  for (ScAddrQueue formulasQueue : formulasQueuesByPriority)
+  {
+    for (; !formulasQueue.empty(); formulasQueue.pop())
+      formulas.push_back(formulasQueue.front());
+  }
+  size_t const lookahead = std::max<size_t>(prefetchThreadPool->GetWorkersAmount(), 1);
+  logger->Debug("Premises of ", formulas.size(), " formulas are searched ahead by ", lookahead, " formulas");
+  return std::make_unique<PremisesPrefetcher>(
+      logger, templateSearcher, searchResultsMemo, prefetchThreadPool, std::move(formulas), lookahead);
 }
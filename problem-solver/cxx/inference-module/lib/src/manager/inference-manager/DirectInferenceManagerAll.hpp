@@ -14,13 +14,16 @@
 
 namespace inference
 {
+class PremisesPrefetcher;
+class FormulaDependencies;
+
 using ScAddrQueue = std::queue<ScAddr>;
 
 /**
  * Inference manager that stops iteration when all formulas were tried to apply.
  * Uses all formulas for all suitable knowledge base constructions.
  * Don't stop at first success applying.
- * Don't reiterate if something was generated.
+ * Reiterates until nothing is generated only if it is iterated until fixpoint.
  */
 class DirectInferenceManagerAll : public InferenceManagerAbstract
 {
@@ -29,7 +32,32 @@ public:
 
   bool ApplyInference(InferenceParams const & inferenceParamsConfig) override;
 
+  /// Set if premises of next formulas are searched on pool workers while formula is applied
+  void SetFormulasApplicationType(FormulasApplicationType type);
+
+  /// Set if formulas are reapplied in rounds until nothing is generated
+  void SetIterationType(InferenceIterationType type);
+
 private:
   utils::ScLogger * logger;
+  FormulasApplicationType formulasApplicationType = APPLY_SEQUENTIALLY;
+  InferenceIterationType iterationType = ITERATE_ONCE;
+
+  bool ApplyFormulas(
+      InferenceParams const & inferenceParamsConfig,
+      std::vector<ScAddrQueue> const & formulasQueuesByPriority,
+      std::shared_ptr<ThreadPool> const & prefetchThreadPool,
+      ScAddrVector & generatedFormulas);
+
+  std::vector<ScAddrQueue> SelectTouchedFormulas(
+      std::vector<ScAddrQueue> const & formulasQueuesByPriority,
+      ScAddrVector const & generatedFormulas,
+      FormulaDependencies & formulaDependencies) const;
+
+  std::shared_ptr<ThreadPool> CreatePrefetchThreadPool(InferenceParams const & inferenceParamsConfig) const;
+
+  std::unique_ptr<PremisesPrefetcher> CreatePremisesPrefetcher(
+      std::vector<ScAddrQueue> const & formulasQueuesByPriority,
+      std::shared_ptr<ThreadPool> const & prefetchThreadPool);
 };
 }  // namespace inference
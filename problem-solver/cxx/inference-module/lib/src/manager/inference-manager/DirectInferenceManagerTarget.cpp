@@ -18,6 +18,8 @@
 
 #include "searcher/template-searcher/TemplateSearcherAbstract.hpp"
 
+#include "logic/AtomSearchResultsMemo.hpp"
+
 using namespace inference;
 
 DirectInferenceManagerTarget::DirectInferenceManagerTarget(ScMemoryContext * context, utils::ScLogger * logger)
@@ -27,15 +29,22 @@ DirectInferenceManagerTarget::DirectInferenceManagerTarget(ScMemoryContext * con
 
 bool DirectInferenceManagerTarget::ApplyInference(InferenceParams const & inferenceParamsConfig)
 {
+  // Temporary containers of replacements operations reuse memory during the run
+  ReplacementsUtils::ScratchScope const scratchScope;
   templateManager->SetArguments(inferenceParamsConfig.arguments);
+  if (searchResultsMemo)
+    searchResultsMemo->Clear();
   templateSearcher->setInputStructures(inferenceParamsConfig.inputStructures);
   setTargetStructure(inferenceParamsConfig.targetStructure);
+  StartBudgetTracking(inferenceParamsConfig.budget);
+  StartExplain(inferenceParamsConfig.explain);
 
   std::vector<ScTemplateParams> const templateParamsVector = templateManager->CreateTemplateParams(targetStructure);
   bool targetAchieved = isTargetAchieved(templateParamsVector);
   if (targetAchieved)
   {
     logger->Debug("Target is already achieved");
+    FinishExplain();
     return false;
   }
 
@@ -57,13 +66,19 @@ bool DirectInferenceManagerTarget::ApplyInference(InferenceParams const & infere
   ScAddr formula;
   LogicFormulaResult formulaResult;
   logger->Debug("Start formulas applying. There is ", formulasQueuesByPriority.size(), " formulas sets");
-  for (size_t formulasQueueIndex = 0; formulasQueueIndex < formulasQueuesByPriority.size() && !targetAchieved;
+  bool isStopped = false;
+  for (size_t formulasQueueIndex = 0;
+       formulasQueueIndex < formulasQueuesByPriority.size() && !targetAchieved && !isStopped;
        formulasQueueIndex++)
   {
     uncheckedFormulas = formulasQueuesByPriority[formulasQueueIndex];
     logger->Debug("There is ", uncheckedFormulas.size(), " formulas in ", (formulasQueueIndex + 1), " set");
     while (!uncheckedFormulas.empty())
     {
+      isStopped = ShouldStop();
+      if (isStopped)
+        break;
+
       formula = uncheckedFormulas.front();
       logger->Debug("Trying to generate by formula: ", context->GetElementSystemIdentifier(formula));
       formulaResult = UseFormula(formula, inferenceParamsConfig.outputStructure);
@@ -96,6 +111,8 @@ bool DirectInferenceManagerTarget::ApplyInference(InferenceParams const & infere
     }
   }
 
+  FinishBudgetTracking();
+  FinishExplain();
   return targetAchieved;
 }
 
@@ -0,0 +1,144 @@
+/*
+ * This source file is part of an OSTIS project. For the latest info, see http://ostis.net
+ * Distributed under the MIT License
+ * (See accompanying file COPYING.MIT or copy at http://opensource.org/licenses/MIT)
+ */
+
+#include "FormulaDependencies.hpp"
+
+#include <algorithm>
+
+#include <sc-agents-common/utils/IteratorUtils.hpp>
+
+#include "inference/inference_keynodes.hpp"
+
+#include "classifier/FormulaClassifier.hpp"
+
+namespace inference
+{
+FormulaDependencies::FormulaDependencies(
+    ScMemoryContext * context,
+    utils::ScLogger * logger,
+    std::shared_ptr<TemplateSearcherAbstract> templateSearcher)
+  : context(context)
+  , logger(logger)
+  , templateSearcher(std::move(templateSearcher))
+{
+}
+
+FormulaDependency const & FormulaDependencies::Get(ScAddr const & formula)
+{
+  auto const & dependencyIterator = dependencies.find(formula);
+  if (dependencyIterator != dependencies.cend())
+    return dependencyIterator->second;
+
+  FormulaDependency & dependency = dependencies[formula];
+  ScAddr const & formulaRoot =
+      utils::IteratorUtils::getAnyByOutRelation(context, formula, ScKeynodes::rrel_main_key_sc_element);
+  if (!formulaRoot.IsValid())
+    return dependency;
+
+  ScAddr premise = formulaRoot;
+  ScAddr conclusion = formulaRoot;
+  int const formulaType = templateSearcher->getFormulaMetadataCache()->GetFormulaClass(context, logger, formulaRoot);
+  if (formulaType == FormulaClassifier::IMPLICATION_ARC)
+  {
+    auto const & [begin, end] = context->GetConnectorIncidentElements(formulaRoot);
+    premise = begin;
+    conclusion = end;
+  }
+  else if (formulaType == FormulaClassifier::IMPLICATION_TUPLE)
+  {
+    premise = utils::IteratorUtils::getAnyByOutRelation(context, formulaRoot, InferenceKeynodes::rrel_if);
+    conclusion = utils::IteratorUtils::getAnyByOutRelation(context, formulaRoot, InferenceKeynodes::rrel_then);
+  }
+
+  ScAddrVector premiseAtoms;
+  CollectAtoms(premise, premiseAtoms);
+  for (ScAddr const & atom : premiseAtoms)
+  {
+    ScAddrUnorderedSet const & constants = templateSearcher->getFormulaMetadata(atom)->constants;
+    dependency.premiseConstants.insert(constants.cbegin(), constants.cend());
+    dependency.hasPremiseAtomWithoutConstants |= constants.empty();
+  }
+  ScAddrVector conclusionAtoms;
+  CollectAtoms(conclusion, conclusionAtoms);
+  for (ScAddr const & atom : conclusionAtoms)
+  {
+    ScAddrUnorderedSet const & constants = templateSearcher->getFormulaMetadata(atom)->constants;
+    dependency.conclusionConstants.insert(constants.cbegin(), constants.cend());
+    dependency.hasConclusionConnectorFromVariable |= HasConnectorFromVariable(atom);
+  }
+  return dependency;
+}
+
+bool FormulaDependencies::IsTouched(ScAddr const & formula, ScAddrUnorderedSet const & touchedConstants)
+{
+  FormulaDependency const & dependency = Get(formula);
+  return dependency.hasPremiseAtomWithoutConstants ||
+         std::any_of(
+             dependency.premiseConstants.cbegin(),
+             dependency.premiseConstants.cend(),
+             [&touchedConstants](ScAddr const & constant) {
+               return touchedConstants.count(constant);
+             });
+}
+
+bool FormulaDependencies::TouchesAll(ScAddr const & formula)
+{
+  return Get(formula).hasConclusionConnectorFromVariable;
+}
+
+void FormulaDependencies::CollectAtoms(ScAddr const & formula, ScAddrVector & atoms) const
+{
+  if (!formula.IsValid())
+    return;
+  switch (templateSearcher->getFormulaMetadataCache()->GetFormulaClass(context, logger, formula))
+  {
+  case FormulaClassifier::ATOMIC:
+    atoms.push_back(formula);
+    break;
+  case FormulaClassifier::CONJUNCTION:
+  case FormulaClassifier::DISJUNCTION:
+  case FormulaClassifier::NEGATION:
+  case FormulaClassifier::EQUIVALENCE_TUPLE:
+  {
+    ScIterator3Ptr const & operandsIterator =
+        context->CreateIterator3(formula, ScType::ConstPermPosArc, ScType::Unknown);
+    while (operandsIterator->Next())
+      CollectAtoms(operandsIterator->Get(2), atoms);
+    break;
+  }
+  case FormulaClassifier::IMPLICATION_ARC:
+  case FormulaClassifier::EQUIVALENCE_EDGE:
+  {
+    auto const & [begin, end] = context->GetConnectorIncidentElements(formula);
+    CollectAtoms(begin, atoms);
+    CollectAtoms(end, atoms);
+    break;
+  }
+  case FormulaClassifier::IMPLICATION_TUPLE:
+    CollectAtoms(utils::IteratorUtils::getAnyByOutRelation(context, formula, InferenceKeynodes::rrel_if), atoms);
+    CollectAtoms(utils::IteratorUtils::getAnyByOutRelation(context, formula, InferenceKeynodes::rrel_then), atoms);
+    break;
+  default:
+    break;
+  }
+}
+
+bool FormulaDependencies::HasConnectorFromVariable(ScAddr const & atom) const
+{
+  ScIterator3Ptr const & elementsIterator = context->CreateIterator3(atom, ScType::ConstPermPosArc, ScType::Unknown);
+  while (elementsIterator->Next())
+  {
+    ScAddr const & element = elementsIterator->Get(2);
+    if (!context->GetElementType(element).IsConnector())
+      continue;
+    auto const & [source, target] = context->GetConnectorIncidentElements(element);
+    if (context->GetElementType(source).IsVar())
+      return true;
+  }
+  return false;
+}
+
+}  // namespace inference
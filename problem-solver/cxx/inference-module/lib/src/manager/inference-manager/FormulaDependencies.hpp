@@ -0,0 +1,66 @@
+/*
+ * This source file is part of an OSTIS project. For the latest info, see http://ostis.net
+ * Distributed under the MIT License
+ * (See accompanying file COPYING.MIT or copy at http://opensource.org/licenses/MIT)
+ */
+
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+
+#include <sc-memory/sc_memory.hpp>
+
+#include "inference/types.hpp"
+
+#include "searcher/template-searcher/TemplateSearcherAbstract.hpp"
+
+namespace inference
+{
+/// Constants of premise and conclusion of logical formula
+struct FormulaDependency
+{
+  ScAddrUnorderedSet premiseConstants;
+  /// Premise has atomic logical formula without constants, it can become true after any generation
+  bool hasPremiseAtomWithoutConstants = false;
+  ScAddrUnorderedSet conclusionConstants;
+  /**
+   * Conclusion has connector from variable, e.g. `_c _-> _x` or `_x _=> _r: _y`. Classes and relations touched by its
+   * generation are not known, so it can make any premise true
+   */
+  bool hasConclusionConnectorFromVariable = false;
+};
+
+/**
+ * Finds which formulas can become applicable after generations. Premise of implication depends on constants of its
+ * atomic logical formulas, conclusion touches constants of its atomic logical formulas. Whole formula is considered
+ * as premise and conclusion if it is not an implication. Dependencies are computed once for every formula
+ */
+class FormulaDependencies
+{
+public:
+  FormulaDependencies(
+      ScMemoryContext * context,
+      utils::ScLogger * logger,
+      std::shared_ptr<TemplateSearcherAbstract> templateSearcher);
+
+  FormulaDependency const & Get(ScAddr const & formula);
+
+  /// Check if premise of formula can become true after generations touched the constants
+  bool IsTouched(ScAddr const & formula, ScAddrUnorderedSet const & touchedConstants);
+
+  /// Check if generation by formula can touch any constants
+  bool TouchesAll(ScAddr const & formula);
+
+private:
+  ScMemoryContext * context;
+  utils::ScLogger * logger;
+  std::shared_ptr<TemplateSearcherAbstract> templateSearcher;
+  std::unordered_map<ScAddr, FormulaDependency, ScAddrHashFunc> dependencies;
+
+  void CollectAtoms(ScAddr const & formula, ScAddrVector & atoms) const;
+
+  bool HasConnectorFromVariable(ScAddr const & atom) const;
+};
+
+}  // namespace inference
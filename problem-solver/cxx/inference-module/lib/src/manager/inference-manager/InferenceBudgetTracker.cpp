@@ -0,0 +1,135 @@
+/*
+ * This source file is part of an OSTIS project. For the latest info, see http://ostis.net
+ * Distributed under the MIT License
+ * (See accompanying file COPYING.MIT or copy at http://opensource.org/licenses/MIT)
+ */
+
+#include "InferenceBudgetTracker.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include "inference/replacements_utils.hpp"
+
+namespace inference
+{
+InferenceBudgetTracker::InferenceBudgetTracker(
+    InferenceBudget const & budget,
+    std::shared_ptr<CancellationToken const> cancellationToken)
+  : budget(budget)
+  , deadline(std::chrono::steady_clock::now() + budget.timeLimit)
+  , cancellationToken(std::move(cancellationToken))
+{
+}
+
+bool InferenceBudgetTracker::IsExhausted()
+{
+  return isExhausted || IsInterrupted();
+}
+
+bool InferenceBudgetTracker::HasBeenExhausted() const
+{
+  return isExhausted;
+}
+
+bool InferenceBudgetTracker::LimitReplacements(Replacements & replacements, bool isNegated)
+{
+  if (replacements.empty() || (budget.maxReplacementsColumns == 0 && budget.maxReplacementsMemory == 0))
+    return true;
+
+  size_t allowedColumnsAmount = std::numeric_limits<size_t>::max();
+  if (budget.maxReplacementsColumns > 0)
+    allowedColumnsAmount = budget.maxReplacementsColumns;
+  if (budget.maxReplacementsMemory > 0)
+    allowedColumnsAmount =
+        std::min(allowedColumnsAmount, budget.maxReplacementsMemory / (replacements.size() * sizeof(ScAddr)));
+
+  if (ReplacementsUtils::GetColumnsAmount(replacements) <= allowedColumnsAmount)
+    return true;
+
+  if (isNegated)
+  {
+    isGenerationBlocked = true;
+    Exhaust("replacements under negation exceed limit of " + std::to_string(allowedColumnsAmount) + " columns");
+    return false;
+  }
+  for (auto & [variable, values] : replacements)
+  {
+    values.resize(allowedColumnsAmount);
+    values.shrink_to_fit();
+  }
+  Exhaust("replacements are limited to " + std::to_string(allowedColumnsAmount) + " columns");
+  return false;
+}
+
+bool InferenceBudgetTracker::TryGenerate()
+{
+  if (isGenerationBlocked || IsInterrupted())
+    return false;
+  if (budget.maxGeneratedConstructions == 0)
+  {
+    ++generatedConstructionsAmount;
+    return true;
+  }
+
+  size_t amount = generatedConstructionsAmount;
+  while (amount < budget.maxGeneratedConstructions)
+  {
+    if (generatedConstructionsAmount.compare_exchange_weak(amount, amount + 1))
+      return true;
+  }
+  Exhaust("generated constructions limit of " + std::to_string(budget.maxGeneratedConstructions) + " is reached");
+  return false;
+}
+
+size_t InferenceBudgetTracker::GetGeneratedConstructionsAmount() const
+{
+  return generatedConstructionsAmount;
+}
+
+bool InferenceBudgetTracker::TryStartRound()
+{
+  if (budget.maxRounds > 0 && roundsAmount >= budget.maxRounds)
+  {
+    Exhaust("rounds limit of " + std::to_string(budget.maxRounds) + " is reached");
+    return false;
+  }
+  ++roundsAmount;
+  return true;
+}
+
+size_t InferenceBudgetTracker::GetRoundsAmount() const
+{
+  return roundsAmount;
+}
+
+std::string InferenceBudgetTracker::GetExhaustionReason() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return exhaustionReason;
+}
+
+bool InferenceBudgetTracker::IsInterrupted()
+{
+  if (cancellationToken && cancellationToken->IsCancelled())
+  {
+    Exhaust("inference is cancelled");
+    return true;
+  }
+  if (budget.timeLimit == std::chrono::milliseconds::zero() || std::chrono::steady_clock::now() < deadline)
+    return false;
+  Exhaust("time limit of " + std::to_string(budget.timeLimit.count()) + " ms is reached");
+  return true;
+}
+
+void InferenceBudgetTracker::Exhaust(std::string const & reason)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  if (isExhausted)
+    return;
+  exhaustionReason = reason;
+  isExhausted = true;
+}
+
+}  // namespace inference
@@ -0,0 +1,79 @@
+/*
+ * This source file is part of an OSTIS project. For the latest info, see http://ostis.net
+ * Distributed under the MIT License
+ * (See accompanying file COPYING.MIT or copy at http://opensource.org/licenses/MIT)
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+
+#include "inference/inference_config.hpp"
+#include "inference/inference_cancellation.hpp"
+#include "inference/types.hpp"
+
+namespace inference
+{
+/**
+ * Resources spent by one inference run. When any limit of budget is reached or inference is cancelled, budget is
+ * exhausted: inference stops applying formulas and its solution is marked as partial
+ */
+class InferenceBudgetTracker
+{
+public:
+  explicit InferenceBudgetTracker(
+      InferenceBudget const & budget,
+      std::shared_ptr<CancellationToken const> cancellationToken = nullptr);
+
+  /// Check if budget is exhausted, time limit and cancellation are checked on every call
+  bool IsExhausted();
+
+  /// Check if budget was exhausted by previous checks, time limit is not checked
+  bool HasBeenExhausted() const;
+
+  /**
+   * @brief Remove last columns of replacements that exceed columns and memory limits, budget is exhausted if any
+   * column is removed
+   * @param isNegated is true if replacements are computed under negation. They are subtracted from other replacements,
+   * so removed columns would keep bindings that should be excluded. Such replacements are not changed, but budget is
+   * exhausted and generation is blocked
+   * @return true if replacements do not exceed limits
+   */
+  bool LimitReplacements(Replacements & replacements, bool isNegated = false);
+
+  /**
+   * Count construction to generate, returns false without counting if generated constructions or time limit is reached,
+   * inference is cancelled or replacements under negation exceeded limits.
+   * Constructions may be generated after other replacements are limited, so that partial result contains them
+   */
+  bool TryGenerate();
+
+  size_t GetGeneratedConstructionsAmount() const;
+
+  /// Count round of formulas applying, returns false and exhausts budget if rounds limit is reached
+  bool TryStartRound();
+
+  size_t GetRoundsAmount() const;
+
+  std::string GetExhaustionReason() const;
+
+private:
+  bool IsInterrupted();
+
+  void Exhaust(std::string const & reason);
+
+  InferenceBudget const budget;
+  std::chrono::steady_clock::time_point const deadline;
+  std::shared_ptr<CancellationToken const> const cancellationToken;
+  std::atomic<size_t> generatedConstructionsAmount{0};
+  std::atomic<size_t> roundsAmount{0};
+  std::atomic<bool> isExhausted{false};
+  std::atomic<bool> isGenerationBlocked{false};
+  mutable std::mutex mutex;
+  std::string exhaustionReason;
+};
+
+}  // namespace inference
@@ -6,18 +6,51 @@
 
 #include "inference/inference_manager_abstract.hpp"
 
+#include <fstream>
+#include <map>
+#include <string>
 #include <utility>
 
 #include <sc-agents-common/utils/IteratorUtils.hpp>
 
+#include <sc-memory-profiler/sc_memory_profiler.hpp>
+
 #include "inference/containers_utils.hpp"
+#include "inference/replacements_utils.hpp"
+#include "inference/thread_pool.hpp"
 
 #include "manager/template-manager/TemplateManagerFixedArguments.hpp"
+#include "manager/inference-manager/InferenceBudgetTracker.hpp"
 
 #include "logic/LogicExpression.hpp"
+#include "logic/ExplainTrace.hpp"
 
+using utils::ScMemoryProfiler;
 using namespace inference;
 
+namespace
+{
+std::string const ROLE_RELATION_NUMBER_PREFIX = "rrel_";
+
+/// Get number of role relation like rrel_1, rrel_2 etc., returns 0 for other role relations
+size_t GetRoleRelationNumber(std::string const & roleRelationIdentifier)
+{
+  if (roleRelationIdentifier.size() <= ROLE_RELATION_NUMBER_PREFIX.size() ||
+      roleRelationIdentifier.compare(0, ROLE_RELATION_NUMBER_PREFIX.size(), ROLE_RELATION_NUMBER_PREFIX) != 0)
+    return 0;
+
+  size_t number = 0;
+  for (size_t i = ROLE_RELATION_NUMBER_PREFIX.size(); i < roleRelationIdentifier.size(); ++i)
+  {
+    char const digit = roleRelationIdentifier[i];
+    if (digit < '0' || digit > '9')
+      return 0;
+    number = number * 10 + (digit - '0');
+  }
+  return number;
+}
+}  // namespace
+
 InferenceManagerAbstract::InferenceManagerAbstract(ScMemoryContext * context, utils::ScLogger * logger)
   : context(context), logger(logger)
 {
@@ -38,6 +71,104 @@ void InferenceManagerAbstract::SetSolutionTreeManager(std::shared_ptr<SolutionTr
   solutionTreeManager = std::move(manager);
 }
 
+void InferenceManagerAbstract::SetThreadPool(std::shared_ptr<ThreadPool> pool)
+{
+  threadPool = std::move(pool);
+}
+
+void InferenceManagerAbstract::SetSearchResultsMemo(std::shared_ptr<AtomSearchResultsMemo> memo)
+{
+  searchResultsMemo = std::move(memo);
+}
+
+void InferenceManagerAbstract::SetFormulaMetadataCache(std::shared_ptr<FormulaMetadataCache> const & cache)
+{
+  if (templateSearcher)
+    templateSearcher->setFormulaMetadataCache(cache);
+  if (templateManager)
+    templateManager->SetFormulaMetadataCache(cache);
+}
+
+void InferenceManagerAbstract::SetCancellationToken(std::shared_ptr<CancellationToken const> token)
+{
+  cancellationToken = std::move(token);
+}
+
+bool InferenceManagerAbstract::IsBudgetExhausted() const
+{
+  return budgetTracker && budgetTracker->HasBeenExhausted();
+}
+
+size_t InferenceManagerAbstract::GetRoundsAmount() const
+{
+  return budgetTracker ? budgetTracker->GetRoundsAmount() : 0;
+}
+
+std::shared_ptr<ExplainTrace const> InferenceManagerAbstract::GetExplainTrace() const
+{
+  return explainTrace;
+}
+
+std::shared_ptr<ScMemoryProfiler const> InferenceManagerAbstract::GetMemoryProfiler() const
+{
+  return memoryProfiler;
+}
+
+void InferenceManagerAbstract::StartBudgetTracking(InferenceBudget const & budget)
+{
+  budgetTracker = std::make_shared<InferenceBudgetTracker>(budget, cancellationToken);
+  templateSearcher->setCancellationToken(cancellationToken);
+  solutionTreeManager->SetSolutionPartial(false);
+}
+
+bool InferenceManagerAbstract::ShouldStop()
+{
+  if (!budgetTracker || !budgetTracker->IsExhausted())
+    return false;
+  logger->Warning("Inference is stopped, budget is exhausted: ", budgetTracker->GetExhaustionReason());
+  return true;
+}
+
+void InferenceManagerAbstract::FinishBudgetTracking()
+{
+  solutionTreeManager->SetSolutionPartial(IsBudgetExhausted());
+}
+
+void InferenceManagerAbstract::StartExplain(InferenceExplainParams const & params)
+{
+  explainParams = params;
+  explainTrace.reset();
+  solutionTreeManager->SetSolutionTrace(ScAddr::Empty);
+  if (!explainParams.traceFilePath.empty() || explainParams.generateTraceStructure)
+    explainTrace = std::make_shared<ExplainTrace>(context);
+  memoryProfiler.reset();
+  if (!explainParams.memoryProfileFilePath.empty() || explainParams.profileMemoryCalls)
+    memoryProfiler = std::make_shared<ScMemoryProfiler>();
+}
+
+void InferenceManagerAbstract::FinishExplain()
+{
+  if (memoryProfiler && !explainParams.memoryProfileFilePath.empty())
+  {
+    std::ofstream profileFile(explainParams.memoryProfileFilePath);
+    profileFile << memoryProfiler->ToChromeTrace(context);
+    if (!profileFile)
+      logger->Warning("Memory profile is not written to ", explainParams.memoryProfileFilePath);
+  }
+  if (!explainTrace)
+    return;
+
+  if (!explainParams.traceFilePath.empty())
+  {
+    std::ofstream traceFile(explainParams.traceFilePath);
+    traceFile << explainTrace->ToJson();
+    if (!traceFile)
+      logger->Warning("Explain trace is not written to ", explainParams.traceFilePath);
+  }
+  if (explainParams.generateTraceStructure)
+    solutionTreeManager->SetSolutionTrace(explainTrace->GenerateStructure());
+}
+
 std::shared_ptr<SolutionTreeManagerAbstract> InferenceManagerAbstract::GetSolutionTreeManager()
 {
   return solutionTreeManager;
@@ -81,11 +212,14 @@ LogicFormulaResult InferenceManagerAbstract::UseFormula(ScAddr const & formula,
     return {false, false, {}};
   }
 
+  ExplainTrace::Scope explainScope(explainTrace, "formula", formula);
+  ScMemoryProfiler::Activation const profilerActivation(memoryProfiler.get(), formula);
   // Choose template manager according to the formula specification (if fixed arguments exist)
-  ScAddr const & firstFixedArgument = utils::IteratorUtils::getAnyByOutRelation(context, formula, ScKeynodes::rrel_1);
-  if (firstFixedArgument.IsValid())
+  ScAddrVector const & fixedArguments = GetFormulaFixedArguments(formula);
+  if (!fixedArguments.empty())
   {
-    FormTemplateManagerFixedArguments(formula, firstFixedArgument);
+    explainScope.SetStrategy("fixed arguments");
+    FormTemplateManagerFixedArguments(fixedArguments);
   }
   else
   {
@@ -93,6 +227,10 @@ LogicFormulaResult InferenceManagerAbstract::UseFormula(ScAddr const & formula,
   }
 
   LogicExpression logicExpression(context, logger, templateSearcher, templateManager, solutionTreeManager, outputStructure);
+  logicExpression.setThreadPool(threadPool);
+  logicExpression.setSearchResultsMemo(searchResultsMemo);
+  logicExpression.setBudgetTracker(budgetTracker);
+  logicExpression.setExplainTrace(explainTrace);
 
   std::shared_ptr<LogicExpressionNode> expressionRoot = logicExpression.build(formulaRoot);
   expressionRoot->setArgumentVector(templateManager->GetArguments());
@@ -100,40 +238,41 @@ LogicFormulaResult InferenceManagerAbstract::UseFormula(ScAddr const & formula,
 
   LogicFormulaResult formulaResult;
   expressionRoot->compute(formulaResult);
+  explainScope.SetParamsAmount(templateManager->GetArguments().size());
+  explainScope.SetRowsAmount(ReplacementsUtils::GetColumnsAmount(formulaResult.replacements));
 
   return formulaResult;
 }
 
-/// Form formula fixed arguments from rrel_1, rrel_2 etc. to create template params. Used only in
-/// 'TemplateManagerFixedArguments'
-void InferenceManagerAbstract::FillFormulaFixedArgumentsIdentifiers(
-    ScAddr const & formula,
-    ScAddr const & firstFixedArgument) const
+/// Role relations of formula arcs are recognized by system identifiers, so that fixed arguments count is not limited
+/// and rrel_N is not resolved for every number. Used only in 'TemplateManagerFixedArguments'
+ScAddrVector InferenceManagerAbstract::GetFormulaFixedArguments(ScAddr const & formula) const
 {
-  templateManager->AddFixedArgument(firstFixedArgument);
+  std::map<size_t, ScAddr> fixedArgumentsByNumbers;
+  ScIterator5Ptr const & fixedArgumentsIterator = context->CreateIterator5(
+      formula, ScType::ConstPermPosArc, ScType::Unknown, ScType::ConstPermPosArc, ScType::ConstNode);
+  while (fixedArgumentsIterator->Next())
+  {
+    size_t const number = GetRoleRelationNumber(context->GetElementSystemIdentifier(fixedArgumentsIterator->Get(4)));
+    if (number != 0)
+      fixedArgumentsByNumbers.emplace(number, fixedArgumentsIterator->Get(2));
+  }
 
-  // TODO(MksmOrlov): make nrel_basic_sequence oriented set processing
-  size_t const maxFixedArgumentsCount = 10;
-  ScAddr currentFixedArgument;
-  ScAddr currentRoleRelation;
-  for (size_t i = 2; i <= maxFixedArgumentsCount; i++)
+  ScAddrVector fixedArguments;
+  fixedArguments.reserve(fixedArgumentsByNumbers.size());
+  for (auto const & [number, fixedArgument] : fixedArgumentsByNumbers)
   {
-    currentRoleRelation = utils::IteratorUtils::getRoleRelation(context, i);
-    currentFixedArgument = utils::IteratorUtils::getAnyByOutRelation(context, formula, currentRoleRelation);
-    if (!currentFixedArgument.IsValid())
-    {
+    if (number != fixedArguments.size() + 1)
       break;
-    }
-    templateManager->AddFixedArgument(currentFixedArgument);
+    fixedArguments.push_back(fixedArgument);
   }
+  return fixedArguments;
 }
 
-void InferenceManagerAbstract::FormTemplateManagerFixedArguments(
-    ScAddr const & formula,
-    ScAddr const & firstFixedArgument)
+void InferenceManagerAbstract::FormTemplateManagerFixedArguments(ScAddrVector const & fixedArguments)
 {
   ResetTemplateManager(std::make_shared<TemplateManagerFixedArguments>(context));
-  FillFormulaFixedArgumentsIdentifiers(formula, firstFixedArgument);
+  templateManager->SetFixedArguments(fixedArguments);
 }
 
 void InferenceManagerAbstract::ResetTemplateManager(std::shared_ptr<TemplateManagerAbstract> otherTemplateManager)
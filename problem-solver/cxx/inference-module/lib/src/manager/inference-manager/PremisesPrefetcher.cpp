@@ -0,0 +1,118 @@
+/*
+ * This source file is part of an OSTIS project. For the latest info, see http://ostis.net
+ * Distributed under the MIT License
+ * (See accompanying file COPYING.MIT or copy at http://opensource.org/licenses/MIT)
+ */
+
+#include "PremisesPrefetcher.hpp"
+
+#include <optional>
+
+#include <sc-agents-common/utils/IteratorUtils.hpp>
+
+#include "inference/inference_keynodes.hpp"
+
+#include "classifier/FormulaClassifier.hpp"
+
+namespace inference
+{
+PremisesPrefetcher::PremisesPrefetcher(
+    utils::ScLogger * logger,
+    std::shared_ptr<TemplateSearcherAbstract> templateSearcher,
+    std::shared_ptr<AtomSearchResultsMemo> searchResultsMemo,
+    std::shared_ptr<ThreadPool> threadPool,
+    std::vector<ScAddr> formulas,
+    size_t lookahead)
+  : logger(logger)
+  , templateSearcher(std::move(templateSearcher))
+  , searchResultsMemo(std::move(searchResultsMemo))
+  , threadPool(std::move(threadPool))
+  , formulas(std::move(formulas))
+  , lookahead(lookahead)
+{
+}
+
+PremisesPrefetcher::~PremisesPrefetcher()
+{
+  // Searches use memo and searcher of inference run, so they are finished before run ends
+  for (std::future<void> & search : searches)
+    threadPool->Await(search);
+}
+
+void PremisesPrefetcher::PrepareNextFormula()
+{
+  size_t const formulaIndex = preparedFormulasAmount++;
+  size_t const submittedFormulasAmount = formulaIndex + searches.size();
+  for (size_t index = submittedFormulasAmount; index < formulas.size() && index <= formulaIndex + lookahead; ++index)
+  {
+    // Template params are empty, because premises are prefetched only for inference without arguments
+    searches.push_back(threadPool->Submit(
+        [logger = logger,
+         pool = threadPool.get(),
+         searcher = templateSearcher,
+         memo = searchResultsMemo,
+         formula = formulas[index]]() {
+          // Searches are awaited by prefetcher destructor, so pool outlives them
+          std::optional<ScMemoryContext> ownContext;
+          ScMemoryContext * taskContext = pool->GetWorkerContext();
+          if (!taskContext)
+            taskContext = &ownContext.emplace();
+          try
+          {
+            std::unique_ptr<TemplateSearcherAbstract> const taskSearcher = searcher->clone(taskContext);
+            ScAddr const & premise =
+                GetAtomicPremise(taskContext, logger, *taskSearcher->getFormulaMetadataCache(), formula);
+            if (!premise.IsValid())
+              return;
+            std::shared_ptr<FormulaMetadata const> const & metadata = taskSearcher->getFormulaMetadata(premise);
+            std::vector<ScTemplateParams> const templateParamsVector = {ScTemplateParams()};
+            // Result is added only if no generation made while premise is searched touches it
+            AtomSearchResultsMemo::InFlightSearch const inFlightSearch(*memo);
+            Replacements replacements;
+            taskSearcher->searchTemplate(premise, templateParamsVector.front(), metadata->variablesSet, replacements);
+            if (!taskSearcher->isCancelled())
+              memo->Add(
+                  *metadata,
+                  templateParamsVector,
+                  taskSearcher->getInputStructures(),
+                  replacements,
+                  inFlightSearch.GetVersion());
+          }
+          catch (utils::ScException const & exception)
+          {
+            // Premise is searched again when formula is applied
+            logger->Warning("Premise of formula ", formula.Hash(), " is not prefetched: ", exception.Message());
+          }
+        }));
+  }
+  if (!searches.empty())
+  {
+    threadPool->Await(searches.front());
+    searches.pop_front();
+  }
+}
+
+ScAddr PremisesPrefetcher::GetAtomicPremise(
+    ScMemoryContext * context,
+    utils::ScLogger * logger,
+    FormulaMetadataCache & metadataCache,
+    ScAddr const & formula)
+{
+  ScAddr const & formulaRoot =
+      utils::IteratorUtils::getAnyByOutRelation(context, formula, ScKeynodes::rrel_main_key_sc_element);
+  if (!formulaRoot.IsValid())
+    return ScAddr::Empty;
+
+  ScAddr premise;
+  int const formulaType = metadataCache.GetFormulaClass(context, logger, formulaRoot);
+  if (formulaType == FormulaClassifier::IMPLICATION_ARC)
+    premise = std::get<0>(context->GetConnectorIncidentElements(formulaRoot));
+  else if (formulaType == FormulaClassifier::IMPLICATION_TUPLE)
+    premise = utils::IteratorUtils::getAnyByOutRelation(context, formulaRoot, InferenceKeynodes::rrel_if);
+
+  if (!premise.IsValid() || metadataCache.GetFormulaClass(context, logger, premise) != FormulaClassifier::ATOMIC)
+    return ScAddr::Empty;
+  return premise;
+}
+
+}  // namespace inference
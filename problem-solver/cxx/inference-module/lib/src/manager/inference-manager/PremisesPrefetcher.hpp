@@ -0,0 +1,71 @@
+/*
+ * This source file is part of an OSTIS project. For the latest info, see http://ostis.net
+ * Distributed under the MIT License
+ * (See accompanying file COPYING.MIT or copy at http://opensource.org/licenses/MIT)
+ */
+
+#pragma once
+
+#include <deque>
+#include <future>
+#include <memory>
+#include <vector>
+
+#include <sc-memory/sc_memory.hpp>
+
+#include "inference/thread_pool.hpp"
+
+#include "logic/AtomSearchResultsMemo.hpp"
+
+#include "searcher/template-searcher/TemplateSearcherAbstract.hpp"
+
+namespace inference
+{
+/**
+ * Searches atomic premises of implications that will be applied next while the current formula is applied. Searches
+ * are performed by pool workers with their own sc-memory contexts, results are added to search results memo and used
+ * when formula is applied. Results of premises that are touched by generations made during search are not added, so
+ * they are searched again by formula application
+ */
+class PremisesPrefetcher
+{
+public:
+  /**
+   * @param formulas are formulas in the order of their application
+   * @param lookahead is an amount of formulas which premises are searched ahead of the applied formula
+   */
+  PremisesPrefetcher(
+      utils::ScLogger * logger,
+      std::shared_ptr<TemplateSearcherAbstract> templateSearcher,
+      std::shared_ptr<AtomSearchResultsMemo> searchResultsMemo,
+      std::shared_ptr<ThreadPool> threadPool,
+      std::vector<ScAddr> formulas,
+      size_t lookahead);
+
+  ~PremisesPrefetcher();
+
+  PremisesPrefetcher(PremisesPrefetcher const & other) = delete;
+
+  PremisesPrefetcher & operator=(PremisesPrefetcher const & other) = delete;
+
+  /// Start searches of premises of next formulas and wait for search of premise of the formula to apply
+  void PrepareNextFormula();
+
+private:
+  utils::ScLogger * logger;
+  std::shared_ptr<TemplateSearcherAbstract> templateSearcher;
+  std::shared_ptr<AtomSearchResultsMemo> searchResultsMemo;
+  std::shared_ptr<ThreadPool> threadPool;
+  std::vector<ScAddr> formulas;
+  size_t lookahead;
+  size_t preparedFormulasAmount = 0;
+  std::deque<std::future<void>> searches;
+
+  static ScAddr GetAtomicPremise(
+      ScMemoryContext * context,
+      utils::ScLogger * logger,
+      FormulaMetadataCache & metadataCache,
+      ScAddr const & formula);
+};
+
+}  // namespace inference
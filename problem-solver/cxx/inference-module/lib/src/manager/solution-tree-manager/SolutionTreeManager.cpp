@@ -21,11 +21,18 @@ bool SolutionTreeManager::AddNode(ScAddr const & formula, Replacements const & r
 {
   std::vector<ScTemplateParams> templateParamsVector;
   ReplacementsUtils::GetReplacementsToScTemplateParams(replacements, templateParamsVector);
-  ScAddrUnorderedSet variables;
-  ReplacementsUtils::GetKeySet(replacements, variables);
   bool result = true;
-  for (ScTemplateParams const & templateParams : templateParamsVector)
-    result &= solutionTreeGenerator->AddNode(formula, templateParams, variables);
+  for (size_t columnIndex = 0; columnIndex < templateParamsVector.size(); ++columnIndex)
+  {
+    // Padding of united replacements is not a replacement, so only variables bound in the column are added
+    ScAddrUnorderedSet boundVariables;
+    for (auto const & [variable, values] : replacements)
+    {
+      if (values[columnIndex].IsValid())
+        boundVariables.insert(variable);
+    }
+    result &= solutionTreeGenerator->AddNode(formula, templateParamsVector[columnIndex], boundVariables);
+  }
   return result;
 }
 
@@ -21,7 +21,17 @@ SolutionTreeManagerAbstract::~SolutionTreeManagerAbstract() = default;
 
 ScAddr SolutionTreeManagerAbstract::GenerateSolution(ScAddr const & outputStructure, bool targetAchieved)
 {
-  return solutionTreeGenerator->GenerateSolution(outputStructure, targetAchieved);
+  return solutionTreeGenerator->GenerateSolution(outputStructure, targetAchieved, isSolutionPartial, solutionTrace);
+}
+
+void SolutionTreeManagerAbstract::SetSolutionPartial(bool isPartial)
+{
+  isSolutionPartial = isPartial;
+}
+
+void SolutionTreeManagerAbstract::SetSolutionTrace(ScAddr const & trace)
+{
+  solutionTrace = trace;
 }
 
 bool SolutionTreeManagerAbstract::CheckIfSolutionNodeExists(
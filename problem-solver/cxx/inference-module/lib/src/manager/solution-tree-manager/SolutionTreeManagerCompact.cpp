@@ -0,0 +1,23 @@
+/*
+ * This source file is part of an OSTIS project. For the latest info, see http://ostis.net
+ * Distributed under the MIT License
+ * (See accompanying file COPYING.MIT or copy at http://opensource.org/licenses/MIT)
+ */
+
+#include "SolutionTreeManagerCompact.hpp"
+
+#include "generator/SolutionTreeGenerator.hpp"
+
+namespace inference
+{
+SolutionTreeManagerCompact::SolutionTreeManagerCompact(ScMemoryContext * context)
+  : SolutionTreeManagerAbstract(context)
+{
+}
+
+bool SolutionTreeManagerCompact::AddNode(ScAddr const & formula, Replacements const & replacements)
+{
+  return solutionTreeGenerator->AddCompactNode(formula, replacements);
+}
+
+}  // namespace inference
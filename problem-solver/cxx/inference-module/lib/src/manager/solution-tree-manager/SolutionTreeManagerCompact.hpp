@@ -0,0 +1,30 @@
+/*
+ * This source file is part of an OSTIS project. For the latest info, see http://ostis.net
+ * Distributed under the MIT License
+ * (See accompanying file COPYING.MIT or copy at http://opensource.org/licenses/MIT)
+ */
+
+#pragma once
+
+#include <vector>
+
+#include <sc-memory/sc_memory.hpp>
+#include <sc-memory/sc_addr.hpp>
+
+#include "inference/solution_tree_manager_abstract.hpp"
+
+namespace inference
+{
+/**
+ * Solution tree that generates one node per formula application with all used replacements packed into single link.
+ * Such tree can be expanded to the tree generated by `SolutionTreeManager` with `SolutionTreeExpander`
+ */
+class SolutionTreeManagerCompact : public SolutionTreeManagerAbstract
+{
+public:
+  explicit SolutionTreeManagerCompact(ScMemoryContext * context);
+
+  bool AddNode(ScAddr const & formula, Replacements const & replacements) override;
+};
+
+}  // namespace inference
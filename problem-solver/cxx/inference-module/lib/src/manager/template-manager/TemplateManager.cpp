@@ -8,6 +8,12 @@
 
 #include <algorithm>
 
+#include <sc-memory-profiler/sc_memory_profiler.hpp>
+
+#include "classifier/FormulaMetadataCache.hpp"
+
+using utils::ScMemoryCallType;
+using utils::ScMemoryProfiler;
 using namespace inference;
 
 TemplateManager::TemplateManager(ScMemoryContext * ms_context)
@@ -24,24 +30,22 @@ std::vector<ScTemplateParams> TemplateManager::CreateTemplateParams(ScAddr const
   std::map<ScAddr, std::set<ScAddr, ScAddrLessFunc>, ScAddrLessFunc> replacementsMultimap;
   std::vector<ScTemplateParams> templateParamsVector;
 
-  ScIterator3Ptr variableNodeIterator = context->CreateIterator3(scTemplate, ScType::ConstPermPosArc, ScType::VarNode);
-  while (variableNodeIterator->Next())
+  std::vector<std::pair<ScAddr, ScAddrVector>> variablesClasses;
+  if (formulaMetadataCache)
+    variablesClasses = formulaMetadataCache->Get(context, scTemplate)->variablesClasses;
+  else
+    variablesClasses = FormulaMetadataCache::GetVariablesClasses(context, scTemplate);
+
+  for (auto const & [variableNode, variableClasses] : variablesClasses)
   {
-    ScAddr const & variableNode = variableNodeIterator->Get(2);
     if (!replacementsMultimap[variableNode].empty())
     {
       continue;
     }
-    ScIterator5Ptr constantsIterator = context->CreateIterator5(
-        ScType::ConstNode, ScType::VarPermPosArc, variableNode, ScType::ConstPermPosArc, scTemplate);
-    while (constantsIterator->Next())
+    for (ScAddr const & varClass : variableClasses)
     {
-      ScAddr const & varClass = constantsIterator->Get(0);
-      for (ScAddr const & argument : arguments)
-      {
-        if (context->CheckConnector(varClass, argument, ScType::ConstPermPosArc))
-          replacementsMultimap[variableNode].insert(argument);
-      }
+      ScAddrVector const & classArguments = GetArgumentsOfClass(varClass);
+      replacementsMultimap[variableNode].insert(classArguments.cbegin(), classArguments.cend());
     }
     if (templateParamsVector.empty())
     {
@@ -86,3 +90,18 @@ std::vector<ScTemplateParams> TemplateManager::CreateTemplateParams(ScAddr const
   }
   return templateParamsVector;
 }
+
+ScAddrVector const & TemplateManager::GetArgumentsOfClass(ScAddr const & argumentsClass)
+{
+  auto const & [argumentsIterator, isNew] = argumentsByClass.try_emplace(argumentsClass);
+  if (isNew)
+  {
+    for (ScAddr const & argument : arguments)
+    {
+      ScMemoryProfiler::Scope const profilerScope(ScMemoryCallType::CHECK_CONNECTOR);
+      if (context->CheckConnector(argumentsClass, argument, ScType::ConstPermPosArc))
+        argumentsIterator->second.push_back(argument);
+    }
+  }
+  return argumentsIterator->second;
+}
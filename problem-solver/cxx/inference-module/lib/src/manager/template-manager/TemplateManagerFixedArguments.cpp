@@ -15,16 +15,18 @@ TemplateManagerFixedArguments::TemplateManagerFixedArguments(ScMemoryContext * c
 {
 }
 
+/**
+ * Bind every fixed argument to the argument with the same index. All bindings form one row of template params, so
+ * formula with several fixed arguments is searched once
+ */
 std::vector<ScTemplateParams> TemplateManagerFixedArguments::CreateTemplateParams(ScAddr const & scTemplate)
 {
-  std::vector<ScTemplateParams> templateParamsVector;
   size_t const size = std::min(arguments.size(), fixedArguments.size());
-  for (size_t i = 0; i < size; ++i)
-  {
-    ScTemplateParams param;
-    param.Add(fixedArguments.at(i), arguments.at(i));
-    templateParamsVector.push_back(param);
-  }
+  if (size == 0)
+    return {};
 
-  return templateParamsVector;
+  ScTemplateParams params;
+  for (size_t i = 0; i < size; ++i)
+    params.Add(fixedArguments[i], arguments[i]);
+  return {params};
 }
@@ -1,6 +1,11 @@
 #include "SolutionTreeSearcher.hpp"
 #include "inference/inference_keynodes.hpp"
 
+#include <sc-memory-profiler/sc_memory_profiler.hpp>
+
+using utils::ScMemoryCallType;
+using utils::ScMemoryProfiler;
+
 namespace inference
 {
 SolutionTreeSearcher::SolutionTreeSearcher(ScMemoryContext * context)
@@ -51,6 +56,7 @@ bool SolutionTreeSearcher::CheckIfSolutionNodeExists(
                                         << context->GetElementSystemIdentifier(variable)
                                         << " but templateParams don't have replacement for this var");
   }
+  ScMemoryProfiler::Scope const profilerScope(ScMemoryCallType::SEARCH_BY_TEMPLATE);
   context->SearchByTemplate(solutionNodeTemplate, searchResult);
   return !searchResult.IsEmpty();
 }
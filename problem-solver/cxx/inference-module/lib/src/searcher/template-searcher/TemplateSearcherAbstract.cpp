@@ -17,6 +17,7 @@ TemplateSearcherAbstract::TemplateSearcherAbstract(
   : context(context)
   , replacementsUsingType(replacementsUsingType)
   , outputStructureFillingType(outputStructureFillingType)
+  , formulaMetadataCache(std::make_shared<FormulaMetadataCache>())
 {
 }
 
@@ -36,64 +37,127 @@ void TemplateSearcherAbstract::searchTemplate(
     ScAddrUnorderedSet const & variables,
     Replacements & result)
 {
+  // Values of variables bound by template params are added to search results for every found construction, so that
+  // results of all params have columns of the same size
   Replacements searchResults;
-  ScAddrVector variableReplacementValues;
-  ScAddr argument;
-
-  for (ScTemplateParams const & scTemplateParams : scTemplateParamsVector)
+  // Knowledge base is not changed between searches with params, so template links are resolved by content once
+  bool const isOutermostSearch = !resolvedLinksCandidates.has_value();
+  if (isOutermostSearch)
+    resolvedLinksCandidates.emplace();
+  try
   {
-    searchTemplate(templateAddr, scTemplateParams, variables, searchResults);
-    for (ScAddr const & variable : variables)
+    for (ScTemplateParams const & scTemplateParams : scTemplateParamsVector)
     {
-      if (searchResults.count(variable))
-      {
-        variableReplacementValues = searchResults.at(variable);
-        if (scTemplateParams.Get(variable, argument))
-        {
-          result[variable].push_back(argument);
-        }
-        else if (!variableReplacementValues.empty())
-        {
-          result[variable] = variableReplacementValues;
-        }
-      }
+      if (isCancelled())
+        break;
+      searchTemplate(templateAddr, scTemplateParams, variables, searchResults);
     }
   }
+  catch (...)
+  {
+    if (isOutermostSearch)
+      resolvedLinksCandidates.reset();
+    throw;
+  }
+  if (isOutermostSearch)
+    resolvedLinksCandidates.reset();
+  for (auto & [variable, values] : searchResults)
+  {
+    ScAddrVector & resultValues = result[variable];
+    resultValues.insert(resultValues.end(), values.cbegin(), values.cend());
+  }
 }
 
 void TemplateSearcherAbstract::getVariables(ScAddr const & formula, ScAddrUnorderedSet & variables)
 {
-  ScIterator3Ptr const & formulaVariablesIterator =
-      context->CreateIterator3(formula, ScType::ConstPermPosArc, ScType::Var);
-  while (formulaVariablesIterator->Next())
-    variables.insert(formulaVariablesIterator->Get(2));
+  std::shared_ptr<FormulaMetadata const> const & metadata = getFormulaMetadata(formula);
+  variables.insert(metadata->variablesSet.cbegin(), metadata->variablesSet.cend());
 }
 
 void TemplateSearcherAbstract::getConstants(ScAddr const & formula, ScAddrUnorderedSet & constants)
 {
-  ScIterator3Ptr const & formulaConstantsIterator =
-      context->CreateIterator3(formula, ScType::ConstPermPosArc, ScType::Const);
-  while (formulaConstantsIterator->Next())
-    constants.insert(formulaConstantsIterator->Get(2));
+  std::shared_ptr<FormulaMetadata const> const & metadata = getFormulaMetadata(formula);
+  constants.insert(metadata->constants.cbegin(), metadata->constants.cend());
 }
 
-bool TemplateSearcherAbstract::isContentIdentical(
-    ScTemplateSearchResultItem const & item,
-    std::map<std::string, std::string> const & linksContentMap)
+std::shared_ptr<FormulaMetadata const> TemplateSearcherAbstract::getFormulaMetadata(ScAddr const & formula) const
 {
-  bool result = true;
-  ScAddr link;
-  std::string linkContent;
-  for (auto const & contentMap : linksContentMap)
+  return formulaMetadataCache->Get(context, formula);
+}
+
+std::shared_ptr<TemplateSearcherAbstract::LinksCandidates const> TemplateSearcherAbstract::resolveLinksByContent(
+    ScAddr const & templateAddr)
+{
+  if (resolvedLinksCandidates)
+  {
+    auto const & resolvedIterator = resolvedLinksCandidates->find(templateAddr);
+    if (resolvedIterator != resolvedLinksCandidates->cend())
+      return resolvedIterator->second;
+  }
+
+  auto linksCandidates = std::make_shared<LinksCandidates>();
+  for (auto const & [linkKey, content] : getTemplateLinksContent(templateAddr))
+  {
+    // Only constant links are candidates, variable links with the same content belong to templates
+    ScAddrUnorderedSet & candidates = (*linksCandidates)[linkKey];
+    for (ScAddr const & link : context->SearchLinksByContent(content))
+    {
+      if (context->GetElementType(link).IsConst())
+        candidates.insert(link);
+    }
+  }
+  if (resolvedLinksCandidates)
+    resolvedLinksCandidates->emplace(templateAddr, linksCandidates);
+  return linksCandidates;
+}
+
+bool TemplateSearcherAbstract::seedSearchByContent(
+    LinksCandidates const & resolvedLinksCandidates,
+    ScTemplateParams const & templateParams,
+    std::vector<ScTemplateParams> & seededParamsVector,
+    LinksCandidatesFilter & linksCandidates)
+{
+  std::string seedLinkKey;
+  for (auto const & [linkKey, candidates] : resolvedLinksCandidates)
   {
-    item.Get(contentMap.first, link);
-    context->GetLinkContent(link, linkContent);
-    if (contentMap.second != linkContent)
+    ScAddr boundLink;
+    if (templateParams.Get(linkKey, boundLink))
     {
-      result = false;
-      break;
+      if (!candidates.count(boundLink))
+        return false;
+      continue;
     }
+    if (candidates.empty())
+      return false;
+    if (seedLinkKey.empty() || candidates.size() < linksCandidates.at(seedLinkKey)->size())
+      seedLinkKey = linkKey;
+    linksCandidates.emplace(linkKey, &candidates);
   }
 
-  return result;
+  if (seedLinkKey.empty() || linksCandidates.at(seedLinkKey)->size() > MAX_CONTENT_SEEDS)
+    return true;
+
+  ScAddrUnorderedSet const & seeds = *linksCandidates.at(seedLinkKey);
+  linksCandidates.erase(seedLinkKey);
+  seededParamsVector.reserve(seeds.size());
+  for (ScAddr const & seed : seeds)
+  {
+    ScTemplateParams seededParams = templateParams;
+    seededParams.Add(seedLinkKey, seed);
+    seededParamsVector.push_back(std::move(seededParams));
+  }
+  return true;
+}
+
+bool TemplateSearcherAbstract::isContentCandidate(
+    ScTemplateSearchResultItem const & item,
+    LinksCandidatesFilter const & linksCandidates)
+{
+  ScAddr link;
+  for (auto const & [linkKey, candidates] : linksCandidates)
+  {
+    if (!item.Get(linkKey, link) || !candidates->count(link))
+      return false;
+  }
+  return true;
 }
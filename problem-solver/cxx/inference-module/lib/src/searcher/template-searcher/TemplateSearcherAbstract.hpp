@@ -12,8 +12,14 @@
 
 #include <vector>
 #include <algorithm>
+#include <memory>
+#include <optional>
+#include <unordered_map>
 
 #include "inference/replacements_utils.hpp"
+#include "inference/inference_cancellation.hpp"
+
+#include "classifier/FormulaMetadataCache.hpp"
 
 namespace inference
 {
@@ -41,15 +47,77 @@ public:
       ScAddrUnorderedSet const & variables,
       Replacements & result);
 
+  /// Create searcher with the same settings that works with another sc-memory context
+  virtual std::unique_ptr<TemplateSearcherAbstract> clone(ScMemoryContext * otherContext) const = 0;
+
   void getVariables(ScAddr const & formula, ScAddrUnorderedSet & variables);
 
   void getConstants(ScAddr const & formula, ScAddrUnorderedSet & constants);
 
-  bool isContentIdentical(
+  std::shared_ptr<FormulaMetadata const> getFormulaMetadata(ScAddr const & formula) const;
+
+  /// Share formulas metadata with other searchers, searchers cloned from this one share it too
+  void setFormulaMetadataCache(std::shared_ptr<FormulaMetadataCache> const & otherFormulaMetadataCache)
+  {
+    formulaMetadataCache = otherFormulaMetadataCache;
+  }
+
+  std::shared_ptr<FormulaMetadataCache> getFormulaMetadataCache() const
+  {
+    return formulaMetadataCache;
+  }
+
+  /// Stop searches when token is cancelled, searchers cloned from this one share token too
+  void setCancellationToken(std::shared_ptr<CancellationToken const> const & otherCancellationToken)
+  {
+    cancellationToken = otherCancellationToken;
+  }
+
+  std::shared_ptr<CancellationToken const> getCancellationToken() const
+  {
+    return cancellationToken;
+  }
+
+  bool isCancelled() const
+  {
+    return cancellationToken && cancellationToken->IsCancelled();
+  }
+
+  /// Template links mapped to knowledge base links with the same content
+  using LinksCandidates = std::map<std::string, ScAddrUnorderedSet>;
+
+  /// Template links mapped to candidates that result items are filtered by, candidates are owned by resolved ones
+  using LinksCandidatesFilter = std::map<std::string, ScAddrUnorderedSet const *>;
+
+  /**
+   * @brief Resolve template links by content. Links are resolved once for all params of search with several template
+   * params, other searches resolve them every time
+   * @param templateAddr is template to resolve links of
+   * @return template links mapped to constant knowledge base links with the same content
+   */
+  std::shared_ptr<LinksCandidates const> resolveLinksByContent(ScAddr const & templateAddr);
+
+  /**
+   * @brief Seed search with resolved template links. If the most selective unbound template link has at most
+   * MAX_CONTENT_SEEDS candidates then params that bind it to each candidate are created, and the link is not added to
+   * filter because result items don't need to be filtered by its content
+   * @param resolvedLinksCandidates is template links resolved by content
+   * @param templateParams is params to search template with
+   * @param seededParamsVector is params to search template with, empty if search is not seeded
+   * @param linksCandidates is candidates of template links that should be checked in result items
+   * @return false if template can't be found because some template link has no links with the same content
+   */
+  static bool seedSearchByContent(
+      LinksCandidates const & resolvedLinksCandidates,
+      ScTemplateParams const & templateParams,
+      std::vector<ScTemplateParams> & seededParamsVector,
+      LinksCandidatesFilter & linksCandidates);
+
+  static bool isContentCandidate(
       ScTemplateSearchResultItem const & item,
-      std::map<std::string, std::string> const & linksContentMap);
+      LinksCandidatesFilter const & linksCandidates);
 
-  void setInputStructures(ScAddrUnorderedSet const & otherInputStructures);
+  virtual void setInputStructures(ScAddrUnorderedSet const & otherInputStructures);
 
   ScAddrUnorderedSet getInputStructures() const;
 
@@ -85,13 +153,21 @@ public:
   }
 
 protected:
+  static size_t constexpr MAX_CONTENT_SEEDS = 64;
+
   ScMemoryContext * context;
   ScAddrUnorderedSet inputStructures;
   ReplacementsUsingType replacementsUsingType;
   OutputStructureFillingType outputStructureFillingType;
   AtomicLogicalFormulaSearchBeforeGenerationType atomicLogicalFormulaSearchBeforeGenerationType;
+  std::shared_ptr<FormulaMetadataCache> formulaMetadataCache;
+  std::shared_ptr<CancellationToken const> cancellationToken;
 
 private:
+  /// Template links resolved by content during search with several template params
+  std::optional<std::unordered_map<ScAddr, std::shared_ptr<LinksCandidates const>, ScAddrHashFunc>>
+      resolvedLinksCandidates;
+
   virtual void searchTemplateWithContent(
       ScTemplate const & searchTemplate,
       ScAddr const & templateAddr,
@@ -11,6 +11,10 @@
 #include <memory>
 #include <algorithm>
 
+#include <sc-memory-profiler/sc_memory_profiler.hpp>
+
+using utils::ScMemoryCallType;
+using utils::ScMemoryProfiler;
 using namespace inference;
 
 TemplateSearcherGeneral::TemplateSearcherGeneral(ScMemoryContext * context)
@@ -18,6 +22,13 @@ TemplateSearcherGeneral::TemplateSearcherGeneral(ScMemoryContext * context)
 {
 }
 
+std::unique_ptr<TemplateSearcherAbstract> TemplateSearcherGeneral::clone(ScMemoryContext * otherContext) const
+{
+  auto searcher = std::make_unique<TemplateSearcherGeneral>(*this);
+  searcher->context = otherContext;
+  return searcher;
+}
+
 void TemplateSearcherGeneral::searchTemplate(
     ScAddr const & templateAddr,
     ScTemplateParams const & templateParams,
@@ -25,17 +36,23 @@ void TemplateSearcherGeneral::searchTemplate(
     Replacements & result)
 {
   ScTemplate searchTemplate;
-  context->BuildTemplate(searchTemplate, templateAddr, templateParams);
-  if (context->CheckConnector(InferenceKeynodes::concept_template_with_links, templateAddr, ScType::ConstPermPosArc))
+  {
+    ScMemoryProfiler::Scope const profilerScope(ScMemoryCallType::BUILD_TEMPLATE);
+    context->BuildTemplate(searchTemplate, templateAddr, templateParams);
+  }
+  if (getFormulaMetadata(templateAddr)->isTemplateWithLinks)
   {
     searchTemplateWithContent(searchTemplate, templateAddr, templateParams, result);
   }
   else
   {
+    ScMemoryProfiler::Scope const profilerScope(ScMemoryCallType::SEARCH_BY_TEMPLATE);
     context->SearchByTemplateInterruptibly(
         searchTemplate,
         [&templateParams, &result, &variables, this](
             ScTemplateSearchResultItem const & item) -> ScTemplateSearchRequest {
+          if (isCancelled())
+            return ScTemplateSearchRequest::STOP;
           // Add search result items to the result Replacements
           for (ScAddr const & variable : variables)
           {
@@ -59,46 +76,64 @@ void TemplateSearcherGeneral::searchTemplateWithContent(
     ScTemplateParams const & templateParams,
     Replacements & result)
 {
-  std::map<std::string, std::string> linksContentMap = getTemplateLinksContent(templateAddr);
+  std::shared_ptr<LinksCandidates const> const & templateLinksCandidates = resolveLinksByContent(templateAddr);
+  LinksCandidatesFilter linksCandidates;
+  std::vector<ScTemplateParams> seededParamsVector;
+  if (!seedSearchByContent(*templateLinksCandidates, templateParams, seededParamsVector, linksCandidates))
+    return;
   ScAddrUnorderedSet variables;
   getVariables(templateAddr, variables);
 
-  context->SearchByTemplateInterruptibly(
-      searchTemplate,
-      [templateParams, &result, &variables](ScTemplateSearchResultItem const & item) -> ScTemplateSearchRequest {
-        // Add search result items to the result Replacements
-        for (ScAddr const & variable : variables)
-        {
-          ScAddr argument;
-          if (item.Has(variable))
-          {
-            result[variable].push_back(item[variable]);
-          }
-          if (templateParams.Get(variable, argument))
+  bool isFound = false;
+  auto const & search = [&](ScTemplate const & contentTemplate, ScTemplateParams const & contentParams)
+  {
+    ScMemoryProfiler::Scope const profilerScope(ScMemoryCallType::SEARCH_BY_TEMPLATE);
+    context->SearchByTemplateInterruptibly(
+        contentTemplate,
+        [&contentParams, &result, &variables, &isFound, this](
+            ScTemplateSearchResultItem const & item) -> ScTemplateSearchRequest {
+          if (isCancelled())
+            return ScTemplateSearchRequest::STOP;
+          // Add search result items to the result Replacements
+          for (ScAddr const & variable : variables)
           {
-            result[variable].push_back(argument);
+            ScAddr argument;
+            if (item.Get(variable, argument) || contentParams.Get(variable, argument))
+            {
+              result[variable].push_back(argument);
+            }
           }
-        }
-        return ScTemplateSearchRequest::STOP;
-      },
-      [&linksContentMap, this](ScTemplateSearchResultItem const & item) -> bool {
-        // Filter result item by the same content
-        return isContentIdentical(item, linksContentMap);
-      });
-}
+          isFound = true;
+          return ScTemplateSearchRequest::STOP;
+        },
+        [&linksCandidates](ScTemplateSearchResultItem const & item) -> bool {
+          // Filter result item by links with the same content
+          return isContentCandidate(item, linksCandidates);
+        });
+  };
 
-std::map<std::string, std::string> TemplateSearcherGeneral::getTemplateLinksContent(ScAddr const & templateAddr)
-{
-  std::map<std::string, std::string> linksContent;
-  ScIterator3Ptr linksIterator = context->CreateIterator3(templateAddr, ScType::ConstPermPosArc, ScType::NodeLink);
-  while (linksIterator->Next())
+  if (seededParamsVector.empty())
   {
-    ScAddr const & linkAddr = linksIterator->Get(2);
-    std::string stringContent;
-    if (context->GetLinkContent(linkAddr, stringContent))
+    search(searchTemplate, templateParams);
+    return;
+  }
+  for (ScTemplateParams const & seededParams : seededParamsVector)
+  {
+    ScTemplate seededTemplate;
     {
-      linksContent.emplace(std::to_string(linkAddr.Hash()), stringContent);
+      ScMemoryProfiler::Scope const profilerScope(ScMemoryCallType::BUILD_TEMPLATE);
+      context->BuildTemplate(seededTemplate, templateAddr, seededParams);
     }
+    search(seededTemplate, seededParams);
+    if (isFound)
+      break;
   }
+}
+
+std::map<std::string, std::string> TemplateSearcherGeneral::getTemplateLinksContent(ScAddr const & templateAddr)
+{
+  std::map<std::string, std::string> linksContent;
+  for (auto const & [linkAddr, stringContent] : getFormulaMetadata(templateAddr)->linksContent)
+    linksContent.emplace(std::to_string(linkAddr.Hash()), stringContent);
   return linksContent;
 }
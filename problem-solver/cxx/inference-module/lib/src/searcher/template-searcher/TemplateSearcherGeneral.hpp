@@ -22,6 +22,8 @@ class TemplateSearcherGeneral : public TemplateSearcherAbstract
 public:
   explicit TemplateSearcherGeneral(ScMemoryContext * ms_context);
 
+  std::unique_ptr<TemplateSearcherAbstract> clone(ScMemoryContext * otherContext) const override;
+
   void searchTemplate(
       ScAddr const & templateAddr,
       ScTemplateParams const & templateParams,
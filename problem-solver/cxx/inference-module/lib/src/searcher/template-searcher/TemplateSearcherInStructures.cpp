@@ -11,10 +11,26 @@
 
 #include <sc-agents-common/utils/CommonUtils.hpp>
 
+#include <sc-memory-profiler/sc_memory_profiler.hpp>
+
 #include "inference/inference_keynodes.hpp"
 
+using utils::ScMemoryCallType;
+using utils::ScMemoryProfiler;
 using namespace inference;
 
+namespace
+{
+/// Element can be a value of variable if it has all type bits of variable except constancy
+bool IsVariableValueCandidate(ScType const & elementType, ScType const & variableType)
+{
+  ScType::RealType const constancyBits =
+      static_cast<ScType::RealType>(ScType::Const) | static_cast<ScType::RealType>(ScType::Var);
+  ScType::RealType const variableBits = static_cast<ScType::RealType>(variableType) & ~constancyBits;
+  return (static_cast<ScType::RealType>(elementType) & variableBits) == variableBits;
+}
+}  // namespace
+
 TemplateSearcherInStructures::TemplateSearcherInStructures(
     ScMemoryContext * context,
     ScAddrUnorderedSet const & otherInputStructures)
@@ -28,41 +44,40 @@ TemplateSearcherInStructures::TemplateSearcherInStructures(ScMemoryContext * con
 {
 }
 
+std::unique_ptr<TemplateSearcherAbstract> TemplateSearcherInStructures::clone(ScMemoryContext * otherContext) const
+{
+  auto searcher = std::make_unique<TemplateSearcherInStructures>(*this);
+  searcher->context = otherContext;
+  return searcher;
+}
+
 void TemplateSearcherInStructures::searchTemplate(
     ScAddr const & templateAddr,
     ScTemplateParams const & templateParams,
     ScAddrUnorderedSet const & variables,
     Replacements & result)
 {
+  bool const isTemplateWithLinks = getFormulaMetadata(templateAddr)->isTemplateWithLinks;
+  if (!isTemplateWithLinks && searchTemplateByStructureElements(templateAddr, templateParams, variables, result))
+    return;
+
   ScTemplate searchTemplate;
-  context->BuildTemplate(searchTemplate, templateAddr, templateParams);
-  if (context->CheckConnector(InferenceKeynodes::concept_template_with_links, templateAddr, ScType::ConstPermPosArc))
+  {
+    ScMemoryProfiler::Scope const profilerScope(ScMemoryCallType::BUILD_TEMPLATE);
+    context->BuildTemplate(searchTemplate, templateAddr, templateParams);
+  }
+  if (isTemplateWithLinks)
   {
     searchTemplateWithContent(searchTemplate, templateAddr, templateParams, result);
   }
   else
   {
+    ScMemoryProfiler::Scope const profilerScope(ScMemoryCallType::SEARCH_BY_TEMPLATE);
     context->SearchByTemplateInterruptibly(
         searchTemplate,
-        [templateParams, &result, &variables, this](
+        [&templateParams, &result, &variables, this](
             ScTemplateSearchResultItem const & item) -> ScTemplateSearchRequest {
-          // Add search result item to the answer container
-          ScAddr argument;
-          for (ScAddr const & variable : variables)
-          {
-            if (item.Has(variable))
-            {
-              result[variable].push_back(item[variable]);
-            }
-            else if (templateParams.Get(variable, argument))
-            {
-              result[variable].push_back(argument);
-            }
-          }
-          if (replacementsUsingType == ReplacementsUsingType::REPLACEMENTS_FIRST)
-            return ScTemplateSearchRequest::STOP;
-          else
-            return ScTemplateSearchRequest::CONTINUE;
+          return addSearchResultItem(item, templateParams, variables, result);
         },
         [this](ScAddr const & item) -> bool {
           // Filter result item belonging to any of the input structures
@@ -71,60 +86,244 @@ void TemplateSearcherInStructures::searchTemplate(
   }
 }
 
+void TemplateSearcherInStructures::setInputStructures(ScAddrUnorderedSet const & otherInputStructures)
+{
+  TemplateSearcherAbstract::setInputStructures(otherInputStructures);
+  areInputStructuresLarge = false;
+  inputStructuresElements.reset();
+}
+
+bool TemplateSearcherInStructures::isStructureFirstSearchSupported() const
+{
+  return true;
+}
+
+/**
+ * Input structures are usually small parts of a large knowledge base, so template is anchored on them instead of
+ * filtering matches found in the whole knowledge base. Variable with the least amount of candidates among elements of
+ * input structures is bound to each candidate in turn, so that every match is found once
+ */
+bool TemplateSearcherInStructures::searchTemplateByStructureElements(
+    ScAddr const & templateAddr,
+    ScTemplateParams const & templateParams,
+    ScAddrUnorderedSet const & variables,
+    Replacements & result)
+{
+  if (!isStructureFirstSearchSupported() || areInputStructuresLarge)
+    return false;
+  if (!updateInputStructuresElements())
+  {
+    areInputStructuresLarge = true;
+    return false;
+  }
+  std::unordered_map<ScAddr, ScType, ScAddrHashFunc> const & elements = inputStructuresElements->elementsTypes;
+
+  // Connectors are not bound, because template is searched from its nodes
+  ScAddr anchorVariable;
+  ScAddrVector anchorCandidates;
+  for (ScAddr const & variable : getFormulaMetadata(templateAddr)->variables)
+  {
+    ScAddr value;
+    ScType const & variableType = context->GetElementType(variable);
+    if (variableType.IsConnector() || templateParams.Get(variable, value))
+      continue;
+    ScAddrVector candidates;
+    for (auto const & [element, elementType] : elements)
+    {
+      if (IsVariableValueCandidate(elementType, variableType))
+        candidates.push_back(element);
+    }
+    if (!anchorVariable.IsValid() || candidates.size() < anchorCandidates.size())
+    {
+      anchorVariable = variable;
+      anchorCandidates = std::move(candidates);
+    }
+  }
+  if (!anchorVariable.IsValid())
+    return false;
+
+  for (ScAddr const & candidate : anchorCandidates)
+  {
+    if (isCancelled())
+      break;
+    ScTemplateParams anchoredParams = templateParams;
+    anchoredParams.Add(anchorVariable, candidate);
+    ScTemplate anchoredTemplate;
+    {
+      ScMemoryProfiler::Scope const profilerScope(ScMemoryCallType::BUILD_TEMPLATE);
+      context->BuildTemplate(anchoredTemplate, templateAddr, anchoredParams);
+    }
+    bool isFound = false;
+    {
+      ScMemoryProfiler::Scope const profilerScope(ScMemoryCallType::SEARCH_BY_TEMPLATE);
+      context->SearchByTemplateInterruptibly(
+          anchoredTemplate,
+          [&anchoredParams, &result, &variables, &isFound, this](
+              ScTemplateSearchResultItem const & item) -> ScTemplateSearchRequest {
+            isFound = true;
+            return addSearchResultItem(item, anchoredParams, variables, result);
+          },
+          [&elements](ScAddr const & item) -> bool {
+            // Filter result item belonging to any of the input structures
+            return elements.count(item);
+          });
+    }
+    if (isFound && replacementsUsingType == ReplacementsUsingType::REPLACEMENTS_FIRST)
+      break;
+  }
+  return true;
+}
+
+/**
+ * Amount of connectors going out of structure is got without iteration, so elements are collected again only when
+ * some input structure has changed since previous collection, like output structure searched with input ones does
+ * after generation
+ */
+bool TemplateSearcherInStructures::updateInputStructuresElements()
+{
+  bool areElementsActual =
+      inputStructuresElements && inputStructuresElements->connectorsAmounts.size() == inputStructures.size();
+  for (ScAddr const & inputStructure : inputStructures)
+  {
+    if (!areElementsActual)
+      break;
+    auto const & connectorsAmounts = inputStructuresElements->connectorsAmounts;
+    auto const & amountIterator = connectorsAmounts.find(inputStructure);
+    areElementsActual = amountIterator != connectorsAmounts.cend() &&
+                        amountIterator->second == context->GetElementEdgesAndOutgoingArcsCount(inputStructure);
+  }
+  if (areElementsActual)
+    return true;
+
+  ScMemoryProfiler::Scope const profilerScope(ScMemoryCallType::CREATE_ITERATOR);
+  inputStructuresElements.reset();
+  auto elements = std::make_shared<InputStructuresElements>();
+  for (ScAddr const & inputStructure : inputStructures)
+  {
+    elements->connectorsAmounts.emplace(inputStructure, context->GetElementEdgesAndOutgoingArcsCount(inputStructure));
+    ScIterator3Ptr const & elementsIterator =
+        context->CreateIterator3(inputStructure, ScType::ConstPermPosArc, ScType::Unknown);
+    while (elementsIterator->Next())
+    {
+      elements->elementsTypes.emplace(elementsIterator->Get(2), context->GetElementType(elementsIterator->Get(2)));
+      if (elements->elementsTypes.size() > STRUCTURE_FIRST_SEARCH_MAX_ELEMENTS)
+        return false;
+    }
+  }
+  inputStructuresElements = std::move(elements);
+  return true;
+}
+
+ScTemplateSearchRequest TemplateSearcherInStructures::addSearchResultItem(
+    ScTemplateSearchResultItem const & item,
+    ScTemplateParams const & templateParams,
+    ScAddrUnorderedSet const & variables,
+    Replacements & result) const
+{
+  if (isCancelled())
+    return ScTemplateSearchRequest::STOP;
+  // Add search result item to the answer container
+  ScAddr argument;
+  for (ScAddr const & variable : variables)
+  {
+    if (item.Has(variable))
+    {
+      result[variable].push_back(item[variable]);
+    }
+    else if (templateParams.Get(variable, argument))
+    {
+      result[variable].push_back(argument);
+    }
+  }
+  if (replacementsUsingType == ReplacementsUsingType::REPLACEMENTS_FIRST)
+    return ScTemplateSearchRequest::STOP;
+  else
+    return ScTemplateSearchRequest::CONTINUE;
+}
+
 void TemplateSearcherInStructures::searchTemplateWithContent(
     ScTemplate const & searchTemplate,
     ScAddr const & templateAddr,
     ScTemplateParams const & templateParams,
     Replacements & result)
 {
+  std::shared_ptr<LinksCandidates const> const & templateLinksCandidates = resolveLinksByContent(templateAddr);
+  LinksCandidatesFilter linksCandidates;
+  std::vector<ScTemplateParams> seededParamsVector;
+  if (!seedSearchByContent(*templateLinksCandidates, templateParams, seededParamsVector, linksCandidates))
+    return;
   ScAddrUnorderedSet variables;
   getVariables(templateAddr, variables);
-  std::map<std::string, std::string> linksContentMap = getTemplateLinksContent(templateAddr);
-
-  context->SearchByTemplate(
-      searchTemplate,
-      [templateParams, &result, &variables, this](ScTemplateSearchResultItem const & item) -> ScTemplateSearchRequest {
-        // Add search result item to the answer container
-        for (ScAddr const & variable : variables)
-        {
-          ScAddr argument;
-          if (item.Get(variable, argument) || templateParams.Get(variable, argument))
+
+  bool isFound = false;
+  auto const & search = [&](ScTemplate const & contentTemplate, ScTemplateParams const & contentParams)
+  {
+    ScMemoryProfiler::Scope const profilerScope(ScMemoryCallType::SEARCH_BY_TEMPLATE);
+    context->SearchByTemplateInterruptibly(
+        contentTemplate,
+        [&contentParams, &result, &variables, &isFound, this](
+            ScTemplateSearchResultItem const & item) -> ScTemplateSearchRequest {
+          if (isCancelled())
+            return ScTemplateSearchRequest::STOP;
+          // Add search result item to the answer container
+          for (ScAddr const & variable : variables)
           {
-            result[variable].push_back(argument);
+            ScAddr argument;
+            if (item.Get(variable, argument) || contentParams.Get(variable, argument))
+            {
+              result[variable].push_back(argument);
+            }
           }
-        }
-        if (replacementsUsingType == ReplacementsUsingType::REPLACEMENTS_FIRST)
-          return ScTemplateSearchRequest::STOP;
-        else
-          return ScTemplateSearchRequest::CONTINUE;
-      },
-      [&linksContentMap, this](ScTemplateSearchResultItem const & item) -> bool {
-        // Filter result item by the same content and belonging to any of the input structures
-        if (!isContentIdentical(item, linksContentMap))
-          return false;
-        for (size_t i = 0; i < item.Size(); i++)
-        {
-          ScAddr const & checkedElement = item[i];
-          if (isValidElement(checkedElement) == SC_FALSE)
+          isFound = true;
+          if (replacementsUsingType == ReplacementsUsingType::REPLACEMENTS_FIRST)
+            return ScTemplateSearchRequest::STOP;
+          else
+            return ScTemplateSearchRequest::CONTINUE;
+        },
+        [&linksCandidates, this](ScTemplateSearchResultItem const & item) -> bool {
+          // Filter result item by links with the same content and belonging to any of the input structures
+          if (!isContentCandidate(item, linksCandidates))
             return false;
-        }
-        return true;
-      });
+          for (size_t i = 0; i < item.Size(); i++)
+          {
+            ScAddr const & checkedElement = item[i];
+            if (isValidElement(checkedElement) == SC_FALSE)
+              return false;
+          }
+          return true;
+        });
+  };
+
+  if (seededParamsVector.empty())
+  {
+    search(searchTemplate, templateParams);
+    return;
+  }
+  for (ScTemplateParams const & seededParams : seededParamsVector)
+  {
+    ScTemplate seededTemplate;
+    {
+      ScMemoryProfiler::Scope const profilerScope(ScMemoryCallType::BUILD_TEMPLATE);
+      context->BuildTemplate(seededTemplate, templateAddr, seededParams);
+    }
+    search(seededTemplate, seededParams);
+    if (isFound && replacementsUsingType == ReplacementsUsingType::REPLACEMENTS_FIRST)
+      break;
+  }
 }
 
 std::map<std::string, std::string> TemplateSearcherInStructures::getTemplateLinksContent(ScAddr const & templateAddr)
 {
   std::map<std::string, std::string> linksContent;
-  ScIterator3Ptr const & linksIterator =
-      context->CreateIterator3(templateAddr, ScType::ConstPermPosArc, ScType::NodeLink);
-  while (linksIterator->Next())
+  std::shared_ptr<FormulaMetadata const> const & metadata = getFormulaMetadata(templateAddr);
+  for (ScAddr const & linkAddr : metadata->links)
   {
-    ScAddr const & linkAddr = linksIterator->Get(2);
-    std::string stringContent;
     if (isValidElement(linkAddr))
     {
-      context->GetLinkContent(linkAddr, stringContent);
-      linksContent.emplace(std::to_string(linkAddr.Hash()), stringContent);
+      auto const & contentIterator = metadata->linksContent.find(linkAddr);
+      linksContent.emplace(
+          std::to_string(linkAddr.Hash()),
+          contentIterator == metadata->linksContent.cend() ? std::string() : contentIterator->second);
     }
   }
 
@@ -133,6 +332,7 @@ std::map<std::string, std::string> TemplateSearcherInStructures::getTemplateLink
 
 bool TemplateSearcherInStructures::isValidElement(ScAddr const & element) const
 {
+  ScMemoryProfiler::Scope const profilerScope(ScMemoryCallType::CREATE_ITERATOR);
   auto const & structuresIterator =
       context->CreateIterator3(ScType::ConstNodeStructure, ScType::ConstPermPosArc, element);
   while (structuresIterator->Next())
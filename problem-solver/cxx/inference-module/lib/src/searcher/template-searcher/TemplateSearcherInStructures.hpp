@@ -6,7 +6,9 @@
 
 #pragma once
 
+#include <memory>
 #include <queue>
+#include <unordered_map>
 #include <vector>
 
 #include <sc-memory/sc_memory.hpp>
@@ -25,13 +27,45 @@ public:
 
   explicit TemplateSearcherInStructures(ScMemoryContext * ms_context);
 
+  std::unique_ptr<TemplateSearcherAbstract> clone(ScMemoryContext * otherContext) const override;
+
   void searchTemplate(
       ScAddr const & templateAddr,
       ScTemplateParams const & templateParams,
       ScAddrUnorderedSet const & variables,
       Replacements & result) override;
 
+  void setInputStructures(ScAddrUnorderedSet const & otherInputStructures) override;
+
+protected:
+  /// Check if every match of template has elements of input structures for all its variables
+  virtual bool isStructureFirstSearchSupported() const;
+
 private:
+  /// Input structures with more elements are searched over the whole knowledge base with filtering of results
+  static size_t constexpr STRUCTURE_FIRST_SEARCH_MAX_ELEMENTS = 4096;
+
+  /**
+   * @brief Search template by values of one variable taken from elements of small input structures
+   * @returns false if input structures are large or template has no variables to take values for, template is not
+   * searched then
+   */
+  bool searchTemplateByStructureElements(
+      ScAddr const & templateAddr,
+      ScTemplateParams const & templateParams,
+      ScAddrUnorderedSet const & variables,
+      Replacements & result);
+
+  /// Collect elements of input structures with their types if they have changed, returns false if there are more than
+  /// maximum elements
+  bool updateInputStructuresElements();
+
+  ScTemplateSearchRequest addSearchResultItem(
+      ScTemplateSearchResultItem const & item,
+      ScTemplateParams const & templateParams,
+      ScAddrUnorderedSet const & variables,
+      Replacements & result) const;
+
   void searchTemplateWithContent(
       ScTemplate const & searchTemplate,
       ScAddr const & templateAddr,
@@ -41,5 +75,21 @@ private:
   std::map<std::string, std::string> getTemplateLinksContent(ScAddr const & templateAddr) override;
 
   virtual bool isValidElement(ScAddr const & element) const;
+
+  /// Input structures only get new elements during inference, so once they are large they are not counted again
+  bool areInputStructuresLarge = false;
+
+  struct InputStructuresElements
+  {
+    std::unordered_map<ScAddr, ScType, ScAddrHashFunc> elementsTypes;
+    /// Amounts of connectors going out of input structures when their elements were collected
+    std::unordered_map<ScAddr, size_t, ScAddrHashFunc> connectorsAmounts;
+  };
+
+  /**
+   * Elements of input structures collected for all searches until input structures are changed. They are not changed
+   * after collection, so cloned searchers share them instead of copying, and collect new ones if structures change
+   */
+  std::shared_ptr<InputStructuresElements const> inputStructuresElements;
 };
 }  // namespace inference
@@ -8,6 +8,11 @@
 
 #include "inference/inference_keynodes.hpp"
 
+#include <sc-memory-profiler/sc_memory_profiler.hpp>
+
+using utils::ScMemoryCallType;
+using utils::ScMemoryProfiler;
+
 namespace inference
 {
 
@@ -24,6 +29,14 @@ TemplateSearcherOnlyMembershipArcsInStructures::TemplateSearcherOnlyMembershipAr
 {
 }
 
+std::unique_ptr<TemplateSearcherAbstract> TemplateSearcherOnlyMembershipArcsInStructures::clone(
+    ScMemoryContext * otherContext) const
+{
+  auto searcher = std::make_unique<TemplateSearcherOnlyMembershipArcsInStructures>(*this);
+  searcher->context = otherContext;
+  return searcher;
+}
+
 std::map<std::string, std::string> TemplateSearcherOnlyMembershipArcsInStructures::getTemplateLinksContent(
     ScAddr const & templateAddr)
 {
@@ -32,10 +45,17 @@ std::map<std::string, std::string> TemplateSearcherOnlyMembershipArcsInStructure
   return {};
 }
 
+/// Nodes of matches can be outside of input structures, so values of variables can't be taken from them
+bool TemplateSearcherOnlyMembershipArcsInStructures::isStructureFirstSearchSupported() const
+{
+  return false;
+}
+
 bool TemplateSearcherOnlyMembershipArcsInStructures::isValidElement(ScAddr const & element) const
 {
   if (!context->GetElementType(element).IsMembershipArc())
     return true;
+  ScMemoryProfiler::Scope const profilerScope(ScMemoryCallType::CREATE_ITERATOR);
   auto const & structuresIterator =
       context->CreateIterator3(ScType::ConstNodeStructure, ScType::ConstPermPosArc, element);
   while (structuresIterator->Next())
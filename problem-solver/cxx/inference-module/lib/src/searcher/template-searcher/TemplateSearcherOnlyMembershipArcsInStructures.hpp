@@ -20,6 +20,11 @@ public:
 
   explicit TemplateSearcherOnlyMembershipArcsInStructures(ScMemoryContext * ms_context);
 
+  std::unique_ptr<TemplateSearcherAbstract> clone(ScMemoryContext * otherContext) const override;
+
+protected:
+  bool isStructureFirstSearchSupported() const override;
+
 private:
   std::map<std::string, std::string> getTemplateLinksContent(ScAddr const & templateAddr) override;
 
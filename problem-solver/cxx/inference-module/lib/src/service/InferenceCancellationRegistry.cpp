@@ -0,0 +1,84 @@
+/*
+ * This source file is part of an OSTIS project. For the latest info, see http://ostis.net
+ * Distributed under the MIT License
+ * (See accompanying file COPYING.MIT or copy at http://opensource.org/licenses/MIT)
+ */
+
+#include "inference/inference_cancellation.hpp"
+
+namespace inference
+{
+InferenceCancellationRegistry::Registration::Registration(ScAddr const & action)
+  : action(action)
+  , token(InferenceCancellationRegistry::GetInstance().Register(action))
+{
+}
+
+InferenceCancellationRegistry::Registration::~Registration()
+{
+  InferenceCancellationRegistry::GetInstance().Unregister(action);
+}
+
+std::shared_ptr<CancellationToken> const & InferenceCancellationRegistry::Registration::GetToken() const
+{
+  return token;
+}
+
+InferenceCancellationRegistry & InferenceCancellationRegistry::GetInstance()
+{
+  static InferenceCancellationRegistry instance;
+  return instance;
+}
+
+std::shared_ptr<CancellationToken> InferenceCancellationRegistry::Register(ScAddr const & action)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  std::shared_ptr<CancellationToken> & token = tokens[action];
+  if (!token)
+    token = std::make_shared<CancellationToken>();
+  if (pendingCancellations.erase(action))
+    token->Cancel();
+  return token;
+}
+
+void InferenceCancellationRegistry::Unregister(ScAddr const & action)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  tokens.erase(action);
+  pendingCancellations.erase(action);
+}
+
+bool InferenceCancellationRegistry::Cancel(ScAddr const & action)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  auto const & tokenIterator = tokens.find(action);
+  if (tokenIterator == tokens.cend())
+    return false;
+  tokenIterator->second->Cancel();
+  return true;
+}
+
+void InferenceCancellationRegistry::CancelOnRegistration(ScAddr const & action)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  auto const & tokenIterator = tokens.find(action);
+  // Action may be registered after it was checked by caller
+  if (tokenIterator != tokens.cend())
+    tokenIterator->second->Cancel();
+  else
+    pendingCancellations.insert(action);
+}
+
+size_t InferenceCancellationRegistry::Size() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return tokens.size();
+}
+
+size_t InferenceCancellationRegistry::GetPendingCancellationsAmount() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return pendingCancellations.size();
+}
+
+}  // namespace inference
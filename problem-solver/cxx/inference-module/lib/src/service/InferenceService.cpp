@@ -0,0 +1,344 @@
+/*
+ * This source file is part of an OSTIS project. For the latest info, see http://ostis.net
+ * Distributed under the MIT License
+ * (See accompanying file COPYING.MIT or copy at http://opensource.org/licenses/MIT)
+ */
+
+#include "inference/inference_service.hpp"
+
+#include <sc-memory/sc_event.hpp>
+
+#include <sc-agents-common/utils/IteratorUtils.hpp>
+
+#include "inference/inference_manager_factory.hpp"
+#include "inference/thread_pool.hpp"
+
+#include "classifier/FormulaMetadataCache.hpp"
+
+namespace inference
+{
+InferenceService & InferenceService::GetInstance()
+{
+  static InferenceService instance;
+  return instance;
+}
+
+InferenceService::~InferenceService()
+{
+  Stop();
+}
+
+void InferenceService::Start()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  if (isRunning)
+    return;
+  context = std::make_unique<ScMemoryContext>();
+  formulaMetadataCache = std::make_shared<FormulaMetadataCache>();
+  formulaMetadataCache->SetComputeCallback(
+      [this, cache = formulaMetadataCache.get()](ScAddr const & formula)
+      {
+        WatchFormula(cache, formula);
+      });
+  isRunning = true;
+}
+
+void InferenceService::Stop()
+{
+  Subscriptions stoppedSubscriptions;
+  std::unique_ptr<ScMemoryContext> stoppedContext;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!isRunning)
+      return;
+    isRunning = false;
+    stoppedSubscriptions = std::move(releasedSubscriptions);
+    releasedSubscriptions.clear();
+    for (auto const & [set, subscriptions] : setsSubscriptions)
+      stoppedSubscriptions.insert(stoppedSubscriptions.end(), subscriptions.cbegin(), subscriptions.cend());
+    for (auto const & [formula, subscriptions] : formulasSubscriptions)
+      stoppedSubscriptions.insert(stoppedSubscriptions.end(), subscriptions.cbegin(), subscriptions.cend());
+    setsSubscriptions.clear();
+    formulasSubscriptions.clear();
+    watchedFormulasSets.clear();
+    watchedSets.clear();
+    formulaMetadataCache.reset();
+    threadPool.reset();
+    stoppedContext = std::move(context);
+  }
+  // Subscriptions are destroyed without lock, because their callbacks take it
+  stoppedSubscriptions.clear();
+  stoppedContext.reset();
+}
+
+bool InferenceService::IsRunning() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return isRunning;
+}
+
+std::unique_ptr<InferenceManagerAbstract> InferenceService::ConstructDirectInferenceManagerAll(
+    ScMemoryContext * context,
+    utils::ScLogger * logger,
+    InferenceConfig const & inferenceFlowConfig,
+    ScAddr const & formulasSet)
+{
+  std::unique_ptr<InferenceManagerAbstract> manager = InferenceManagerFactory::ConstructDirectInferenceManagerAll(
+      context, logger, WithoutOwnThreadPool(inferenceFlowConfig));
+  Share(manager, inferenceFlowConfig);
+  Watch(formulasSet);
+  return manager;
+}
+
+std::unique_ptr<InferenceManagerAbstract> InferenceService::ConstructDirectInferenceManagerTarget(
+    ScMemoryContext * context,
+    utils::ScLogger * logger,
+    InferenceConfig const & inferenceFlowConfig,
+    ScAddr const & formulasSet)
+{
+  std::unique_ptr<InferenceManagerAbstract> manager = InferenceManagerFactory::ConstructDirectInferenceManagerTarget(
+      context, logger, WithoutOwnThreadPool(inferenceFlowConfig));
+  Share(manager, inferenceFlowConfig);
+  Watch(formulasSet);
+  return manager;
+}
+
+std::shared_ptr<FormulaMetadataCache> InferenceService::GetFormulaMetadataCache() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return formulaMetadataCache;
+}
+
+size_t InferenceService::GetWatchedFormulasSetsAmount() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return watchedFormulasSets.size();
+}
+
+size_t InferenceService::GetWatchedSetsAmount() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return watchedSets.size();
+}
+
+size_t InferenceService::GetWatchedFormulasAmount() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return formulasSubscriptions.size();
+}
+
+void InferenceService::Share(std::unique_ptr<InferenceManagerAbstract> & manager, InferenceConfig const & inferenceFlowConfig)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  if (!isRunning)
+  {
+    if (inferenceFlowConfig.disjunctionComputationType == COMPUTE_IN_PARALLEL)
+      manager->SetThreadPool(std::make_shared<ThreadPool>());
+    return;
+  }
+
+  manager->SetFormulaMetadataCache(formulaMetadataCache);
+  if (inferenceFlowConfig.disjunctionComputationType == COMPUTE_IN_PARALLEL)
+  {
+    if (!threadPool)
+      threadPool = std::make_shared<ThreadPool>();
+    manager->SetThreadPool(threadPool);
+  }
+}
+
+void InferenceService::Watch(ScAddr const & formulasSet)
+{
+  // Released subscriptions are destroyed after lock is released, because their callbacks take it
+  Subscriptions expiredSubscriptions;
+  std::lock_guard<std::mutex> lock(mutex);
+  expiredSubscriptions = std::move(releasedSubscriptions);
+  releasedSubscriptions.clear();
+  if (!isRunning || !formulasSet.IsValid() || !watchedFormulasSets.insert(formulasSet).second)
+    return;
+
+  WatchSet(formulasSet, true);
+  ScIterator3Ptr const & setsIterator = context->CreateIterator3(formulasSet, ScType::ConstPermPosArc, ScType::Node);
+  while (setsIterator->Next())
+    WatchSet(setsIterator->Get(2), false);
+}
+
+void InferenceService::WatchSet(ScAddr const & set, bool isFormulasSet)
+{
+  if (!watchedSets.insert(set).second)
+    return;
+
+  auto const & onGenerate =
+      [this, isFormulasSet](ScEventAfterGenerateOutgoingArc<ScType::ConstPermPosArc> const & event)
+  {
+    if (isFormulasSet)
+      WatchAddedSet(event.GetArcTargetElement());
+    OnFormulaAdded(event.GetArcTargetElement());
+  };
+  auto const & onErase =
+      [this, isFormulasSet](ScEventBeforeEraseOutgoingArc<ScType::ConstPermPosArc> const & event)
+  {
+    OnFormulaErased(event.GetArcTargetElement(), event.GetArc(), isFormulasSet);
+  };
+  Subscriptions & subscriptions = setsSubscriptions[set];
+  subscriptions.push_back(
+      context->CreateElementaryEventSubscription<ScEventAfterGenerateOutgoingArc<ScType::ConstPermPosArc>>(
+          set, onGenerate));
+  subscriptions.push_back(
+      context->CreateElementaryEventSubscription<ScEventBeforeEraseOutgoingArc<ScType::ConstPermPosArc>>(
+          set, onErase));
+}
+
+void InferenceService::WatchAddedSet(ScAddr const & set)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  if (isRunning && context->GetElementType(set).IsNode())
+    WatchSet(set, false);
+}
+
+void InferenceService::WatchFormula(FormulaMetadataCache const * cache, ScAddr const & formula)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  // Cache of managers constructed before restart of the service is not watched
+  if (!isRunning || cache != formulaMetadataCache.get() || formulasSubscriptions.count(formula))
+    return;
+
+  auto const & onGenerate = [this, formula](ScEventAfterGenerateOutgoingArc<ScType::ConstPermPosArc> const &)
+  {
+    OnFormulaChanged(formula);
+  };
+  auto const & onErase = [this, formula](ScEventBeforeEraseOutgoingArc<ScType::ConstPermPosArc> const &)
+  {
+    OnFormulaChanged(formula);
+  };
+  Subscriptions & subscriptions = formulasSubscriptions[formula];
+  subscriptions.push_back(
+      context->CreateElementaryEventSubscription<ScEventAfterGenerateOutgoingArc<ScType::ConstPermPosArc>>(
+          formula, onGenerate));
+  subscriptions.push_back(
+      context->CreateElementaryEventSubscription<ScEventBeforeEraseOutgoingArc<ScType::ConstPermPosArc>>(
+          formula, onErase));
+}
+
+void InferenceService::OnFormulaChanged(ScAddr const & formula)
+{
+  std::shared_ptr<FormulaMetadataCache> cache;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    cache = formulaMetadataCache;
+  }
+  if (cache)
+    cache->Invalidate(formula);
+}
+
+void InferenceService::OnFormulaAdded(ScAddr const & formula)
+{
+  // Metadata doesn't depend on sets of formulas, so metadata of other formulas is kept
+  OnFormulaChanged(formula);
+}
+
+void InferenceService::OnFormulaErased(ScAddr const & element, ScAddr const & erasedArc, bool isFormulasSet)
+{
+  std::shared_ptr<FormulaMetadataCache> cache;
+  ScAddrUnorderedSet invalidatedElements = {element};
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!isRunning)
+      return;
+    cache = formulaMetadataCache;
+
+    ScAddrVector leftFormulas;
+    if (!isFormulasSet)
+    {
+      if (!IsInSets(element, erasedArc, watchedSets))
+        leftFormulas.push_back(element);
+    }
+    else if (watchedSets.count(element) && !IsInSets(element, erasedArc, watchedFormulasSets))
+    {
+      watchedSets.erase(element);
+      ReleaseSubscriptions(setsSubscriptions, element);
+      ScIterator3Ptr const & formulasIterator =
+          context->CreateIterator3(element, ScType::ConstPermPosArc, ScType::Unknown);
+      while (formulasIterator->Next())
+      {
+        if (!IsInSets(formulasIterator->Get(2), ScAddr::Empty, watchedSets))
+          leftFormulas.push_back(formulasIterator->Get(2));
+      }
+    }
+
+    for (ScAddr const & formula : leftFormulas)
+      CollectFormulaElements(formula, invalidatedElements);
+    for (ScAddr const & invalidatedElement : invalidatedElements)
+      ReleaseSubscriptions(formulasSubscriptions, invalidatedElement);
+  }
+  // Atomic logical formulas that are not watched are invalidated, so they are watched again when they are computed
+  for (ScAddr const & invalidatedElement : invalidatedElements)
+    cache->Invalidate(invalidatedElement);
+}
+
+bool InferenceService::IsInSets(
+    ScAddr const & element,
+    ScAddr const & erasedArc,
+    ScAddrUnorderedSet const & sets) const
+{
+  ScIterator3Ptr const & setsIterator = context->CreateIterator3(ScType::Node, ScType::ConstPermPosArc, element);
+  while (setsIterator->Next())
+  {
+    if (setsIterator->Get(1) != erasedArc && sets.count(setsIterator->Get(0)))
+      return true;
+  }
+  return false;
+}
+
+void InferenceService::CollectFormulaElements(ScAddr const & formula, ScAddrUnorderedSet & elements) const
+{
+  elements.insert(formula);
+  ScAddr const & formulaRoot =
+      utils::IteratorUtils::getAnyByOutRelation(context.get(), formula, ScKeynodes::rrel_main_key_sc_element);
+  ScAddrVector operands;
+  if (formulaRoot.IsValid())
+    operands.push_back(formulaRoot);
+  while (!operands.empty())
+  {
+    ScAddr const operand = operands.back();
+    operands.pop_back();
+    if (!elements.insert(operand).second)
+      continue;
+    // Atomic logical formulas are structures, connectives are connectors and tuples
+    ScType const & operandType = context->GetElementType(operand);
+    if (operandType.IsConnector())
+    {
+      auto const & [source, target] = context->GetConnectorIncidentElements(operand);
+      operands.push_back(source);
+      operands.push_back(target);
+    }
+    else if (operandType == ScType::ConstNodeTuple)
+    {
+      ScIterator3Ptr const & operandsIterator =
+          context->CreateIterator3(operand, ScType::ConstPermPosArc, ScType::Unknown);
+      while (operandsIterator->Next())
+        operands.push_back(operandsIterator->Get(2));
+    }
+  }
+}
+
+void InferenceService::ReleaseSubscriptions(
+    std::unordered_map<ScAddr, Subscriptions, ScAddrHashFunc> & subscriptions,
+    ScAddr const & element)
+{
+  auto const & subscriptionsIterator = subscriptions.find(element);
+  if (subscriptionsIterator == subscriptions.cend())
+    return;
+  releasedSubscriptions.insert(
+      releasedSubscriptions.end(), subscriptionsIterator->second.cbegin(), subscriptionsIterator->second.cend());
+  subscriptions.erase(subscriptionsIterator);
+}
+
+InferenceConfig InferenceService::WithoutOwnThreadPool(InferenceConfig inferenceFlowConfig)
+{
+  // Shared thread pool is set instead of one created by factory
+  if (inferenceFlowConfig.disjunctionComputationType == COMPUTE_IN_PARALLEL)
+    inferenceFlowConfig.disjunctionComputationType = COMPUTE_SEQUENTIALLY;
+  return inferenceFlowConfig;
+}
+
+}  // namespace inference
@@ -0,0 +1,371 @@
+/*
+ * This source file is part of an OSTIS project. For the latest info, see http://ostis.net
+ * Distributed under the MIT License
+ * (See accompanying file COPYING.MIT or copy at http://opensource.org/licenses/MIT)
+ */
+
+#include "inference/inference_recorder.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <queue>
+#include <tuple>
+
+namespace inference
+{
+namespace
+{
+uint64_t const EMPTY_INDEX = std::numeric_limits<uint64_t>::max();
+
+template <typename TValue>
+void Write(std::string & content, TValue const & value)
+{
+  content.append(reinterpret_cast<char const *>(&value), sizeof(TValue));
+}
+
+void WriteString(std::string & content, std::string const & value)
+{
+  Write(content, static_cast<uint64_t>(value.size()));
+  content.append(value);
+}
+
+template <typename TValue>
+void Read(std::string const & content, size_t & position, TValue & value)
+{
+  if (position + sizeof(TValue) > content.size())
+    SC_THROW_EXCEPTION(utils::ExceptionParseError, "InferenceRecorder: snapshot is truncated");
+  std::memcpy(&value, content.data() + position, sizeof(TValue));
+  position += sizeof(TValue);
+}
+
+void ReadString(std::string const & content, size_t & position, std::string & value)
+{
+  uint64_t size = 0;
+  Read(content, position, size);
+  if (size > content.size() - position)
+    SC_THROW_EXCEPTION(utils::ExceptionParseError, "InferenceRecorder: snapshot is truncated");
+  value.assign(content, position, size);
+  position += size;
+}
+
+template <typename TEnum>
+void ReadEnum(std::string const & content, size_t & position, TEnum & value)
+{
+  uint32_t number = 0;
+  Read(content, position, number);
+  value = static_cast<TEnum>(number);
+}
+
+ScAddr ReadElement(std::string const & content, size_t & position, ScAddrVector const & elements)
+{
+  uint64_t index = 0;
+  Read(content, position, index);
+  if (index == EMPTY_INDEX)
+    return ScAddr::Empty;
+  if (index >= elements.size())
+    SC_THROW_EXCEPTION(
+        utils::ExceptionParseError, "InferenceRecorder: snapshot refers to unknown element with index " << index);
+  return elements[index];
+}
+}  // namespace
+
+InferenceRecorder::InferenceRecorder(ScMemoryContext * context, size_t maxDepth, size_t maxElementConnectors)
+  : context(context)
+  , maxDepth(maxDepth)
+  , maxElementConnectors(maxElementConnectors)
+{
+}
+
+std::string InferenceRecorder::Record(InferenceConfig const & config, InferenceParams const & params)
+{
+  elementsIndices.clear();
+  elementsContent.clear();
+
+  ScAddrVector requestElements{params.outputStructure, params.targetStructure};
+  requestElements.insert(requestElements.end(), params.arguments.cbegin(), params.arguments.cend());
+  requestElements.insert(requestElements.end(), params.inputStructures.cbegin(), params.inputStructures.cend());
+  RecordNeighbourhood(params.formulasSet, requestElements);
+
+  auto const & writeElement = [this](std::string & snapshot, ScAddr const & element)
+  {
+    Write(snapshot, element.IsValid() ? elementsIndices.at(element) : EMPTY_INDEX);
+  };
+
+  std::string snapshot;
+  Write(snapshot, MAGIC);
+  Write(snapshot, FORMAT_VERSION);
+  for (uint32_t const field :
+       {static_cast<uint32_t>(config.generationType),
+        static_cast<uint32_t>(config.replacementsUsingType),
+        static_cast<uint32_t>(config.solutionTreeType),
+        static_cast<uint32_t>(config.searchType),
+        static_cast<uint32_t>(config.fillingType),
+        static_cast<uint32_t>(config.atomicLogicalFormulaSearchBeforeGenerationType),
+        static_cast<uint32_t>(config.disjunctionComputationType),
+        static_cast<uint32_t>(config.searchResultsMemoizationType),
+        static_cast<uint32_t>(config.formulasApplicationType),
+        static_cast<uint32_t>(config.iterationType)})
+    Write(snapshot, field);
+  for (uint64_t const limit :
+       {static_cast<uint64_t>(params.budget.maxReplacementsColumns),
+        static_cast<uint64_t>(params.budget.maxGeneratedConstructions),
+        static_cast<uint64_t>(params.budget.timeLimit.count()),
+        static_cast<uint64_t>(params.budget.maxReplacementsMemory),
+        static_cast<uint64_t>(params.budget.maxRounds)})
+    Write(snapshot, limit);
+
+  Write(snapshot, static_cast<uint64_t>(elementsIndices.size()));
+  snapshot.append(elementsContent);
+
+  writeElement(snapshot, params.formulasSet);
+  Write(snapshot, static_cast<uint64_t>(params.arguments.size()));
+  for (ScAddr const & argument : params.arguments)
+    writeElement(snapshot, argument);
+  Write(snapshot, static_cast<uint64_t>(params.inputStructures.size()));
+  for (ScAddr const & inputStructure : params.inputStructures)
+    writeElement(snapshot, inputStructure);
+  writeElement(snapshot, params.outputStructure);
+  writeElement(snapshot, params.targetStructure);
+  return snapshot;
+}
+
+void InferenceRecorder::RecordToFile(
+    InferenceConfig const & config,
+    InferenceParams const & params,
+    std::string const & filePath)
+{
+  std::ofstream snapshotFile(filePath, std::ios::binary);
+  snapshotFile << Record(config, params);
+  if (!snapshotFile)
+    SC_THROW_EXCEPTION(utils::ExceptionInvalidState, "InferenceRecorder: snapshot is not written to " << filePath);
+}
+
+InferenceSnapshot InferenceRecorder::Load(ScMemoryContext * context, std::string const & snapshot)
+{
+  size_t position = 0;
+  uint32_t magic = 0;
+  uint32_t version = 0;
+  Read(snapshot, position, magic);
+  Read(snapshot, position, version);
+  if (magic != MAGIC || version != FORMAT_VERSION)
+    SC_THROW_EXCEPTION(
+        utils::ExceptionParseError, "InferenceRecorder: content is not a snapshot of version " << FORMAT_VERSION);
+
+  InferenceSnapshot result{};
+  InferenceConfig & config = result.config;
+  ReadEnum(snapshot, position, config.generationType);
+  ReadEnum(snapshot, position, config.replacementsUsingType);
+  ReadEnum(snapshot, position, config.solutionTreeType);
+  ReadEnum(snapshot, position, config.searchType);
+  ReadEnum(snapshot, position, config.fillingType);
+  ReadEnum(snapshot, position, config.atomicLogicalFormulaSearchBeforeGenerationType);
+  ReadEnum(snapshot, position, config.disjunctionComputationType);
+  ReadEnum(snapshot, position, config.searchResultsMemoizationType);
+  ReadEnum(snapshot, position, config.formulasApplicationType);
+  ReadEnum(snapshot, position, config.iterationType);
+
+  InferenceBudget & budget = result.params.budget;
+  uint64_t limit = 0;
+  Read(snapshot, position, limit);
+  budget.maxReplacementsColumns = limit;
+  Read(snapshot, position, limit);
+  budget.maxGeneratedConstructions = limit;
+  Read(snapshot, position, limit);
+  budget.timeLimit = std::chrono::milliseconds(limit);
+  Read(snapshot, position, limit);
+  budget.maxReplacementsMemory = limit;
+  Read(snapshot, position, limit);
+  budget.maxRounds = limit;
+
+  uint64_t elementsAmount = 0;
+  Read(snapshot, position, elementsAmount);
+  ScAddrVector elements;
+  for (uint64_t index = 0; index < elementsAmount; ++index)
+  {
+    uint32_t typeValue = 0;
+    Read(snapshot, position, typeValue);
+    ScType const type(static_cast<ScType::RealType>(typeValue));
+    ScAddr source;
+    ScAddr target;
+    std::string content;
+    if (type.IsConnector())
+    {
+      source = ReadElement(snapshot, position, elements);
+      target = ReadElement(snapshot, position, elements);
+    }
+    else if (type.IsLink())
+      ReadString(snapshot, position, content);
+    std::string systemIdentifier;
+    ReadString(snapshot, position, systemIdentifier);
+
+    // Keynodes and other identified elements of the knowledge base are not duplicated
+    ScAddr element;
+    if (!systemIdentifier.empty())
+      element = context->SearchElementBySystemIdentifier(systemIdentifier);
+    if (!element.IsValid())
+    {
+      if (type.IsConnector())
+        element = context->GenerateConnector(type, source, target);
+      else if (type.IsLink())
+      {
+        element = context->GenerateLink(type);
+        context->SetLinkContent(element, content);
+      }
+      else
+        element = context->GenerateNode(type);
+      if (!systemIdentifier.empty())
+        context->SetElementSystemIdentifier(systemIdentifier, element);
+    }
+    elements.push_back(element);
+  }
+
+  InferenceParams & params = result.params;
+  params.formulasSet = ReadElement(snapshot, position, elements);
+  uint64_t amount = 0;
+  Read(snapshot, position, amount);
+  for (uint64_t i = 0; i < amount; ++i)
+    params.arguments.push_back(ReadElement(snapshot, position, elements));
+  Read(snapshot, position, amount);
+  for (uint64_t i = 0; i < amount; ++i)
+    params.inputStructures.insert(ReadElement(snapshot, position, elements));
+  params.outputStructure = ReadElement(snapshot, position, elements);
+  params.targetStructure = ReadElement(snapshot, position, elements);
+  return result;
+}
+
+InferenceSnapshot InferenceRecorder::LoadFromFile(ScMemoryContext * context, std::string const & filePath)
+{
+  std::ifstream snapshotFile(filePath, std::ios::binary);
+  if (!snapshotFile)
+    SC_THROW_EXCEPTION(
+        utils::ExceptionItemNotFound, "InferenceRecorder: snapshot file " << filePath << " is not found");
+  std::string const snapshot{std::istreambuf_iterator<char>(snapshotFile), std::istreambuf_iterator<char>()};
+  return Load(context, snapshot);
+}
+
+/// Ends of connector are added before it, so that they exist when connector is generated by loading
+uint64_t InferenceRecorder::AddElement(ScAddr const & element)
+{
+  auto const & elementIt = elementsIndices.find(element);
+  if (elementIt != elementsIndices.cend())
+    return elementIt->second;
+
+  ScType const & type = context->GetElementType(element);
+  uint64_t sourceIndex = EMPTY_INDEX;
+  uint64_t targetIndex = EMPTY_INDEX;
+  if (type.IsConnector())
+  {
+    auto const [source, target] = context->GetConnectorIncidentElements(element);
+    sourceIndex = AddElement(source);
+    targetIndex = AddElement(target);
+  }
+
+  uint64_t const index = elementsIndices.size();
+  elementsIndices.emplace(element, index);
+  Write(elementsContent, static_cast<uint32_t>(static_cast<ScType::RealType>(type)));
+  if (type.IsConnector())
+  {
+    Write(elementsContent, sourceIndex);
+    Write(elementsContent, targetIndex);
+  }
+  else if (type.IsLink())
+  {
+    std::string content;
+    context->GetLinkContent(element, content);
+    WriteString(elementsContent, content);
+  }
+  WriteString(elementsContent, context->GetElementSystemIdentifier(element));
+  return index;
+}
+
+bool InferenceRecorder::GetConnectors(
+    ScAddr const & element,
+    size_t maxConnectors,
+    ScAddrVector & connectors,
+    size_t & outgoingConnectorsAmount) const
+{
+  connectors.clear();
+  ScIterator3Ptr const & outgoingIterator = context->CreateIterator3(element, ScType::Unknown, ScType::Unknown);
+  while (outgoingIterator->Next())
+  {
+    connectors.push_back(outgoingIterator->Get(1));
+    if (connectors.size() > maxConnectors)
+      return false;
+  }
+  outgoingConnectorsAmount = connectors.size();
+  ScIterator3Ptr const & incomingIterator = context->CreateIterator3(ScType::Unknown, ScType::Unknown, element);
+  while (incomingIterator->Next())
+  {
+    connectors.push_back(incomingIterator->Get(1));
+    if (connectors.size() > maxConnectors)
+      return false;
+  }
+  return true;
+}
+
+/**
+ * Elements are passed breadth first, connectors and their ends are one step further than element they are found for.
+ * Elements of request and formulas are needed to replay inference, so they are expanded whatever their depth and amount
+ * of connectors are. Formulas are reached from formulas set by outgoing connectors and by ends of connectors, like
+ * tuples of rules, rules and their implications, until formula structures, whose elements are passed as neighbourhood
+ */
+void InferenceRecorder::RecordNeighbourhood(ScAddr const & formulasSet, ScAddrVector const & requestElements)
+{
+  std::queue<std::tuple<ScAddr, size_t, ElementRole>> elementsQueue;
+  std::unordered_map<ScAddr, std::pair<size_t, ElementRole>, ScAddrHashFunc> visitedElements;
+  // Element is passed again if it is reached as element of formula or closer to request than before
+  auto const & visit = [&](ScAddr const & element, size_t depth, ElementRole role)
+  {
+    if (!element.IsValid())
+      return;
+    auto const & [visitedIterator, isNew] = visitedElements.try_emplace(element, depth, role);
+    auto & [visitedDepth, visitedRole] = visitedIterator->second;
+    if (!isNew && role <= visitedRole && (role != ElementRole::NEIGHBOURHOOD || depth >= visitedDepth))
+      return;
+    visitedDepth = depth;
+    visitedRole = role;
+    elementsQueue.emplace(element, depth, role);
+  };
+  visit(formulasSet, 0, ElementRole::FORMULA);
+  for (ScAddr const & element : requestElements)
+    visit(element, 0, ElementRole::REQUEST);
+
+  ScAddrVector connectors;
+  size_t outgoingConnectorsAmount = 0;
+  while (!elementsQueue.empty())
+  {
+    auto const [element, depth, role] = elementsQueue.front();
+    elementsQueue.pop();
+    AddElement(element);
+    bool const isExpanded = role != ElementRole::NEIGHBOURHOOD;
+    if (!isExpanded && depth == maxDepth)
+      continue;
+
+    // Depth of neighbourhood is counted from the nearest expanded element
+    size_t const neighbourDepth = isExpanded ? 1 : depth + 1;
+    ScType const & type = context->GetElementType(element);
+    bool const isFormula = role == ElementRole::FORMULA && type != ScType::ConstNodeStructure;
+    auto const & visitNeighbour = [&](ScAddr const & neighbour, bool isFormulaNeighbour)
+    {
+      if (isFormulaNeighbour)
+        visit(neighbour, 0, ElementRole::FORMULA);
+      else
+        visit(neighbour, neighbourDepth, ElementRole::NEIGHBOURHOOD);
+    };
+    if (type.IsConnector())
+    {
+      auto const [source, target] = context->GetConnectorIncidentElements(element);
+      visitNeighbour(source, isFormula);
+      visitNeighbour(target, isFormula);
+    }
+    size_t const maxConnectors = isExpanded ? std::numeric_limits<size_t>::max() : maxElementConnectors;
+    if (!GetConnectors(element, maxConnectors, connectors, outgoingConnectorsAmount))
+      continue;
+    for (size_t i = 0; i < connectors.size(); ++i)
+      visitNeighbour(connectors[i], isFormula && !type.IsConnector() && i < outgoingConnectorsAmount);
+  }
+}
+
+}  // namespace inference
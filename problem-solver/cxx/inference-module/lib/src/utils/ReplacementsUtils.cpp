@@ -6,17 +6,44 @@
 
 #include "inference/replacements_utils.hpp"
 
+#include <algorithm>
+
 #include <sc-memory/sc_agent.hpp>
 
 namespace inference
 {
+namespace
+{
+thread_local std::pmr::memory_resource * scratchResource = nullptr;
+}
+
+ReplacementsUtils::ScratchScope::ScratchScope()
+  : pool(std::make_unique<std::pmr::unsynchronized_pool_resource>())
+  , previousResource(scratchResource)
+{
+  scratchResource = pool.get();
+}
+
+ReplacementsUtils::ScratchScope::~ScratchScope()
+{
+  scratchResource = previousResource;
+}
+
+std::pmr::memory_resource * ReplacementsUtils::GetScratchResource()
+{
+  return scratchResource ? scratchResource : std::pmr::get_default_resource();
+}
 
+/**
+ * @brief Natural join of replacements. Value of common variable that is `ScAddr::Empty` after outer union is not
+ * bound, so such column is joined with columns of any value of this variable and result takes the bound value
+ */
 void ReplacementsUtils::IntersectReplacements(
     Replacements const & first,
     Replacements const & second,
     Replacements & intersection)
 {
-  std::vector<std::pair<size_t, size_t>> firstSecondPairs;
+  std::pmr::vector<std::pair<size_t, size_t>> firstSecondPairs(GetScratchResource());
   ScAddrUnorderedSet firstKeys;
   GetKeySet(first, firstKeys);
   ScAddrUnorderedSet secondKeys;
@@ -38,10 +65,39 @@ void ReplacementsUtils::IntersectReplacements(
   ScAddrUnorderedSet commonKeysSet;
   GetCommonKeys(firstKeys, secondKeys, commonKeysSet);
 
-  ReplacementsHashes firstHashes;
-  CalculateHashesForCommonKeys(first, commonKeysSet, firstHashes);
-  ReplacementsHashes secondHashes;
-  CalculateHashesForCommonKeys(second, commonKeysSet, secondHashes);
+  std::pmr::vector<size_t> firstUnboundColumns(GetScratchResource());
+  std::pmr::vector<size_t> secondUnboundColumns(GetScratchResource());
+  if (commonKeysSet.size() == 1)
+  {
+    // Columns are joined by one variable, so columns of second are found by binary search instead of hashing
+    ScAddr const & commonKey = *commonKeysSet.cbegin();
+    ScAddrVector const & firstRow = first.at(commonKey);
+    std::pmr::vector<std::pair<size_t, size_t>> secondColumns(GetScratchResource());
+    GetSortedColumns(second.at(commonKey), secondColumns, secondUnboundColumns);
+    for (size_t columnIndexInFirst = 0; columnIndexInFirst < firstAmountOfColumns; ++columnIndexInFirst)
+    {
+      if (!firstRow[columnIndexInFirst].IsValid())
+      {
+        firstUnboundColumns.push_back(columnIndexInFirst);
+        continue;
+      }
+      auto const & [begin, end] = std::equal_range(
+          secondColumns.cbegin(),
+          secondColumns.cend(),
+          std::make_pair(firstRow[columnIndexInFirst].Hash(), size_t(0)),
+          CompareValues);
+      for (auto secondColumn = begin; secondColumn != end; ++secondColumn)
+        firstSecondPairs.emplace_back(columnIndexInFirst, secondColumn->second);
+    }
+  }
+
+  ReplacementsHashes firstHashes(GetScratchResource());
+  ReplacementsHashes secondHashes(GetScratchResource());
+  if (commonKeysSet.size() != 1)
+  {
+    CalculateHashesForCommonKeys(first, commonKeysSet, firstHashes, firstUnboundColumns);
+    CalculateHashesForCommonKeys(second, commonKeysSet, secondHashes, secondUnboundColumns);
+  }
   for (auto const & firstHashPair : firstHashes)
   {
     auto const & secondHashPairIterator = secondHashes.find(firstHashPair.first);
@@ -66,6 +122,26 @@ void ReplacementsUtils::IntersectReplacements(
     }
   }
 
+  // Columns with unbound common variables come from disjunctions only, so they are compared with each column
+  for (size_t const columnIndexInFirst : firstUnboundColumns)
+  {
+    for (size_t columnIndexInSecond = 0; columnIndexInSecond < secondAmountOfColumns; ++columnIndexInSecond)
+    {
+      if (AreColumnsCompatible(first, columnIndexInFirst, second, columnIndexInSecond, commonKeysSet))
+        firstSecondPairs.emplace_back(columnIndexInFirst, columnIndexInSecond);
+    }
+  }
+  for (size_t const columnIndexInSecond : secondUnboundColumns)
+  {
+    for (size_t columnIndexInFirst = 0; columnIndexInFirst < firstAmountOfColumns; ++columnIndexInFirst)
+    {
+      // Pairs of two columns with unbound values are already added
+      if (!HasUnboundValues(first, columnIndexInFirst, commonKeysSet) &&
+          AreColumnsCompatible(first, columnIndexInFirst, second, columnIndexInSecond, commonKeysSet))
+        firstSecondPairs.emplace_back(columnIndexInFirst, columnIndexInSecond);
+    }
+  }
+
   Replacements result;
   for (ScAddr const & firstKey : firstKeys)
     result[firstKey].reserve(firstSecondPairs.size());
@@ -78,7 +154,13 @@ void ReplacementsUtils::IntersectReplacements(
   for (auto const & firstSecondPair : firstSecondPairs)
   {
     for (ScAddr const & firstKey : firstKeys)
-      result.at(firstKey).push_back(first.at(firstKey).at(firstSecondPair.first));
+    {
+      ScAddr const & firstValue = first.at(firstKey).at(firstSecondPair.first);
+      if (!firstValue.IsValid() && commonKeysSet.count(firstKey))
+        result.at(firstKey).push_back(second.at(firstKey).at(firstSecondPair.second));
+      else
+        result.at(firstKey).push_back(firstValue);
+    }
     for (ScAddr const & secondKey : secondKeys)
     {
       if (!commonKeysSet.count(secondKey))
@@ -86,9 +168,13 @@ void ReplacementsUtils::IntersectReplacements(
     }
   }
   RemoveDuplicateColumns(result);
-  intersection = result;
+  intersection = std::move(result);
 }
 
+/**
+ * @brief Columns of first that have no compatible column in second. Unbound value of common variable is compatible
+ * with any value of this variable, as in join of replacements
+ */
 void ReplacementsUtils::SubtractReplacements(
     Replacements const & first,
     Replacements const & second,
@@ -100,7 +186,7 @@ void ReplacementsUtils::SubtractReplacements(
   GetKeySet(second, secondKeys);
   size_t firstAmountOfColumns = GetColumnsAmount(first);
   size_t secondAmountOfColumns = GetColumnsAmount(second);
-  std::vector<size_t> firstColumns;
+  std::pmr::vector<size_t> firstColumns(GetScratchResource());
   firstColumns.reserve(firstAmountOfColumns);
 
   if (firstAmountOfColumns == 0 || secondAmountOfColumns == 0)
@@ -118,10 +204,35 @@ void ReplacementsUtils::SubtractReplacements(
     return;
   }
 
-  ReplacementsHashes firstHashes;
-  CalculateHashesForCommonKeys(first, commonKeysSet, firstHashes);
-  ReplacementsHashes secondHashes;
-  CalculateHashesForCommonKeys(second, commonKeysSet, secondHashes);
+  std::pmr::vector<size_t> firstUnboundColumns(GetScratchResource());
+  std::pmr::vector<size_t> secondUnboundColumns(GetScratchResource());
+  if (commonKeysSet.size() == 1)
+  {
+    // Columns are compared by one variable, so its values in second are found by binary search instead of hashing
+    ScAddr const & commonKey = *commonKeysSet.cbegin();
+    ScAddrVector const & firstRow = first.at(commonKey);
+    std::pmr::vector<std::pair<size_t, size_t>> secondColumns(GetScratchResource());
+    GetSortedColumns(second.at(commonKey), secondColumns, secondUnboundColumns);
+    for (size_t columnIndexInFirst = 0; columnIndexInFirst < firstAmountOfColumns; ++columnIndexInFirst)
+    {
+      if (!firstRow[columnIndexInFirst].IsValid())
+        firstUnboundColumns.push_back(columnIndexInFirst);
+      else if (!std::binary_search(
+                   secondColumns.cbegin(),
+                   secondColumns.cend(),
+                   std::make_pair(firstRow[columnIndexInFirst].Hash(), size_t(0)),
+                   CompareValues))
+        firstColumns.push_back(columnIndexInFirst);
+    }
+  }
+
+  ReplacementsHashes firstHashes(GetScratchResource());
+  ReplacementsHashes secondHashes(GetScratchResource());
+  if (commonKeysSet.size() != 1)
+  {
+    CalculateHashesForCommonKeys(first, commonKeysSet, firstHashes, firstUnboundColumns);
+    CalculateHashesForCommonKeys(second, commonKeysSet, secondHashes, secondUnboundColumns);
+  }
   for (auto const & firstHashPair : firstHashes)
   {
     auto const & secondHashPairIterator = secondHashes.find(firstHashPair.first);
@@ -153,6 +264,31 @@ void ReplacementsUtils::SubtractReplacements(
     }
   }
 
+  // Bound columns are left after comparison with bound columns of second, so they are compared with unbound ones
+  if (!secondUnboundColumns.empty())
+  {
+    auto const & hasCompatibleUnboundColumn = [&](size_t columnIndexInFirst) {
+      return std::any_of(
+          secondUnboundColumns.cbegin(),
+          secondUnboundColumns.cend(),
+          [&](size_t columnIndexInSecond) {
+            return AreColumnsCompatible(first, columnIndexInFirst, second, columnIndexInSecond, commonKeysSet);
+          });
+    };
+    firstColumns.erase(
+        std::remove_if(firstColumns.begin(), firstColumns.end(), hasCompatibleUnboundColumn), firstColumns.end());
+  }
+  for (size_t const columnIndexInFirst : firstUnboundColumns)
+  {
+    bool hasCompatibleColumn = false;
+    for (size_t columnIndexInSecond = 0; columnIndexInSecond < secondAmountOfColumns && !hasCompatibleColumn;
+         ++columnIndexInSecond)
+      hasCompatibleColumn =
+          AreColumnsCompatible(first, columnIndexInFirst, second, columnIndexInSecond, commonKeysSet);
+    if (!hasCompatibleColumn)
+      firstColumns.push_back(columnIndexInFirst);
+  }
+
   Replacements result;
   for (ScAddr const & firstKey : firstKeys)
     result[firstKey].reserve(firstColumns.size());
@@ -163,114 +299,88 @@ void ReplacementsUtils::SubtractReplacements(
       result.at(firstKey).push_back(first.at(firstKey).at(firstColumn));
   }
   RemoveDuplicateColumns(result);
-  difference = result;
+  difference = std::move(result);
 }
 
+/**
+ * @brief Outer union of replacements. Result has keys of both replacements, columns of one replacements are padded
+ * with `ScAddr::Empty` for keys that only other replacements have, that means such variables are not bound in this
+ * column. Identical columns are added once
+ */
 void ReplacementsUtils::UniteReplacements(
     Replacements const & first,
     Replacements const & second,
     Replacements & unionResult)
 {
-  ScAddrUnorderedSet firstKeys;
-  GetKeySet(first, firstKeys);
-  ScAddrUnorderedSet secondKeys;
-  GetKeySet(second, secondKeys);
-  ScAddrUnorderedSet commonKeysSet;
-  GetCommonKeys(firstKeys, secondKeys, commonKeysSet);
-  size_t firstAmountOfColumns = GetColumnsAmount(first);
+  size_t const firstAmountOfColumns = GetColumnsAmount(first);
   if (firstAmountOfColumns == 0)
   {
     unionResult = second;
     return;
   }
-  size_t secondAmountOfColumns = GetColumnsAmount(second);
+  size_t const secondAmountOfColumns = GetColumnsAmount(second);
   if (secondAmountOfColumns == 0)
   {
     unionResult = first;
     return;
   }
 
-  ReplacementsHashes firstHashes;
-  CalculateHashesForCommonKeys(first, commonKeysSet, firstHashes);
-  ReplacementsHashes secondHashes;
-  CalculateHashesForCommonKeys(second, commonKeysSet, secondHashes);
-  std::unordered_set<size_t> columnsFromSecondToSkip;
-
-  // insert into columnsFromSecondToSkip all column indices from second that are equal to at least one column from first
-  for (auto const & pairForFirst : firstHashes)
+  std::pmr::memory_resource * const resource = GetScratchResource();
+  std::pmr::vector<ScAddr> keys(resource);
+  keys.reserve(first.size() + second.size());
+  for (auto const & pair : first)
+    keys.push_back(pair.first);
+  for (auto const & pair : second)
   {
-    std::vector<size_t> const & columnsFromFirst = pairForFirst.second;
-    std::vector<size_t> const & columnsFromSecond =
-        secondHashes.count(pairForFirst.first) ? secondHashes.at(pairForFirst.first) : std::vector<size_t>();
-    for (auto const & columnFromSecond : columnsFromSecond)
-    {
-      bool isColumnFromSecondIdenticalToColumnFromFirst = true;
-      for (auto const & columnFromFirst : columnsFromFirst)
-      {
-        for (auto const & commonKey : commonKeysSet)
-        {
-          if (first.at(commonKey).at(columnFromFirst) != second.at(commonKey).at(columnFromSecond))
-            isColumnFromSecondIdenticalToColumnFromFirst = false;
-          break;
-        }
-        if (!isColumnFromSecondIdenticalToColumnFromFirst)
-          break;
-      }
-      if (isColumnFromSecondIdenticalToColumnFromFirst)
-        columnsFromSecondToSkip.insert(columnFromSecond);
-    }
+    if (!first.count(pair.first))
+      keys.push_back(pair.first);
   }
 
+  std::pmr::vector<ScAddrVector const *> firstRows(resource);
+  std::pmr::vector<ScAddrVector const *> secondRows(resource);
+  std::pmr::vector<ScAddrVector *> resultRows(resource);
   Replacements result;
-  // make all possible combinations for each column from first with each column from second with common keys values
-  // taken from first
-  for (auto const & pairForFirst : firstHashes)
+  for (ScAddr const & key : keys)
   {
-    std::vector<size_t> const & columnsFromFirst = pairForFirst.second;
-    for (auto const & columnFromFirst : columnsFromFirst)
-    {
-      for (auto const & firstKey : firstKeys)
-      {
-        std::vector<ScAddr> const sameValuesToInsert(
-            firstKeys.size() > commonKeysSet.size() ? secondAmountOfColumns : 1,
-            first.at(firstKey).at(columnFromFirst));
-        result[firstKey].insert(result.at(firstKey).cend(), sameValuesToInsert.cbegin(), sameValuesToInsert.cend());
-      }
-      for (auto const & secondKey : secondKeys)
-      {
-        if (!firstKeys.count(secondKey))
-          result[secondKey].insert(
-              result[secondKey].cend(), second.at(secondKey).cbegin(), second.at(secondKey).cend());
-      }
-    }
+    auto const & firstRow = first.find(key);
+    firstRows.push_back(firstRow == first.cend() ? nullptr : &firstRow->second);
+    auto const & secondRow = second.find(key);
+    secondRows.push_back(secondRow == second.cend() ? nullptr : &secondRow->second);
+    ScAddrVector & resultRow = result[key];
+    resultRow.reserve(firstAmountOfColumns + secondAmountOfColumns);
+    resultRows.push_back(&resultRow);
   }
 
-  // make all possible combinations for each column from second with each column from first with common keys values
-  // taken from second, skipping those columns from second that have same values as at least one column from first for
-  // each common key
-  for (auto const & pairForSecond : secondHashes)
-  {
-    std::vector<size_t> const & columnsFromSecond = pairForSecond.second;
-    for (auto const & columnFromSecond : columnsFromSecond)
+  ReplacementsHashes columnsByHash(resource);
+  columnsByHash.reserve(firstAmountOfColumns + secondAmountOfColumns);
+  size_t unitedAmountOfColumns = 0;
+  auto const & addColumn = [&](std::pmr::vector<ScAddrVector const *> const & rows, size_t columnIndex) {
+    auto const & value = [&rows, columnIndex](size_t keyIndex) {
+      return rows[keyIndex] ? (*rows[keyIndex])[columnIndex] : ScAddr::Empty;
+    };
+    size_t hash = 0;
+    for (size_t keyIndex = 0; keyIndex < keys.size(); ++keyIndex)
+      hash = CombineHash(hash, value(keyIndex).Hash());
+    std::pmr::vector<size_t> & columnsWithSameHash = columnsByHash[hash];
+    for (size_t const unitedColumnIndex : columnsWithSameHash)
     {
-      if (columnsFromSecondToSkip.count(columnFromSecond))
-        continue;
-      for (auto const & secondKey : secondKeys)
-      {
-        std::vector<ScAddr> const sameValuesToInsert(
-            secondKeys.size() > commonKeysSet.size() ? firstAmountOfColumns : 1,
-            second.at(secondKey).at(columnFromSecond));
-        result[secondKey].insert(result.at(secondKey).cend(), sameValuesToInsert.cbegin(), sameValuesToInsert.cend());
-      }
-      for (auto const & firstKey : firstKeys)
-      {
-        if (!secondKeys.count(firstKey))
-          result[firstKey].insert(result[firstKey].cend(), first.at(firstKey).cbegin(), first.at(firstKey).cend());
-      }
+      bool isSameColumn = true;
+      for (size_t keyIndex = 0; keyIndex < keys.size() && isSameColumn; ++keyIndex)
+        isSameColumn = (*resultRows[keyIndex])[unitedColumnIndex] == value(keyIndex);
+      if (isSameColumn)
+        return;
     }
-  }
-  RemoveDuplicateColumns(result);
-  unionResult = result;
+    for (size_t keyIndex = 0; keyIndex < keys.size(); ++keyIndex)
+      resultRows[keyIndex]->push_back(value(keyIndex));
+    columnsWithSameHash.push_back(unitedAmountOfColumns++);
+  };
+
+  for (size_t columnIndex = 0; columnIndex < firstAmountOfColumns; ++columnIndex)
+    addColumn(firstRows, columnIndex);
+  for (size_t columnIndex = 0; columnIndex < secondAmountOfColumns; ++columnIndex)
+    addColumn(secondRows, columnIndex);
+
+  unionResult = std::move(result);
 }
 
 void ReplacementsUtils::GetKeySet(Replacements const & map, ScAddrUnorderedSet & keySet)
@@ -305,7 +415,8 @@ Replacements ReplacementsUtils::CopyReplacements(Replacements const & replacemen
 }
 
 /**
- * @brief The size of the all ScAddrVector of variables is the same (it is a matrix)
+ * @brief The size of the all ScAddrVector of variables is the same (it is a matrix). Empty values are not added to
+ * params
  * @param replacements to convert to vector<ScTemplateParams>
  * @param templateParams out param, converted replacements will be placed here
  */
@@ -319,12 +430,18 @@ void ReplacementsUtils::GetReplacementsToScTemplateParams(
     return;
 
   size_t columnsAmount = replacements.begin()->second.size();
+  templateParams.reserve(templateParams.size() + columnsAmount);
   for (size_t columnIndex = 0; columnIndex < columnsAmount; ++columnIndex)
   {
     ScTemplateParams params;
     for (ScAddr const & key : keys)
-      params.Add(key, replacements.at(key).at(columnIndex));
-    templateParams.push_back(params);
+    {
+      // Variable is not bound in this column after outer union
+      ScAddr const & value = replacements.at(key).at(columnIndex);
+      if (value.IsValid())
+        params.Add(key, value);
+    }
+    templateParams.push_back(std::move(params));
   }
 }
 
@@ -333,74 +450,143 @@ size_t ReplacementsUtils::GetColumnsAmount(Replacements const & replacements)
   return (replacements.empty() ? 0 : replacements.begin()->second.size());
 }
 
+/// Identical columns are found by hash of all values of column, first of identical columns is kept
 void ReplacementsUtils::RemoveDuplicateColumns(Replacements & replacements)
 {
-  ScAddrUnorderedSet keys;
-  GetKeySet(replacements, keys);
-  if (keys.empty())
+  size_t const columnsAmount = GetColumnsAmount(replacements);
+  if (columnsAmount < 2)
     return;
-  ReplacementsHashes replacementsHashes;
-  CalculateHashesForCommonKeys(replacements, keys, replacementsHashes);
-  std::unordered_map<ScAddr, ScAddr, ScAddrHashFunc> column;
-  std::set<size_t> columnsToRemove;
-  for (auto const & replacementsHash : replacementsHashes)
+  std::pmr::memory_resource * const resource = GetScratchResource();
+  std::pmr::vector<ScAddrVector *> rows(resource);
+  rows.reserve(replacements.size());
+  for (auto & pair : replacements)
+    rows.push_back(&pair.second);
+
+  ReplacementsHashes columnsByHash(resource);
+  columnsByHash.reserve(columnsAmount);
+  size_t uniqueAmountOfColumns = 0;
+  for (size_t columnIndex = 0; columnIndex < columnsAmount; ++columnIndex)
   {
-    auto const & columnsForHash = replacementsHash.second;
-    if (columnsForHash.size() > 1)
+    size_t hash = 0;
+    for (ScAddrVector const * row : rows)
+      hash = CombineHash(hash, (*row)[columnIndex].Hash());
+    std::pmr::vector<size_t> & columnsWithSameHash = columnsByHash[hash];
+    bool isDuplicate = false;
+    for (size_t const uniqueColumnIndex : columnsWithSameHash)
     {
-      for (size_t firstColumnIndex = 0; firstColumnIndex < columnsForHash.size(); ++firstColumnIndex)
-      {
-        if (columnsToRemove.count(firstColumnIndex))
-          continue;
-        for (auto const & key : keys)
-          column[key] = replacements.at(key).at(columnsForHash[firstColumnIndex]);
-        for (size_t comparedColumnIndex = firstColumnIndex + 1; comparedColumnIndex < columnsForHash.size();
-             ++comparedColumnIndex)
-        {
-          if (columnsToRemove.count(comparedColumnIndex))
-            continue;
-          bool columnIsUnique = false;
-          for (auto const & key : keys)
-          {
-            if (column[key] != replacements.at(key).at(columnsForHash[comparedColumnIndex]))
-            {
-              columnIsUnique = true;
-              break;
-            }
-          }
-          if (!columnIsUnique)
-            columnsToRemove.insert(columnsForHash[comparedColumnIndex]);
-        }
-      }
+      isDuplicate = std::all_of(rows.cbegin(), rows.cend(), [uniqueColumnIndex, columnIndex](ScAddrVector const * row) {
+        return (*row)[uniqueColumnIndex] == (*row)[columnIndex];
+      });
+      if (isDuplicate)
+        break;
     }
-  }
-  for (auto columnToRemove = columnsToRemove.crbegin(); columnToRemove != columnsToRemove.crend(); columnToRemove++)
-  {
-    for (auto const & key : keys)
+    if (isDuplicate)
+      continue;
+    // Unique columns are moved to the beginning keeping their order
+    if (uniqueAmountOfColumns != columnIndex)
     {
-      ScAddrVector & replacementValues = replacements.at(key);
-      replacementValues.erase(replacementValues.begin() + static_cast<long>(*columnToRemove));
+      for (ScAddrVector * row : rows)
+        (*row)[uniqueAmountOfColumns] = (*row)[columnIndex];
     }
+    columnsWithSameHash.push_back(uniqueAmountOfColumns++);
   }
+  for (ScAddrVector * row : rows)
+    row->resize(uniqueAmountOfColumns);
 }
 
+/// Columns with unbound value of any common key are not hashed, they are added to unbound columns instead
 void ReplacementsUtils::CalculateHashesForCommonKeys(
     Replacements const & replacements,
     ScAddrUnorderedSet const & commonKeys,
-    ReplacementsHashes & hashes)
+    ReplacementsHashes & hashes,
+    std::pmr::vector<size_t> & unboundColumns)
 {
   size_t const columnsAmount = ReplacementsUtils::GetColumnsAmount(replacements);
-  size_t const commonKeysAmount = commonKeys.empty() ? 1 : commonKeys.size();
-  std::vector<size_t> primes = {7, 13, 17, 19, 31, 41, 43};
+  std::pmr::vector<ScAddrVector const *> commonRows(GetScratchResource());
+  commonRows.reserve(commonKeys.size());
+  for (auto const & commonKey : commonKeys)
+    commonRows.push_back(&replacements.at(commonKey));
+  hashes.reserve(columnsAmount);
   for (size_t columnNumber = 0; columnNumber < columnsAmount; ++columnNumber)
   {
-    int primeInd = 0;
-    size_t offsets = 0;
-    for (auto const & commonKey : commonKeys)
-      offsets +=
-          replacements.at(commonKey).at(columnNumber).GetRealAddr().offset * primes.at(primeInd++ % primes.size());
-    hashes[offsets / commonKeysAmount].push_back(columnNumber);
+    size_t hash = 0;
+    bool isBound = true;
+    for (ScAddrVector const * commonRow : commonRows)
+    {
+      ScAddr const & value = (*commonRow)[columnNumber];
+      isBound = value.IsValid();
+      if (!isBound)
+        break;
+      hash = CombineHash(hash, value.Hash());
+    }
+    if (isBound)
+      hashes[hash].push_back(columnNumber);
+    else
+      unboundColumns.push_back(columnNumber);
+  }
+}
+
+/**
+ * Pairs of value hash and column are sorted, hash of `ScAddr` is unique, so equal hashes mean equal values. Columns
+ * where value is not bound are added to unbound columns instead
+ */
+void ReplacementsUtils::GetSortedColumns(
+    ScAddrVector const & row,
+    std::pmr::vector<std::pair<size_t, size_t>> & columns,
+    std::pmr::vector<size_t> & unboundColumns)
+{
+  columns.reserve(row.size());
+  for (size_t columnIndex = 0; columnIndex < row.size(); ++columnIndex)
+  {
+    if (row[columnIndex].IsValid())
+      columns.emplace_back(row[columnIndex].Hash(), columnIndex);
+    else
+      unboundColumns.push_back(columnIndex);
   }
+  std::sort(columns.begin(), columns.end());
+}
+
+bool ReplacementsUtils::HasUnboundValues(
+    Replacements const & replacements,
+    size_t columnIndex,
+    ScAddrUnorderedSet const & keys)
+{
+  return std::any_of(keys.cbegin(), keys.cend(), [&replacements, columnIndex](ScAddr const & key) {
+    return !replacements.at(key).at(columnIndex).IsValid();
+  });
+}
+
+/// Columns are compatible if each common variable has equal values in both of them or is unbound in any of them
+bool ReplacementsUtils::AreColumnsCompatible(
+    Replacements const & first,
+    size_t columnIndexInFirst,
+    Replacements const & second,
+    size_t columnIndexInSecond,
+    ScAddrUnorderedSet const & commonKeys)
+{
+  return std::all_of(commonKeys.cbegin(), commonKeys.cend(), [&](ScAddr const & commonKey) {
+    ScAddr const & firstValue = first.at(commonKey).at(columnIndexInFirst);
+    ScAddr const & secondValue = second.at(commonKey).at(columnIndexInSecond);
+    return !firstValue.IsValid() || !secondValue.IsValid() || firstValue == secondValue;
+  });
+}
+
+bool ReplacementsUtils::CompareValues(std::pair<size_t, size_t> const & first, std::pair<size_t, size_t> const & second)
+{
+  return first.first < second.first;
+}
+
+size_t ReplacementsUtils::CombineHash(size_t seed, size_t value)
+{
+  return seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+}
+
+size_t ReplacementsUtils::ColumnHashFunc::operator()(ScAddrVector const & column) const
+{
+  size_t hash = 0;
+  for (ScAddr const & value : column)
+    hash = CombineHash(hash, value.Hash());
+  return hash;
 }
 
 Replacements ReplacementsUtils::removeRows(Replacements const & replacements, ScAddrUnorderedSet & keysToRemove)
@@ -414,4 +600,20 @@ Replacements ReplacementsUtils::removeRows(Replacements const & replacements, Sc
   }
   return result;
 }
+
+/// Keep only rows of the given keys, columns that become identical are added once
+void ReplacementsUtils::ProjectReplacements(
+    Replacements const & replacements,
+    ScAddrUnorderedSet const & keys,
+    Replacements & projection)
+{
+  Replacements result;
+  for (auto const & replacement : replacements)
+  {
+    if (keys.count(replacement.first))
+      result.emplace(replacement);
+  }
+  RemoveDuplicateColumns(result);
+  projection = std::move(result);
+}
 }  // namespace inference
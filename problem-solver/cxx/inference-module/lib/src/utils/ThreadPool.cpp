@@ -0,0 +1,87 @@
+/*
+ * This source file is part of an OSTIS project. For the latest info, see http://ostis.net
+ * Distributed under the MIT License
+ * (See accompanying file COPYING.MIT or copy at http://opensource.org/licenses/MIT)
+ */
+
+#include "inference/thread_pool.hpp"
+
+#include <algorithm>
+
+using namespace inference;
+
+namespace
+{
+thread_local ThreadPool const * currentPool = nullptr;
+thread_local size_t currentWorkerIndex = 0;
+}  // namespace
+
+ThreadPool::ThreadPool(size_t workersAmount)
+{
+  workersAmount = std::max<size_t>(workersAmount, 1);
+  workersContexts.resize(workersAmount);
+  workers.reserve(workersAmount);
+  for (size_t i = 0; i < workersAmount; ++i)
+    workers.emplace_back(&ThreadPool::Run, this, i);
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    isStopped = true;
+  }
+  condition.notify_all();
+  for (std::thread & worker : workers)
+    worker.join();
+}
+
+size_t ThreadPool::GetWorkersAmount() const
+{
+  return workers.size();
+}
+
+ScMemoryContext * ThreadPool::GetWorkerContext()
+{
+  if (currentPool != this)
+    return nullptr;
+  std::unique_ptr<ScMemoryContext> & workerContext = workersContexts[currentWorkerIndex];
+  if (!workerContext)
+    workerContext = std::make_unique<ScMemoryContext>();
+  return workerContext.get();
+}
+
+bool ThreadPool::RunPendingTask()
+{
+  std::function<void()> task;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (tasks.empty())
+      return false;
+    task = std::move(tasks.front());
+    tasks.pop();
+  }
+  task();
+  return true;
+}
+
+void ThreadPool::Run(size_t workerIndex)
+{
+  currentPool = this;
+  currentWorkerIndex = workerIndex;
+  while (true)
+  {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      condition.wait(lock, [this]() {
+        return isStopped || !tasks.empty();
+      });
+      if (isStopped && tasks.empty())
+        return;
+      task = std::move(tasks.front());
+      tasks.pop();
+    }
+    task();
+  }
+}
@@ -7,7 +7,19 @@
 #include "InferenceModule.hpp"
 
 #include <inference/direct_inference_agent.hpp>
+#include <inference/cancel_inference_agent.hpp>
+#include <inference/inference_service.hpp>
 
 using namespace inference;
 
-SC_MODULE_REGISTER(InferenceModule)->Agent<DirectInferenceAgent>();
+SC_MODULE_REGISTER(InferenceModule)->Agent<DirectInferenceAgent>()->Agent<CancelInferenceAgent>();
+
+void InferenceModule::Initialize(ScMemoryContext * context)
+{
+  InferenceService::GetInstance().Start();
+}
+
+void InferenceModule::Shutdown(ScMemoryContext * context)
+{
+  InferenceService::GetInstance().Stop();
+}
@@ -10,4 +10,8 @@
 
 class InferenceModule : public ScModule
 {
+public:
+  void Initialize(ScMemoryContext * context) override;
+
+  void Shutdown(ScMemoryContext * context) override;
 };
@@ -0,0 +1,148 @@
+/*
+ * This source file is part of an OSTIS project. For the latest info, see http://ostis.net
+ * Distributed under the MIT License
+ * (See accompanying file COPYING.MIT or copy at http://opensource.org/licenses/MIT)
+ */
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include <sc-memory/sc_memory.hpp>
+
+#include <inference/inference_manager_factory.hpp>
+#include <inference/inference_recorder.hpp>
+
+using namespace inference;
+
+namespace
+{
+std::string const USAGE =
+    "Usage: inference-replay <snapshot> [--storage <directory>] [--trace <file>] [--profile <file>] "
+    "[--time-limit <milliseconds>]\n"
+    "Loads snapshot recorded by InferenceRecorder into clean sc-memory and applies inference of recorded request.\n"
+    "  --storage     directory of sc-memory storage, it is cleared before loading\n"
+    "  --trace       file to write executed operators tree of applied formulas to\n"
+    "  --profile     file to write sc-memory calls of applied formulas to in Chrome trace event format\n"
+    "  --time-limit  time limit of inference run instead of recorded one\n";
+
+struct ReplayOptions
+{
+  std::string snapshotFilePath;
+  std::string storagePath = "replay-kb.bin";
+  InferenceExplainParams explain;
+  std::chrono::milliseconds timeLimit = std::chrono::milliseconds::zero();
+};
+
+bool ParseOptions(int argc, char ** argv, ReplayOptions & options)
+{
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string const option = argv[i];
+    if (option.rfind("--", 0) != 0)
+    {
+      options.snapshotFilePath = option;
+      continue;
+    }
+    if (i + 1 == argc)
+      return false;
+    std::string const value = argv[++i];
+    if (option == "--storage")
+      options.storagePath = value;
+    else if (option == "--trace")
+      options.explain.traceFilePath = value;
+    else if (option == "--profile")
+      options.explain.memoryProfileFilePath = value;
+    else if (option == "--time-limit")
+    {
+      if (value.empty() || value.find_first_not_of("0123456789") != std::string::npos)
+        return false;
+      try
+      {
+        options.timeLimit = std::chrono::milliseconds(std::stoull(value));
+      }
+      catch (std::out_of_range const &)
+      {
+        return false;
+      }
+    }
+    else
+      return false;
+  }
+  return !options.snapshotFilePath.empty();
+}
+
+int Replay(ReplayOptions const & options)
+{
+  ScMemoryContext context;
+  utils::ScLogger logger;
+
+  auto const loadingStart = std::chrono::steady_clock::now();
+  InferenceSnapshot snapshot = InferenceRecorder::LoadFromFile(&context, options.snapshotFilePath);
+  auto const loadingDuration = std::chrono::steady_clock::now() - loadingStart;
+
+  InferenceParams & params = snapshot.params;
+  if (!params.outputStructure.IsValid())
+    params.outputStructure = context.GenerateNode(ScType::ConstNodeStructure);
+  params.explain = options.explain;
+  if (options.timeLimit != std::chrono::milliseconds::zero())
+    params.budget.timeLimit = options.timeLimit;
+
+  // Target manager is used by inference agents, requests without target are applied by all formulas
+  std::unique_ptr<InferenceManagerAbstract> inferenceManager =
+      params.targetStructure.IsValid()
+          ? InferenceManagerFactory::ConstructDirectInferenceManagerTarget(&context, &logger, snapshot.config)
+          : InferenceManagerFactory::ConstructDirectInferenceManagerAll(&context, &logger, snapshot.config);
+
+  auto const inferenceStart = std::chrono::steady_clock::now();
+  bool const result = inferenceManager->ApplyInference(params);
+  auto const inferenceDuration = std::chrono::steady_clock::now() - inferenceStart;
+
+  size_t outputStructureSize = 0;
+  ScIterator3Ptr const & outputIterator =
+      context.CreateIterator3(params.outputStructure, ScType::ConstPermPosArc, ScType::Unknown);
+  while (outputIterator->Next())
+    ++outputStructureSize;
+
+  using Milliseconds = std::chrono::duration<double, std::milli>;
+  std::cout << "snapshot loading: " << Milliseconds(loadingDuration).count() << " ms\n"
+            << "inference: " << Milliseconds(inferenceDuration).count() << " ms\n"
+            << "result: " << (result ? "true" : "false") << "\n"
+            << "rounds: " << inferenceManager->GetRoundsAmount() << "\n"
+            << "budget exhausted: " << (inferenceManager->IsBudgetExhausted() ? "true" : "false") << "\n"
+            << "output structure elements: " << outputStructureSize << std::endl;
+  return 0;
+}
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  ReplayOptions options;
+  if (!ParseOptions(argc, argv, options))
+  {
+    std::cerr << USAGE;
+    return 1;
+  }
+
+  sc_memory_params memoryParams;
+  sc_memory_params_clear(&memoryParams);
+  memoryParams.clear = SC_TRUE;
+  memoryParams.storage = options.storagePath.c_str();
+  ScMemory::Initialize(memoryParams);
+
+  int exitCode;
+  try
+  {
+    exitCode = Replay(options);
+  }
+  catch (utils::ScException const & exception)
+  {
+    std::cerr << exception.Message() << std::endl;
+    exitCode = 1;
+  }
+
+  ScMemory::Shutdown(false);
+  return exitCode;
+}
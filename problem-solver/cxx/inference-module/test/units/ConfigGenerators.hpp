@@ -51,4 +51,34 @@ public:
   }
 };
 
+class ConfigGeneratorCheckReplacementsExistence : public ConfigGenerator
+{
+public:
+  virtual InferenceConfig getInferenceConfig(InferenceConfig inferenceConfig) const override
+  {
+    inferenceConfig.atomicLogicalFormulaSearchBeforeGenerationType = CHECK_REPLACEMENTS_EXISTENCE;
+    return inferenceConfig;
+  }
+
+  virtual std::string getName() const override
+  {
+    return "ConfigGeneratorCheckReplacementsExistence";
+  }
+};
+
+class ConfigGeneratorPipelinedApplication : public ConfigGenerator
+{
+public:
+  virtual InferenceConfig getInferenceConfig(InferenceConfig inferenceConfig) const override
+  {
+    inferenceConfig.formulasApplicationType = APPLY_PIPELINED;
+    return inferenceConfig;
+  }
+
+  virtual std::string getName() const override
+  {
+    return "ConfigGeneratorPipelinedApplication";
+  }
+};
+
 }  // namespace inference::generatorTest
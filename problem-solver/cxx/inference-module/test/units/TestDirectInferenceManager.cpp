@@ -10,7 +10,13 @@
 #include <sc-builder/scs_loader.hpp>
 #include <sc-agents-common/utils/IteratorUtils.hpp>
 
+#include "classifier/FormulaMetadataCache.hpp"
+
+#include <chrono>
+#include <thread>
+
 #include <inference/inference_manager_factory.hpp>
+#include <inference/inference_service.hpp>
 
 #include <inference/inference_keynodes.hpp>
 
@@ -35,7 +41,8 @@ class InferenceManagerTest
 std::shared_ptr<generatorTest::ConfigGenerator> generators[] = {
     std::make_shared<generatorTest::ConfigGenerator>(),
     std::make_shared<generatorTest::ConfigGeneratorSearchWithReplacements>(),
-    std::make_shared<generatorTest::ConfigGeneratorSearchWithoutReplacements>()};
+    std::make_shared<generatorTest::ConfigGeneratorSearchWithoutReplacements>(),
+    std::make_shared<generatorTest::ConfigGeneratorCheckReplacementsExistence>()};
 
 INSTANTIATE_TEST_SUITE_P(
     InferenceManagerTestInitiator,
@@ -388,4 +395,136 @@ TEST_P(InferenceManagerTest, conclusionContainsArcReplacementFromPremise)
   }
 }
 
+using InferenceServiceTest = ScMemoryTest;
+
+TEST_F(InferenceServiceTest, ManagersShareFormulasMetadataUntilRulesChange)
+{
+  ScMemoryContext & context = *m_ctx;
+
+  loader.loadScsFile(context, TEST_FILES_DIR_PATH + "trueSimpleRuleTest.scs");
+
+  ScAddr targetTemplate = context.ResolveElementSystemIdentifier(TARGET_TEMPLATE);
+  ScAddr ruleSet = context.ResolveElementSystemIdentifier(RULES_SET);
+  ScAddr argumentSet = context.ResolveElementSystemIdentifier(ARGUMENT_SET);
+  ScAddr inputStructure = context.ResolveElementSystemIdentifier(INPUT_STRUCTURE);
+
+  InferenceService & service = InferenceService::GetInstance();
+  service.Start();
+
+  InferenceConfig const & inferenceConfig{
+      GENERATE_UNIQUE_FORMULAS, REPLACEMENTS_FIRST, TREE_ONLY_OUTPUT_STRUCTURE, SEARCH_IN_STRUCTURES};
+  ScAddrVector const & argumentVector = utils::IteratorUtils::getAllWithType(&context, argumentSet, ScType::Node);
+  utils::ScLogger logger;
+  for (size_t i = 0; i < 2; ++i)
+  {
+    ScAddr const & outputStructure = context.GenerateNode(ScType::ConstNodeStructure);
+    InferenceParams const & inferenceParams{ruleSet, argumentVector, {inputStructure}, outputStructure, targetTemplate};
+    std::unique_ptr<InferenceManagerAbstract> inferenceManager =
+        service.ConstructDirectInferenceManagerTarget(&context, &logger, inferenceConfig, ruleSet);
+    EXPECT_TRUE(inferenceManager->ApplyInference(inferenceParams));
+  }
+
+  std::shared_ptr<FormulaMetadataCache> const & cache = service.GetFormulaMetadataCache();
+  ASSERT_NE(cache, nullptr);
+  size_t const cachedFormulasAmount = cache->Size();
+  EXPECT_GT(cachedFormulasAmount, 0u);
+  EXPECT_EQ(service.GetWatchedFormulasSetsAmount(), 1u);
+  size_t const watchedFormulasAmount = service.GetWatchedFormulasAmount();
+
+  ScIterator3Ptr const & rulesIterator = context.CreateIterator3(ruleSet, ScType::ConstPermPosArc, ScType::Node);
+  ASSERT_TRUE(rulesIterator->Next());
+  ScAddr const & rules = rulesIterator->Get(2);
+  // Formula added to the set doesn't invalidate metadata of other formulas
+  context.GenerateConnector(ScType::ConstPermPosArc, rules, context.GenerateNode(ScType::ConstNode));
+
+  // Premise and conclusion of formula that leaves all sets are not watched anymore, events are processed
+  // asynchronously
+  ScIterator3Ptr const & ruleIterator = context.CreateIterator3(
+      rules, ScType::ConstPermPosArc, context.SearchElementBySystemIdentifier("logic_rule"));
+  ASSERT_TRUE(ruleIterator->Next());
+  context.EraseElement(ruleIterator->Get(1));
+  for (size_t i = 0; i < 100 && service.GetWatchedFormulasAmount() == watchedFormulasAmount; ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_LT(service.GetWatchedFormulasAmount(), watchedFormulasAmount);
+  EXPECT_LT(cache->Size(), cachedFormulasAmount);
+
+  service.Stop();
+  EXPECT_FALSE(service.IsRunning());
+  EXPECT_EQ(service.GetFormulaMetadataCache(), nullptr);
+}
+
+TEST_F(InferenceServiceTest, ChangesOfFormulasAndAddedSubsetsInvalidateMetadata)
+{
+  ScMemoryContext & context = *m_ctx;
+
+  loader.loadScsFile(context, TEST_FILES_DIR_PATH + "trueSimpleRuleTest.scs");
+
+  ScAddr targetTemplate = context.ResolveElementSystemIdentifier(TARGET_TEMPLATE);
+  ScAddr ruleSet = context.ResolveElementSystemIdentifier(RULES_SET);
+  ScAddr argumentSet = context.ResolveElementSystemIdentifier(ARGUMENT_SET);
+  ScAddr inputStructure = context.ResolveElementSystemIdentifier(INPUT_STRUCTURE);
+  ScAddr const & premise = context.SearchElementBySystemIdentifier("if");
+  ScAddr const & conclusion = context.SearchElementBySystemIdentifier("then");
+
+  InferenceService & service = InferenceService::GetInstance();
+  service.Start();
+
+  InferenceConfig const & inferenceConfig{
+      GENERATE_UNIQUE_FORMULAS, REPLACEMENTS_FIRST, TREE_ONLY_OUTPUT_STRUCTURE, SEARCH_IN_STRUCTURES};
+  ScAddrVector const & argumentVector = utils::IteratorUtils::getAllWithType(&context, argumentSet, ScType::Node);
+  utils::ScLogger logger;
+  ScAddr const & outputStructure = context.GenerateNode(ScType::ConstNodeStructure);
+  InferenceParams const & inferenceParams{ruleSet, argumentVector, {inputStructure}, outputStructure, targetTemplate};
+  std::unique_ptr<InferenceManagerAbstract> inferenceManager =
+      service.ConstructDirectInferenceManagerTarget(&context, &logger, inferenceConfig, ruleSet);
+  EXPECT_TRUE(inferenceManager->ApplyInference(inferenceParams));
+
+  std::shared_ptr<FormulaMetadataCache> const & cache = service.GetFormulaMetadataCache();
+  ASSERT_NE(cache, nullptr);
+  EXPECT_GT(service.GetWatchedFormulasAmount(), 0u);
+  std::shared_ptr<FormulaMetadata const> const premiseMetadata = cache->Get(&context, premise);
+  std::shared_ptr<FormulaMetadata const> const conclusionMetadata = cache->Get(&context, conclusion);
+  ASSERT_EQ(premiseMetadata->variablesClasses.size(), 1u);
+  EXPECT_EQ(
+      premiseMetadata->variablesClasses[0].second,
+      ScAddrVector{context.SearchElementBySystemIdentifier("current_node_class")});
+
+  // Change of atomic logical formula invalidates only its metadata, events are processed asynchronously
+  context.GenerateConnector(ScType::ConstPermPosArc, premise, context.GenerateNode(ScType::ConstNode));
+  for (size_t i = 0; i < 100 && cache->Get(&context, premise) == premiseMetadata; ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_NE(cache->Get(&context, premise), premiseMetadata);
+  EXPECT_EQ(cache->Get(&context, conclusion), conclusionMetadata);
+
+  // Subset added to formulas set after it was watched is watched too
+  EXPECT_EQ(service.GetWatchedSetsAmount(), 2u);
+  ScAddr const & addedRules = context.GenerateNode(ScType::ConstNode);
+  context.GenerateConnector(ScType::ConstPermPosArc, ruleSet, addedRules);
+  for (size_t i = 0; i < 100 && service.GetWatchedSetsAmount() != 3; ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_EQ(service.GetWatchedSetsAmount(), 3u);
+
+  // Formula is watched while it is in any watched set
+  ScAddr const & logicRule = context.SearchElementBySystemIdentifier("logic_rule");
+  ScAddr const & addedRuleArc = context.GenerateConnector(ScType::ConstPermPosArc, addedRules, logicRule);
+  size_t const watchedFormulasAmount = service.GetWatchedFormulasAmount();
+  context.EraseElement(addedRuleArc);
+  ScIterator3Ptr const & addedRulesArcIterator = context.CreateIterator3(ruleSet, ScType::ConstPermPosArc, addedRules);
+  ASSERT_TRUE(addedRulesArcIterator->Next());
+  context.EraseElement(addedRulesArcIterator->Get(1));
+  for (size_t i = 0; i < 100 && service.GetWatchedSetsAmount() != 2; ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_EQ(service.GetWatchedSetsAmount(), 2u);
+  EXPECT_EQ(service.GetWatchedFormulasAmount(), watchedFormulasAmount);
+
+  ScIterator3Ptr const & ruleArcIterator = context.CreateIterator3(ScType::Node, ScType::ConstPermPosArc, logicRule);
+  ASSERT_TRUE(ruleArcIterator->Next());
+  context.EraseElement(ruleArcIterator->Get(1));
+  for (size_t i = 0; i < 100 && service.GetWatchedFormulasAmount() == watchedFormulasAmount; ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_LT(service.GetWatchedFormulasAmount(), watchedFormulasAmount);
+
+  service.Stop();
+}
+
 }  // namespace directInferenceManagerTest
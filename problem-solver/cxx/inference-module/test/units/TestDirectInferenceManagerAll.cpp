@@ -6,6 +6,9 @@
 
 #include "ConfigGenerators.hpp"
 
+#include <algorithm>
+#include <thread>
+
 #include <sc-memory/test/sc_test.hpp>
 #include <sc-builder/scs_loader.hpp>
 
@@ -13,8 +16,17 @@
 #include <sc-agents-common/utils/GenerationUtils.hpp>
 
 #include <inference/inference_manager_factory.hpp>
+#include <inference/solution_tree_expander.hpp>
 
 #include <inference/inference_keynodes.hpp>
+#include <inference/inference_cancellation.hpp>
+#include <inference/inference_recorder.hpp>
+
+#include <sc-memory-profiler/sc_memory_profiled_context.hpp>
+#include <sc-memory-profiler/sc_memory_profiler.hpp>
+
+#include "logic/AtomSearchResultsMemo.hpp"
+#include "logic/ExplainTrace.hpp"
 
 namespace inference::inferenceManagerBuilderTest
 {
@@ -38,7 +50,9 @@ class InferenceManagerBuilderTest
 std::shared_ptr<generatorTest::ConfigGenerator> generators[] = {
     std::make_shared<generatorTest::ConfigGenerator>(),
     std::make_shared<generatorTest::ConfigGeneratorSearchWithReplacements>(),
-    std::make_shared<generatorTest::ConfigGeneratorSearchWithoutReplacements>()};
+    std::make_shared<generatorTest::ConfigGeneratorSearchWithoutReplacements>(),
+    std::make_shared<generatorTest::ConfigGeneratorCheckReplacementsExistence>(),
+    std::make_shared<generatorTest::ConfigGeneratorPipelinedApplication>()};
 
 INSTANTIATE_TEST_SUITE_P(
     InferenceManagerBuilderTestInitiator,
@@ -312,6 +326,377 @@ TEST_P(InferenceManagerBuilderTest, GenerateFirst)
   EXPECT_FALSE(targetClassIterator->Next());
 }
 
+// Test if inference is stopped when generated constructions limit is reached
+TEST_P(InferenceManagerBuilderTest, GeneratedConstructionsLimitStopsInference)
+{
+  ScMemoryContext & context = *m_ctx;
+
+  loader.loadScsFile(context, TEST_FILES_DIR_PATH + "generateNotFirstTest.scs");
+
+  ScAddr const & inputStructure1 = context.ResolveElementSystemIdentifier(INPUT_STRUCTURE1);
+  ScAddr const & inputStructure2 = context.ResolveElementSystemIdentifier(INPUT_STRUCTURE2);
+  ScAddrUnorderedSet inputStructures{inputStructure1, inputStructure2};
+  ScAddr const & argument = context.ResolveElementSystemIdentifier(ARGUMENT);
+  ScAddrVector arguments{argument};
+  for (size_t i = 2; i < 6; i++)
+  {
+    arguments.push_back(context.ResolveElementSystemIdentifier(ARGUMENT + std::to_string(i)));
+  }
+  ScAddr const & rulesSet = context.ResolveElementSystemIdentifier(FORMULAS_SET);
+  ScAddr const & outputStructure = context.GenerateNode(ScType::ConstNodeStructure);
+
+  InferenceConfig const & inferenceConfig = GetParam()->getInferenceConfig(
+      {GENERATE_ALL_FORMULAS, REPLACEMENTS_ALL, TREE_ONLY_OUTPUT_STRUCTURE, SEARCH_IN_STRUCTURES});
+  utils::ScLogger logger;
+  std::unique_ptr<inference::InferenceManagerAbstract> iterationStrategy =
+      inference::InferenceManagerFactory::ConstructDirectInferenceManagerAll(&context, &logger, inferenceConfig);
+
+  InferenceParams inferenceParams{rulesSet, arguments, inputStructures, outputStructure};
+  inferenceParams.budget.maxGeneratedConstructions = 2;
+  bool result = iterationStrategy->ApplyInference(inferenceParams);
+
+  EXPECT_TRUE(result);
+  EXPECT_TRUE(iterationStrategy->IsBudgetExhausted());
+  ScAddr const & solution = iterationStrategy->GetSolutionTreeManager()->GenerateSolution(outputStructure, result);
+  EXPECT_TRUE(context.CheckConnector(InferenceKeynodes::concept_success_solution, solution, ScType::ConstPermPosArc));
+  EXPECT_TRUE(context.CheckConnector(InferenceKeynodes::concept_partial_solution, solution, ScType::ConstPermPosArc));
+
+  // Expect to generate only 2 times of 5
+  ScAddr const & targetClass = context.SearchElementBySystemIdentifier(TARGET_NODE_CLASS);
+  ScAddrVector const & generatedElements = utils::IteratorUtils::getAllWithType(&context, targetClass, ScType::ConstNode);
+  EXPECT_EQ(generatedElements.size(), 2u);
+}
+
+// Test if cancelled inference doesn't generate anything and its solution is partial
+TEST_P(InferenceManagerBuilderTest, CancelledInferenceGeneratesPartialSolution)
+{
+  ScMemoryContext & context = *m_ctx;
+
+  loader.loadScsFile(context, TEST_FILES_DIR_PATH + "generateNotFirstTest.scs");
+
+  ScAddr const & inputStructure1 = context.ResolveElementSystemIdentifier(INPUT_STRUCTURE1);
+  ScAddr const & inputStructure2 = context.ResolveElementSystemIdentifier(INPUT_STRUCTURE2);
+  ScAddr const & argument = context.ResolveElementSystemIdentifier(ARGUMENT);
+  ScAddr const & rulesSet = context.ResolveElementSystemIdentifier(FORMULAS_SET);
+  ScAddr const & outputStructure = context.GenerateNode(ScType::ConstNodeStructure);
+
+  InferenceConfig const & inferenceConfig = GetParam()->getInferenceConfig(
+      {GENERATE_ALL_FORMULAS, REPLACEMENTS_ALL, TREE_ONLY_OUTPUT_STRUCTURE, SEARCH_IN_STRUCTURES});
+  utils::ScLogger logger;
+  std::unique_ptr<inference::InferenceManagerAbstract> iterationStrategy =
+      inference::InferenceManagerFactory::ConstructDirectInferenceManagerAll(&context, &logger, inferenceConfig);
+  auto const & cancellationToken = std::make_shared<CancellationToken>();
+  cancellationToken->Cancel();
+  iterationStrategy->SetCancellationToken(cancellationToken);
+
+  InferenceParams const & inferenceParams{rulesSet, {argument}, {inputStructure1, inputStructure2}, outputStructure};
+  bool result = iterationStrategy->ApplyInference(inferenceParams);
+
+  EXPECT_FALSE(result);
+  EXPECT_TRUE(iterationStrategy->IsBudgetExhausted());
+  ScAddr const & solution = iterationStrategy->GetSolutionTreeManager()->GenerateSolution(outputStructure, result);
+  EXPECT_TRUE(context.CheckConnector(InferenceKeynodes::concept_partial_solution, solution, ScType::ConstPermPosArc));
+
+  ScAddr const & targetClass = context.SearchElementBySystemIdentifier(TARGET_NODE_CLASS);
+  EXPECT_FALSE(context.CreateIterator3(targetClass, ScType::ConstPermPosArc, ScType::ConstNode)->Next());
+}
+
+// Test if all fixed arguments of formula are bound together in one row of template params
+TEST_P(InferenceManagerBuilderTest, FixedArgumentsAreBoundTogether)
+{
+  ScMemoryContext & context = *m_ctx;
+
+  loader.loadScsFile(context, TEST_FILES_DIR_PATH + "fixedArgumentsTest.scs");
+
+  ScAddr const & argument = context.ResolveElementSystemIdentifier(ARGUMENT);
+  ScAddr const & argument2 = context.ResolveElementSystemIdentifier(ARGUMENT + "2");
+  ScAddr const & formulasSet = context.ResolveElementSystemIdentifier(FORMULAS_SET);
+  ScAddr const & outputStructure = context.GenerateNode(ScType::ConstNodeStructure);
+  InferenceParams const & inferenceParams{formulasSet, {argument, argument2}, {}, outputStructure};
+
+  InferenceConfig const & inferenceConfig = GetParam()->getInferenceConfig(
+      {GENERATE_UNIQUE_FORMULAS, REPLACEMENTS_ALL, TREE_ONLY_OUTPUT_STRUCTURE, SEARCH_IN_ALL_KB});
+  utils::ScLogger logger;
+  std::unique_ptr<inference::InferenceManagerAbstract> iterationStrategy =
+      inference::InferenceManagerFactory::ConstructDirectInferenceManagerAll(&context, &logger, inferenceConfig);
+
+  bool result = iterationStrategy->ApplyInference(inferenceParams);
+  EXPECT_TRUE(result);
+
+  // Conclusion is generated only for the pair of arguments, not for every pair with one of them
+  ScAddr const & inverseRelation = context.SearchElementBySystemIdentifier("nrel_inverse_relation");
+  ScIterator3Ptr const & inverseRelationIterator =
+      context.CreateIterator3(inverseRelation, ScType::ConstPermPosArc, ScType::ConstCommonArc);
+  EXPECT_TRUE(inverseRelationIterator->Next());
+  auto const & [source, target] = context.GetConnectorIncidentElements(inverseRelationIterator->Get(2));
+  EXPECT_EQ(source, argument2);
+  EXPECT_EQ(target, argument);
+  EXPECT_FALSE(inverseRelationIterator->Next());
+}
+
+// Test if formulas are reapplied until nothing is generated and only formulas with touched premises are reapplied
+TEST_P(InferenceManagerBuilderTest, IterateUntilFixpoint)
+{
+  ScMemoryContext & context = *m_ctx;
+
+  loader.loadScsFile(context, TEST_FILES_DIR_PATH + "fixpointTest.scs");
+
+  ScAddr const & argument = context.ResolveElementSystemIdentifier(ARGUMENT);
+  ScAddr const & formulasSet = context.ResolveElementSystemIdentifier(FORMULAS_SET);
+  ScAddr const & outputStructure = context.GenerateNode(ScType::ConstNodeStructure);
+  InferenceParams const & inferenceParams{formulasSet, {}, {}, outputStructure};
+
+  InferenceConfig inferenceConfig = GetParam()->getInferenceConfig(
+      {GENERATE_UNIQUE_FORMULAS, REPLACEMENTS_ALL, TREE_ONLY_OUTPUT_STRUCTURE, SEARCH_IN_ALL_KB});
+  inferenceConfig.iterationType = ITERATE_UNTIL_FIXPOINT;
+  utils::ScLogger logger;
+  std::unique_ptr<inference::InferenceManagerAbstract> iterationStrategy =
+      inference::InferenceManagerFactory::ConstructDirectInferenceManagerAll(&context, &logger, inferenceConfig);
+
+  bool result = iterationStrategy->ApplyInference(inferenceParams);
+  EXPECT_TRUE(result);
+  EXPECT_FALSE(iterationStrategy->IsBudgetExhausted());
+  // The third round is not started because nothing depends on formula generated in the second round
+  EXPECT_EQ(iterationStrategy->GetRoundsAmount(), 2u);
+
+  ScAddr const & class2 = context.SearchElementBySystemIdentifier("class_2");
+  ScAddr const & class3 = context.SearchElementBySystemIdentifier("class_3");
+  EXPECT_TRUE(context.CheckConnector(class2, argument, ScType::ConstPermPosArc));
+  EXPECT_TRUE(context.CheckConnector(class3, argument, ScType::ConstPermPosArc));
+}
+
+// Test if formulas are reapplied when conclusion generated in the last round has variable class
+TEST_P(InferenceManagerBuilderTest, VariableClassInConclusionTouchesAllFormulas)
+{
+  ScMemoryContext & context = *m_ctx;
+
+  loader.loadScsFile(context, TEST_FILES_DIR_PATH + "fixpointVariableClassTest.scs");
+
+  ScAddr const & argument = context.ResolveElementSystemIdentifier(ARGUMENT);
+  ScAddr const & formulasSet = context.ResolveElementSystemIdentifier(FORMULAS_SET);
+  ScAddr const & outputStructure = context.GenerateNode(ScType::ConstNodeStructure);
+  InferenceParams const & inferenceParams{formulasSet, {}, {}, outputStructure};
+
+  InferenceConfig inferenceConfig = GetParam()->getInferenceConfig(
+      {GENERATE_UNIQUE_FORMULAS, REPLACEMENTS_ALL, TREE_ONLY_OUTPUT_STRUCTURE, SEARCH_IN_ALL_KB});
+  inferenceConfig.iterationType = ITERATE_UNTIL_FIXPOINT;
+  utils::ScLogger logger;
+  std::unique_ptr<inference::InferenceManagerAbstract> iterationStrategy =
+      inference::InferenceManagerFactory::ConstructDirectInferenceManagerAll(&context, &logger, inferenceConfig);
+
+  bool result = iterationStrategy->ApplyInference(inferenceParams);
+  EXPECT_TRUE(result);
+  // Conclusion of the second formula has no constants, but it adds argument to class of premise of the first formula
+  EXPECT_EQ(iterationStrategy->GetRoundsAmount(), 2u);
+
+  ScAddr const & class2 = context.SearchElementBySystemIdentifier("class_2");
+  ScAddr const & class3 = context.SearchElementBySystemIdentifier("class_3");
+  EXPECT_TRUE(context.CheckConnector(class2, argument, ScType::ConstPermPosArc));
+  EXPECT_TRUE(context.CheckConnector(class3, argument, ScType::ConstPermPosArc));
+}
+
+TEST_P(InferenceManagerBuilderTest, VariableClassInConclusionInvalidatesMemoizedSearchResults)
+{
+  ScMemoryContext & context = *m_ctx;
+
+  loader.loadScsFile(context, TEST_FILES_DIR_PATH + "fixpointVariableClassTest.scs");
+
+  ScAddr const & argument = context.ResolveElementSystemIdentifier(ARGUMENT);
+  ScAddr const & formulasSet = context.ResolveElementSystemIdentifier(FORMULAS_SET);
+  ScAddr const & outputStructure = context.GenerateNode(ScType::ConstNodeStructure);
+  InferenceParams const & inferenceParams{formulasSet, {}, {}, outputStructure};
+
+  InferenceConfig inferenceConfig = GetParam()->getInferenceConfig(
+      {GENERATE_UNIQUE_FORMULAS, REPLACEMENTS_ALL, TREE_ONLY_OUTPUT_STRUCTURE, SEARCH_IN_ALL_KB});
+  inferenceConfig.iterationType = ITERATE_UNTIL_FIXPOINT;
+  inferenceConfig.searchResultsMemoizationType = MEMOIZE_SEARCH_RESULTS;
+  utils::ScLogger logger;
+  std::unique_ptr<inference::InferenceManagerAbstract> iterationStrategy =
+      inference::InferenceManagerFactory::ConstructDirectInferenceManagerAll(&context, &logger, inferenceConfig);
+
+  bool result = iterationStrategy->ApplyInference(inferenceParams);
+  EXPECT_TRUE(result);
+
+  // Empty search result of the first premise is memoized before the second formula adds argument to its class
+  ScAddr const & class2 = context.SearchElementBySystemIdentifier("class_2");
+  ScAddr const & class3 = context.SearchElementBySystemIdentifier("class_3");
+  EXPECT_TRUE(context.CheckConnector(class2, argument, ScType::ConstPermPosArc));
+  EXPECT_TRUE(context.CheckConnector(class3, argument, ScType::ConstPermPosArc));
+}
+
+// Test if inference is stopped when rounds limit is reached before fixpoint
+TEST_P(InferenceManagerBuilderTest, RoundsLimitStopsIterationUntilFixpoint)
+{
+  ScMemoryContext & context = *m_ctx;
+
+  loader.loadScsFile(context, TEST_FILES_DIR_PATH + "fixpointTest.scs");
+
+  ScAddr const & argument = context.ResolveElementSystemIdentifier(ARGUMENT);
+  ScAddr const & formulasSet = context.ResolveElementSystemIdentifier(FORMULAS_SET);
+  ScAddr const & outputStructure = context.GenerateNode(ScType::ConstNodeStructure);
+  InferenceParams inferenceParams{formulasSet, {}, {}, outputStructure};
+  inferenceParams.budget.maxRounds = 1;
+
+  InferenceConfig inferenceConfig = GetParam()->getInferenceConfig(
+      {GENERATE_UNIQUE_FORMULAS, REPLACEMENTS_ALL, TREE_ONLY_OUTPUT_STRUCTURE, SEARCH_IN_ALL_KB});
+  inferenceConfig.iterationType = ITERATE_UNTIL_FIXPOINT;
+  utils::ScLogger logger;
+  std::unique_ptr<inference::InferenceManagerAbstract> iterationStrategy =
+      inference::InferenceManagerFactory::ConstructDirectInferenceManagerAll(&context, &logger, inferenceConfig);
+
+  bool result = iterationStrategy->ApplyInference(inferenceParams);
+  EXPECT_TRUE(result);
+  EXPECT_TRUE(iterationStrategy->IsBudgetExhausted());
+  EXPECT_EQ(iterationStrategy->GetRoundsAmount(), 1u);
+
+  ScAddr const & class2 = context.SearchElementBySystemIdentifier("class_2");
+  ScAddr const & class3 = context.SearchElementBySystemIdentifier("class_3");
+  EXPECT_TRUE(context.CheckConnector(class2, argument, ScType::ConstPermPosArc));
+  EXPECT_FALSE(context.CheckConnector(class3, argument, ScType::ConstPermPosArc));
+}
+
+// Test if executed operators of applied formula are recorded and connected with solution
+TEST_P(InferenceManagerBuilderTest, ExplainTraceIsConnectedWithSolution)
+{
+  ScMemoryContext & context = *m_ctx;
+
+  loader.loadScsFile(context, TEST_FILES_DIR_PATH + "singleApplyTest.scs");
+
+  ScAddr const & inputStructure1 = context.ResolveElementSystemIdentifier(INPUT_STRUCTURE1);
+  ScAddr const & inputStructure2 = context.ResolveElementSystemIdentifier(INPUT_STRUCTURE2);
+  ScAddr const & argument = context.ResolveElementSystemIdentifier(ARGUMENT);
+  ScAddr const & outputStructure = context.GenerateNode(ScType::ConstNodeStructure);
+  ScAddr const & formulasSet = context.ResolveElementSystemIdentifier(FORMULAS_SET);
+  InferenceParams inferenceParams{formulasSet, {argument}, {inputStructure1, inputStructure2}, outputStructure};
+  inferenceParams.explain.generateTraceStructure = true;
+
+  InferenceConfig const & inferenceConfig = GetParam()->getInferenceConfig(
+      {GENERATE_ALL_FORMULAS, REPLACEMENTS_ALL, TREE_ONLY_OUTPUT_STRUCTURE, SEARCH_IN_STRUCTURES});
+  utils::ScLogger logger;
+  std::unique_ptr<inference::InferenceManagerAbstract> iterationStrategy =
+      inference::InferenceManagerFactory::ConstructDirectInferenceManagerAll(&context, &logger, inferenceConfig);
+
+  bool result = iterationStrategy->ApplyInference(inferenceParams);
+  EXPECT_TRUE(result);
+
+  // Formula is an implication with atomic premise and conclusion
+  std::shared_ptr<ExplainTrace const> const & explainTrace = iterationStrategy->GetExplainTrace();
+  ASSERT_NE(explainTrace, nullptr);
+  std::vector<ExplainTrace::Operator> const & operators = explainTrace->GetOperators();
+  ASSERT_EQ(explainTrace->GetRoots().size(), 1u);
+  ExplainTrace::Operator const & formulaOperator = operators[explainTrace->GetRoots()[0]];
+  EXPECT_EQ(formulaOperator.name, "formula");
+  EXPECT_EQ(formulaOperator.formulaIdentifier, "logic_rule");
+  ASSERT_EQ(formulaOperator.children.size(), 1u);
+  ExplainTrace::Operator const & implicationOperator = operators[formulaOperator.children[0]];
+  EXPECT_EQ(implicationOperator.name, "implication");
+  ASSERT_EQ(implicationOperator.children.size(), 2u);
+  EXPECT_EQ(operators[implicationOperator.children[0]].name, "search");
+  ExplainTrace::Operator const & generateOperator = operators[implicationOperator.children[1]];
+  EXPECT_EQ(generateOperator.name, "generate");
+  EXPECT_GT(generateOperator.generatedAmount, 0u);
+
+  ScAddr const & solution = iterationStrategy->GetSolutionTreeManager()->GenerateSolution(outputStructure, result);
+  ScIterator5Ptr const & solutionTraceIterator = context.CreateIterator5(
+      solution,
+      ScType::ConstCommonArc,
+      ScType::ConstNodeStructure,
+      ScType::ConstPermPosArc,
+      InferenceKeynodes::nrel_inference_trace);
+  ASSERT_TRUE(solutionTraceIterator->Next());
+  ScAddr const & traceStructure = solutionTraceIterator->Get(2);
+  EXPECT_TRUE(context.CheckConnector(
+      traceStructure, context.SearchElementBySystemIdentifier("logic_rule"), ScType::ConstPermPosArc));
+}
+
+TEST_P(InferenceManagerBuilderTest, MemoryCallsAreProfiledByFormulas)
+{
+  ScMemoryContext & context = *m_ctx;
+
+  loader.loadScsFile(context, TEST_FILES_DIR_PATH + "singleApplyTest.scs");
+
+  ScAddr const & inputStructure1 = context.ResolveElementSystemIdentifier(INPUT_STRUCTURE1);
+  ScAddr const & inputStructure2 = context.ResolveElementSystemIdentifier(INPUT_STRUCTURE2);
+  ScAddr const & argument = context.ResolveElementSystemIdentifier(ARGUMENT);
+  ScAddr const & outputStructure = context.GenerateNode(ScType::ConstNodeStructure);
+  ScAddr const & formulasSet = context.ResolveElementSystemIdentifier(FORMULAS_SET);
+  InferenceParams inferenceParams{formulasSet, {argument}, {inputStructure1, inputStructure2}, outputStructure};
+  inferenceParams.explain.profileMemoryCalls = true;
+
+  InferenceConfig const & inferenceConfig = GetParam()->getInferenceConfig(
+      {GENERATE_ALL_FORMULAS, REPLACEMENTS_ALL, TREE_ONLY_OUTPUT_STRUCTURE, SEARCH_IN_STRUCTURES});
+  utils::ScLogger logger;
+  std::unique_ptr<inference::InferenceManagerAbstract> iterationStrategy =
+      inference::InferenceManagerFactory::ConstructDirectInferenceManagerAll(&context, &logger, inferenceConfig);
+
+  EXPECT_TRUE(iterationStrategy->ApplyInference(inferenceParams));
+
+  std::shared_ptr<utils::ScMemoryProfiler const> const & memoryProfiler = iterationStrategy->GetMemoryProfiler();
+  ASSERT_NE(memoryProfiler, nullptr);
+  auto const & statistics = memoryProfiler->GetStatistics();
+  ScAddr const & formula = context.SearchElementBySystemIdentifier("logic_rule");
+  ASSERT_EQ(statistics.count(formula), 1u);
+  utils::ScMemoryProfiler::FormulaStatistics const & formulaStatistics = statistics.at(formula);
+  EXPECT_GT(formulaStatistics[static_cast<size_t>(utils::ScMemoryCallType::BUILD_TEMPLATE)].callsAmount, 0u);
+  EXPECT_GT(formulaStatistics[static_cast<size_t>(utils::ScMemoryCallType::SEARCH_BY_TEMPLATE)].callsAmount, 0u);
+  EXPECT_GT(formulaStatistics[static_cast<size_t>(utils::ScMemoryCallType::GENERATE_BY_TEMPLATE)].callsAmount, 0u);
+  EXPECT_NE(memoryProfiler->ToChromeTrace(&context).find("\"formula\":\"logic_rule\""), std::string::npos);
+}
+
+TEST_P(InferenceManagerBuilderTest, RecordedInferenceIsReplayedFromSnapshot)
+{
+  ScMemoryContext & context = *m_ctx;
+
+  loader.loadScsFile(context, TEST_FILES_DIR_PATH + "singleApplyTest.scs");
+
+  ScAddr const & inputStructure1 = context.ResolveElementSystemIdentifier(INPUT_STRUCTURE1);
+  ScAddr const & inputStructure2 = context.ResolveElementSystemIdentifier(INPUT_STRUCTURE2);
+  ScAddr const & argument = context.ResolveElementSystemIdentifier(ARGUMENT);
+  ScAddr const & outputStructure = context.GenerateNode(ScType::ConstNodeStructure);
+  ScAddr const & formulasSet = context.ResolveElementSystemIdentifier(FORMULAS_SET);
+  InferenceParams inferenceParams{formulasSet, {argument}, {inputStructure1, inputStructure2}, outputStructure};
+  inferenceParams.budget.maxRounds = 3;
+
+  InferenceConfig const & inferenceConfig = GetParam()->getInferenceConfig(
+      {GENERATE_ALL_FORMULAS, REPLACEMENTS_ALL, TREE_ONLY_OUTPUT_STRUCTURE, SEARCH_IN_STRUCTURES});
+  InferenceRecorder recorder(&context);
+  std::string const & snapshotContent = recorder.Record(inferenceConfig, inferenceParams);
+
+  // Snapshot is loaded into cleared sc-memory, so that inference is replayed without the rest of knowledge base
+  m_ctx->Destroy();
+  Shutdown();
+  Initialize();
+  m_ctx = std::make_unique<ScAgentContext>();
+  ScMemoryContext & replayContext = *m_ctx;
+  EXPECT_FALSE(replayContext.SearchElementBySystemIdentifier(FORMULAS_SET).IsValid());
+
+  InferenceSnapshot const & snapshot = InferenceRecorder::Load(&replayContext, snapshotContent);
+  EXPECT_EQ(replayContext.GetElementSystemIdentifier(snapshot.params.formulasSet), FORMULAS_SET);
+  ASSERT_EQ(snapshot.params.arguments.size(), 1u);
+  ScAddr const & replayedArgument = snapshot.params.arguments.front();
+  EXPECT_EQ(replayContext.GetElementSystemIdentifier(replayedArgument), ARGUMENT);
+  EXPECT_EQ(
+      snapshot.params.inputStructures,
+      (ScAddrUnorderedSet{
+          replayContext.SearchElementBySystemIdentifier(INPUT_STRUCTURE1),
+          replayContext.SearchElementBySystemIdentifier(INPUT_STRUCTURE2)}));
+  ASSERT_TRUE(snapshot.params.outputStructure.IsValid());
+  EXPECT_FALSE(snapshot.params.targetStructure.IsValid());
+  EXPECT_EQ(snapshot.params.budget.maxRounds, 3u);
+  EXPECT_EQ(snapshot.config.searchType, inferenceConfig.searchType);
+  EXPECT_EQ(snapshot.config.iterationType, inferenceConfig.iterationType);
+
+  utils::ScLogger logger;
+  std::unique_ptr<inference::InferenceManagerAbstract> iterationStrategy =
+      inference::InferenceManagerFactory::ConstructDirectInferenceManagerAll(&replayContext, &logger, snapshot.config);
+  EXPECT_TRUE(iterationStrategy->ApplyInference(snapshot.params));
+  ScAddr const & targetClass = replayContext.SearchElementBySystemIdentifier(TARGET_NODE_CLASS);
+  EXPECT_TRUE(replayContext.CheckConnector(targetClass, replayedArgument, ScType::ConstPermPosArc));
+
+  std::string const & truncatedSnapshotContent = snapshotContent.substr(0, snapshotContent.size() / 2);
+  EXPECT_THROW(InferenceRecorder::Load(&replayContext, truncatedSnapshotContent), utils::ScException);
+}
+
 TEST_P(InferenceManagerBuilderTest, notGenerateSolutionTree)
 {
   ScMemoryContext & context = *m_ctx;
@@ -382,6 +767,195 @@ TEST_P(InferenceManagerBuilderTest, GenerateSolutionTree)
   EXPECT_TRUE(context.CheckConnector(targetClass, argument, ScType::ConstPermPosArc));
 }
 
+TEST_P(InferenceManagerBuilderTest, GenerateCompactSolutionTreeAndExpand)
+{
+  ScMemoryContext & context = *m_ctx;
+
+  loader.loadScsFile(context, TEST_FILES_DIR_PATH + "singleApplyTest.scs");
+
+  ScAddr const & inputStructure1 = context.ResolveElementSystemIdentifier(INPUT_STRUCTURE1);
+  ScAddr const & inputStructure2 = context.ResolveElementSystemIdentifier(INPUT_STRUCTURE2);
+  ScAddrUnorderedSet inputStructures{inputStructure1, inputStructure2};
+  ScAddr const & argument = context.ResolveElementSystemIdentifier(ARGUMENT);
+  ScAddr const & outputStructure = context.GenerateNode(ScType::ConstNodeStructure);
+  ScAddr const & formulasSet = context.ResolveElementSystemIdentifier(FORMULAS_SET);
+  InferenceParams const & inferenceParams{formulasSet, {argument}, inputStructures, outputStructure};
+
+  InferenceConfig const & inferenceConfig =
+      GetParam()->getInferenceConfig({GENERATE_ALL_FORMULAS, REPLACEMENTS_ALL, TREE_COMPACT, SEARCH_IN_STRUCTURES});
+  utils::ScLogger logger;
+  std::unique_ptr<inference::InferenceManagerAbstract> iterationStrategy =
+      inference::InferenceManagerFactory::ConstructDirectInferenceManagerAll(&context, &logger, inferenceConfig);
+
+  bool result = iterationStrategy->ApplyInference(inferenceParams);
+  EXPECT_TRUE(result);
+
+  ScAddr const & solution = iterationStrategy->GetSolutionTreeManager()->GenerateSolution(outputStructure, result);
+  EXPECT_TRUE(context.CheckConnector(InferenceKeynodes::concept_success_solution, solution, ScType::ConstPermPosArc));
+
+  // Replacements are packed into link, variables are not connected with their values
+  ScAddr const & variable = context.SearchElementBySystemIdentifier("_arg");
+  SolutionTreeExpander expander(&context);
+  ScAddr solutionNode = utils::IteratorUtils::getAnyByOutRelation(&context, solution, ScKeynodes::rrel_1);
+  EXPECT_TRUE(solutionNode.IsValid());
+  EXPECT_TRUE(expander.IsCompactSolutionNode(solutionNode));
+  ScAddr replacements = utils::IteratorUtils::getAnyByOutRelation(&context, solutionNode, ScKeynodes::rrel_2);
+  EXPECT_TRUE(context.GetElementType(replacements).IsLink());
+  EXPECT_FALSE(context.CheckConnector(variable, argument, ScType::ConstTempPosArc));
+
+  EXPECT_TRUE(expander.Expand(solution));
+  EXPECT_FALSE(expander.Expand(solution));
+
+  solutionNode = utils::IteratorUtils::getAnyByOutRelation(&context, solution, ScKeynodes::rrel_1);
+  EXPECT_TRUE(solutionNode.IsValid());
+  EXPECT_FALSE(expander.IsCompactSolutionNode(solutionNode));
+  EXPECT_FALSE(utils::IteratorUtils::getNextFromSet(&context, solution, solutionNode).IsValid());
+  replacements = utils::IteratorUtils::getAnyByOutRelation(&context, solutionNode, ScKeynodes::rrel_2);
+  EXPECT_TRUE(utils::IteratorUtils::getAnyFromSet(&context, replacements).IsValid());
+  EXPECT_TRUE(context.CheckConnector(variable, argument, ScType::ConstTempPosArc));
+}
+
+TEST_P(InferenceManagerBuilderTest, ComputeDisjunctionInParallel)
+{
+  ScMemoryContext & context = *m_ctx;
+
+  loader.loadScsFile(context, TEST_FILES_DIR_PATH + "parallelDisjunctionTest.scs");
+
+  ScAddr const & inputStructure1 = context.ResolveElementSystemIdentifier(INPUT_STRUCTURE1);
+  ScAddr const & outputStructure = context.GenerateNode(ScType::ConstNodeStructure);
+  ScAddr const & formulasSet = context.ResolveElementSystemIdentifier(FORMULAS_SET);
+  InferenceParams inferenceParams{formulasSet, {}, {inputStructure1}, outputStructure};
+  inferenceParams.explain.generateTraceStructure = true;
+
+  InferenceConfig inferenceConfig = GetParam()->getInferenceConfig(
+      {GENERATE_ALL_FORMULAS, REPLACEMENTS_ALL, TREE_ONLY_OUTPUT_STRUCTURE, SEARCH_IN_STRUCTURES});
+  inferenceConfig.disjunctionComputationType = COMPUTE_IN_PARALLEL;
+  utils::ScLogger logger;
+  std::unique_ptr<inference::InferenceManagerAbstract> iterationStrategy =
+      inference::InferenceManagerFactory::ConstructDirectInferenceManagerAll(&context, &logger, inferenceConfig);
+
+  bool result = iterationStrategy->ApplyInference(inferenceParams);
+  EXPECT_TRUE(result);
+
+  // Every argument satisfies one of disjuncts
+  ScAddr const & targetClass = context.SearchElementBySystemIdentifier(TARGET_NODE_CLASS);
+  ScAddrVector arguments{context.SearchElementBySystemIdentifier(ARGUMENT)};
+  for (size_t i = 2; i < 6; i++)
+    arguments.push_back(context.SearchElementBySystemIdentifier(ARGUMENT + std::to_string(i)));
+  for (ScAddr const & argument : arguments)
+    EXPECT_TRUE(context.CheckConnector(targetClass, argument, ScType::ConstPermPosArc));
+
+  // Disjuncts searched by pool workers are added to explain trace of disjunction
+  std::shared_ptr<ExplainTrace const> const & explainTrace = iterationStrategy->GetExplainTrace();
+  ASSERT_NE(explainTrace, nullptr);
+  std::vector<ExplainTrace::Operator> const & operators = explainTrace->GetOperators();
+  auto const & disjunctionOperator =
+      std::find_if(operators.cbegin(), operators.cend(), [](ExplainTrace::Operator const & traceOperator) {
+        return traceOperator.name == "disjunction";
+      });
+  ASSERT_NE(disjunctionOperator, operators.cend());
+  ASSERT_EQ(disjunctionOperator->children.size(), 4u);
+  for (size_t const child : disjunctionOperator->children)
+  {
+    EXPECT_EQ(operators[child].name, "search");
+    EXPECT_GT(operators[child].rowsAmount, 0u);
+  }
+}
+
+TEST_P(InferenceManagerBuilderTest, ConjunctionWithNegationFiltersReplacements)
+{
+  ScMemoryContext & context = *m_ctx;
+
+  loader.loadScsFile(context, TEST_FILES_DIR_PATH + "conjunctionWithNegationTest.scs");
+
+  ScAddr const & inputStructure1 = context.ResolveElementSystemIdentifier(INPUT_STRUCTURE1);
+  ScAddr const & outputStructure = context.GenerateNode(ScType::ConstNodeStructure);
+  ScAddr const & formulasSet = context.ResolveElementSystemIdentifier(FORMULAS_SET);
+  InferenceParams const & inferenceParams{formulasSet, {}, {inputStructure1}, outputStructure};
+
+  InferenceConfig const & inferenceConfig = GetParam()->getInferenceConfig(
+      {GENERATE_ALL_FORMULAS, REPLACEMENTS_ALL, TREE_ONLY_OUTPUT_STRUCTURE, SEARCH_IN_STRUCTURES});
+  utils::ScLogger logger;
+  std::unique_ptr<inference::InferenceManagerAbstract> iterationStrategy =
+      inference::InferenceManagerFactory::ConstructDirectInferenceManagerAll(&context, &logger, inferenceConfig);
+
+  bool result = iterationStrategy->ApplyInference(inferenceParams);
+  EXPECT_TRUE(result);
+
+  // Only arguments that are not in the excluded class are generated into the target class
+  ScAddr const & targetClass = context.SearchElementBySystemIdentifier(TARGET_NODE_CLASS);
+  EXPECT_TRUE(context.CheckConnector(
+      targetClass, context.SearchElementBySystemIdentifier(ARGUMENT), ScType::ConstPermPosArc));
+  EXPECT_FALSE(context.CheckConnector(
+      targetClass, context.SearchElementBySystemIdentifier(ARGUMENT + "2"), ScType::ConstPermPosArc));
+  EXPECT_TRUE(context.CheckConnector(
+      targetClass, context.SearchElementBySystemIdentifier(ARGUMENT + "3"), ScType::ConstPermPosArc));
+}
+
+// Test if replacements of negated conjunction are not limited, so that anti-join doesn't keep excluded bindings
+TEST_P(InferenceManagerBuilderTest, NegatedConjunctionIsNotLimitedByBudget)
+{
+  ScMemoryContext & context = *m_ctx;
+
+  loader.loadScsFile(context, TEST_FILES_DIR_PATH + "negatedConjunctionUnderBudgetTest.scs");
+
+  ScAddr const & inputStructure1 = context.ResolveElementSystemIdentifier(INPUT_STRUCTURE1);
+  ScAddr const & outputStructure = context.GenerateNode(ScType::ConstNodeStructure);
+  ScAddr const & formulasSet = context.ResolveElementSystemIdentifier(FORMULAS_SET);
+  InferenceParams inferenceParams{formulasSet, {}, {inputStructure1}, outputStructure};
+  // Premise conjunct has 3 replacements, negated conjunction has 6
+  inferenceParams.budget.maxReplacementsColumns = 3;
+
+  InferenceConfig const & inferenceConfig = GetParam()->getInferenceConfig(
+      {GENERATE_ALL_FORMULAS, REPLACEMENTS_ALL, TREE_ONLY_OUTPUT_STRUCTURE, SEARCH_IN_STRUCTURES});
+  utils::ScLogger logger;
+  std::unique_ptr<inference::InferenceManagerAbstract> iterationStrategy =
+      inference::InferenceManagerFactory::ConstructDirectInferenceManagerAll(&context, &logger, inferenceConfig);
+
+  bool result = iterationStrategy->ApplyInference(inferenceParams);
+  EXPECT_TRUE(iterationStrategy->IsBudgetExhausted());
+  ScAddr const & solution = iterationStrategy->GetSolutionTreeManager()->GenerateSolution(outputStructure, result);
+  EXPECT_TRUE(context.CheckConnector(InferenceKeynodes::concept_partial_solution, solution, ScType::ConstPermPosArc));
+
+  // Negated replacements exceed limit, so nothing is generated instead of generating excluded argument
+  ScAddr const & targetClass = context.SearchElementBySystemIdentifier(TARGET_NODE_CLASS);
+  EXPECT_FALSE(context.CheckConnector(
+      targetClass, context.SearchElementBySystemIdentifier(ARGUMENT + "2"), ScType::ConstPermPosArc));
+  ScAddrVector const & generatedElements = utils::IteratorUtils::getAllWithType(&context, targetClass, ScType::ConstNode);
+  EXPECT_TRUE(generatedElements.empty());
+}
+
+TEST_P(InferenceManagerBuilderTest, SharedPremiseAtomSearchResultsAreReused)
+{
+  ScMemoryContext & context = *m_ctx;
+
+  loader.loadScsFile(context, TEST_FILES_DIR_PATH + "sharedPremiseAtomTest.scs");
+
+  ScAddr const & inputStructure1 = context.ResolveElementSystemIdentifier(INPUT_STRUCTURE1);
+  ScAddr const & outputStructure = context.GenerateNode(ScType::ConstNodeStructure);
+  ScAddr const & formulasSet = context.ResolveElementSystemIdentifier(FORMULAS_SET);
+  InferenceParams const & inferenceParams{formulasSet, {}, {inputStructure1}, outputStructure};
+
+  InferenceConfig const & inferenceConfig = GetParam()->getInferenceConfig(
+      {GENERATE_ALL_FORMULAS, REPLACEMENTS_ALL, TREE_ONLY_OUTPUT_STRUCTURE, SEARCH_IN_STRUCTURES});
+  utils::ScLogger logger;
+  std::unique_ptr<inference::InferenceManagerAbstract> iterationStrategy =
+      inference::InferenceManagerFactory::ConstructDirectInferenceManagerAll(&context, &logger, inferenceConfig);
+  auto const & searchResultsMemo = std::make_shared<inference::AtomSearchResultsMemo>();
+  iterationStrategy->SetSearchResultsMemo(searchResultsMemo);
+
+  bool result = iterationStrategy->ApplyInference(inferenceParams);
+  EXPECT_TRUE(result);
+
+  // Premises differ only by variables, so the second premise reuses search results of the first one
+  EXPECT_GE(searchResultsMemo->GetHitsAmount(), 1u);
+  ScAddr const & argument = context.SearchElementBySystemIdentifier(ARGUMENT);
+  EXPECT_TRUE(context.CheckConnector(
+      context.SearchElementBySystemIdentifier("target_class_1"), argument, ScType::ConstPermPosArc));
+  EXPECT_TRUE(context.CheckConnector(
+      context.SearchElementBySystemIdentifier("target_class_2"), argument, ScType::ConstPermPosArc));
+}
+
 // There are no arguments using fixed formulas arguments -- not generated
 TEST_P(InferenceManagerBuilderTest, SingleUnsuccessfulApplyInference)
 {
@@ -733,4 +1307,184 @@ TEST_P(InferenceManagerBuilderTest, conclusionContainsArcReplacementFromPremise)
   }
 }
 
+using PremisesPrefetcherTest = ScMemoryTest;
+
+// Premises of formulas with different premises are searched ahead and reused when formulas are applied
+TEST_F(PremisesPrefetcherTest, PrefetchedPremisesAreReused)
+{
+  ScMemoryContext & context = *m_ctx;
+
+  loader.loadScsFile(context, TEST_FILES_DIR_PATH + "prefetchedPremisesTest.scs");
+
+  ScAddr const & inputStructure1 = context.ResolveElementSystemIdentifier(INPUT_STRUCTURE1);
+  ScAddr const & outputStructure = context.GenerateNode(ScType::ConstNodeStructure);
+  ScAddr const & formulasSet = context.ResolveElementSystemIdentifier(FORMULAS_SET);
+  InferenceParams const & inferenceParams{formulasSet, {}, {inputStructure1}, outputStructure};
+
+  InferenceConfig inferenceConfig{
+      GENERATE_ALL_FORMULAS, REPLACEMENTS_ALL, TREE_ONLY_OUTPUT_STRUCTURE, SEARCH_IN_STRUCTURES};
+  inferenceConfig.formulasApplicationType = APPLY_PIPELINED;
+  utils::ScLogger logger;
+  std::unique_ptr<inference::InferenceManagerAbstract> iterationStrategy =
+      inference::InferenceManagerFactory::ConstructDirectInferenceManagerAll(&context, &logger, inferenceConfig);
+  auto const & searchResultsMemo = std::make_shared<inference::AtomSearchResultsMemo>();
+  iterationStrategy->SetSearchResultsMemo(searchResultsMemo);
+
+  bool result = iterationStrategy->ApplyInference(inferenceParams);
+  EXPECT_TRUE(result);
+
+  // Premise of the applied formula is awaited before formula is applied, so it is taken from memo
+  EXPECT_GT(searchResultsMemo->GetHitsAmount(), 0u);
+  // All searches are finished with the run, so invalidations are not kept
+  EXPECT_EQ(searchResultsMemo->GetInvalidationsAmount(), 0u);
+  ScAddr const & argument = context.SearchElementBySystemIdentifier(ARGUMENT);
+  for (std::string const targetClass : {"target_class_1", "target_class_2", "target_class_3"})
+    EXPECT_TRUE(
+        context.CheckConnector(context.SearchElementBySystemIdentifier(targetClass), argument, ScType::ConstPermPosArc));
+}
+
+using AtomSearchResultsMemoTest = ScMemoryTest;
+
+TEST_F(AtomSearchResultsMemoTest, SearchResultsInvalidatedDuringSearchAreNotAdded)
+{
+  ScMemoryContext & context = *m_ctx;
+  ScAddr const & constant = context.GenerateNode(ScType::ConstNode);
+  ScAddr const & otherConstant = context.GenerateNode(ScType::ConstNode);
+  ScAddr const & variable = context.GenerateNode(ScType::VarNode);
+  ScAddr const & value = context.GenerateNode(ScType::ConstNode);
+
+  FormulaMetadata metadata;
+  metadata.constants = {constant};
+  metadata.canonicalFingerprint = 1;
+  metadata.canonicalVariables = {variable};
+  FormulaMetadata otherMetadata = metadata;
+  otherMetadata.constants = {otherConstant};
+  otherMetadata.canonicalFingerprint = 2;
+  std::vector<ScTemplateParams> const templateParamsVector = {ScTemplateParams()};
+  Replacements const searchResult = {{variable, {value}}};
+
+  AtomSearchResultsMemo searchResultsMemo;
+  AtomSearchResultsMemo::InFlightSearch const search(searchResultsMemo);
+  size_t const searchVersion = search.GetVersion();
+  // Generation touches constant of the first formula while formulas are searched
+  searchResultsMemo.InvalidateByConstants({constant});
+  EXPECT_FALSE(searchResultsMemo.Add(metadata, templateParamsVector, {}, searchResult, searchVersion));
+  EXPECT_TRUE(searchResultsMemo.Add(otherMetadata, templateParamsVector, {}, searchResult, searchVersion));
+
+  Replacements memoizedResult;
+  EXPECT_FALSE(searchResultsMemo.Find(metadata, templateParamsVector, {}, memoizedResult));
+  EXPECT_TRUE(searchResultsMemo.Find(otherMetadata, templateParamsVector, {}, memoizedResult));
+  EXPECT_EQ(memoizedResult, searchResult);
+
+  searchResultsMemo.Clear();
+  EXPECT_FALSE(searchResultsMemo.Add(otherMetadata, templateParamsVector, {}, searchResult, searchVersion));
+}
+
+TEST_F(AtomSearchResultsMemoTest, InvalidationsAreKeptOnlyForInFlightSearches)
+{
+  ScMemoryContext & context = *m_ctx;
+  ScAddr const & constant = context.GenerateNode(ScType::ConstNode);
+
+  AtomSearchResultsMemo searchResultsMemo;
+  // Generations without searches in flight are not recorded
+  searchResultsMemo.InvalidateByConstants({constant});
+  EXPECT_EQ(searchResultsMemo.GetInvalidationsAmount(), 0u);
+
+  {
+    auto oldSearch = std::make_unique<AtomSearchResultsMemo::InFlightSearch>(searchResultsMemo);
+    searchResultsMemo.InvalidateByConstants({constant});
+    AtomSearchResultsMemo::InFlightSearch const newSearch(searchResultsMemo);
+    searchResultsMemo.InvalidateByConstants({constant});
+    EXPECT_EQ(searchResultsMemo.GetInvalidationsAmount(), 2u);
+
+    // Invalidation made before the new search was started can't reject its result
+    oldSearch.reset();
+    EXPECT_EQ(searchResultsMemo.GetInvalidationsAmount(), 1u);
+  }
+  EXPECT_EQ(searchResultsMemo.GetInvalidationsAmount(), 0u);
+}
+
+TEST_F(AtomSearchResultsMemoTest, FormulasWithCollidingFingerprintsDoNotShareResults)
+{
+  ScMemoryContext & context = *m_ctx;
+  ScAddr const & firstClass = context.GenerateNode(ScType::ConstNodeClass);
+  ScAddr const & secondClass = context.GenerateNode(ScType::ConstNodeClass);
+  ScAddr const & variable = context.GenerateNode(ScType::VarNode);
+  ScAddr const & value = context.GenerateNode(ScType::ConstNode);
+
+  // Formulas with different structure have the same fingerprint
+  FormulaMetadata metadata;
+  metadata.constants = {firstClass};
+  metadata.canonicalFingerprint = 1;
+  metadata.canonicalVariables = {variable};
+  metadata.canonicalForm = {1, firstClass.Hash()};
+  FormulaMetadata otherMetadata = metadata;
+  otherMetadata.constants = {secondClass};
+  otherMetadata.canonicalForm = {1, secondClass.Hash()};
+  std::vector<ScTemplateParams> const templateParamsVector = {ScTemplateParams()};
+  Replacements const searchResult = {{variable, {value}}};
+
+  AtomSearchResultsMemo searchResultsMemo;
+  searchResultsMemo.Add(metadata, templateParamsVector, {}, searchResult);
+
+  Replacements memoizedResult;
+  EXPECT_FALSE(searchResultsMemo.Find(otherMetadata, templateParamsVector, {}, memoizedResult));
+  EXPECT_TRUE(searchResultsMemo.Find(metadata, templateParamsVector, {}, memoizedResult));
+  EXPECT_EQ(memoizedResult, searchResult);
+}
+
+using ScMemoryProfilerTest = ScMemoryTest;
+
+TEST_F(ScMemoryProfilerTest, NestedCallsAreNotCountedTwice)
+{
+  ScMemoryContext & context = *m_ctx;
+  std::chrono::milliseconds const nestedCallDuration{20};
+
+  utils::ScMemoryProfiler profiler;
+  {
+    utils::ScMemoryProfiler::Activation const activation(&profiler);
+    utils::ScMemoryProfiler::Scope const searchScope(utils::ScMemoryCallType::SEARCH_BY_TEMPLATE);
+    utils::ScMemoryProfiler::Scope const iteratorScope(utils::ScMemoryCallType::CREATE_ITERATOR);
+    std::this_thread::sleep_for(nestedCallDuration);
+  }
+
+  auto const & formulasStatistics = profiler.GetStatistics();
+  utils::ScMemoryProfiler::FormulaStatistics const & statistics = formulasStatistics.at(ScAddr::Empty);
+  auto const & searchStatistics = statistics[static_cast<size_t>(utils::ScMemoryCallType::SEARCH_BY_TEMPLATE)];
+  auto const & iteratorStatistics = statistics[static_cast<size_t>(utils::ScMemoryCallType::CREATE_ITERATOR)];
+  EXPECT_EQ(searchStatistics.callsAmount, 1u);
+  EXPECT_EQ(iteratorStatistics.callsAmount, 1u);
+  EXPECT_GE(iteratorStatistics.duration, nestedCallDuration);
+  EXPECT_LT(searchStatistics.duration, nestedCallDuration);
+
+  // Trace keeps whole durations, so that nested calls are shown inside of calls they are issued by
+  std::string const & trace = profiler.ToChromeTrace(&context);
+  EXPECT_NE(trace.find("\"name\":\"SearchByTemplate\""), std::string::npos);
+  EXPECT_NE(trace.find("\"name\":\"CreateIterator\""), std::string::npos);
+}
+
+TEST_F(ScMemoryProfilerTest, ProfiledContextMeasuresEveryCall)
+{
+  ScMemoryContext & context = *m_ctx;
+  ScAddr const & relation = context.GenerateNode(ScType::ConstNodeNonRole);
+
+  utils::ScMemoryProfiler profiler;
+  {
+    utils::ScMemoryProfiler::Activation const activation(&profiler);
+    utils::ScMemoryProfiledContext profiledContext(&context);
+    ScAddr const & source = profiledContext.GenerateNode(ScType::ConstNode);
+    ScAddr const & target = profiledContext.GenerateNode(ScType::ConstNode);
+    profiledContext.GenerateRelationBetween(ScType::ConstCommonArc, source, target, relation);
+    EXPECT_TRUE(profiledContext.CheckConnector(source, target, ScType::ConstCommonArc));
+    EXPECT_TRUE(profiledContext.CreateIterator3(source, ScType::ConstCommonArc, target)->Next());
+  }
+
+  // Relation between elements is generated by two calls
+  auto const & formulasStatistics = profiler.GetStatistics();
+  utils::ScMemoryProfiler::FormulaStatistics const & statistics = formulasStatistics.at(ScAddr::Empty);
+  EXPECT_EQ(statistics[static_cast<size_t>(utils::ScMemoryCallType::GENERATE_ELEMENT)].callsAmount, 4u);
+  EXPECT_EQ(statistics[static_cast<size_t>(utils::ScMemoryCallType::CHECK_CONNECTOR)].callsAmount, 1u);
+  EXPECT_EQ(statistics[static_cast<size_t>(utils::ScMemoryCallType::CREATE_ITERATOR)].callsAmount, 1u);
+}
+
 }  // namespace inference::inferenceManagerBuilderTest
@@ -5,6 +5,7 @@
  */
 
 #include "classifier/FormulaClassifier.hpp"
+#include "classifier/FormulaMetadataCache.hpp"
 
 #include "inference/inference_keynodes.hpp"
 
@@ -61,4 +62,69 @@ TEST_F(FormulaClassifierTest, AtomicLogicalFormulaWithouCLass)
   context.Destroy();
 }
 
+TEST_F(FormulaClassifierTest, FormulaMetadataIsComputedOnce)
+{
+  ScMemoryContext context;
+
+  loader.loadScsFile(context, TEST_FILES_DIR_PATH + "atomicLogicalFormulaTestWithoutClass.scs");
+
+  ScAddr const & formula = context.ResolveElementSystemIdentifier("formula");
+  ScAddr const & formulaWithLink = context.ResolveElementSystemIdentifier("formula_with_link");
+  FormulaMetadataCache cache;
+  std::shared_ptr<FormulaMetadata const> const & metadata = cache.Get(&context, formulaWithLink);
+
+  // Variable arc and variable link
+  EXPECT_EQ(metadata->variables.size(), 2u);
+  EXPECT_EQ(metadata->constants.size(), 1u);
+  EXPECT_TRUE(metadata->constants.count(context.ResolveElementSystemIdentifier("class2")));
+  ASSERT_EQ(metadata->links.size(), 1u);
+  EXPECT_EQ(metadata->linksContent.at(metadata->links[0]), "content");
+  EXPECT_TRUE(metadata->hasConstants);
+  EXPECT_TRUE(metadata->hasVariables);
+  EXPECT_FALSE(metadata->isToGenerate);
+  for (size_t i = 0; i < metadata->variables.size(); ++i)
+    EXPECT_EQ(metadata->GetVariableIndex(metadata->variables[i]), i);
+
+  EXPECT_EQ(cache.Get(&context, formulaWithLink), metadata);
+  EXPECT_EQ(cache.Size(), 1u);
+  EXPECT_NE(cache.Get(&context, formula)->fingerprint, metadata->fingerprint);
+  EXPECT_NE(cache.Get(&context, formula)->canonicalForm, metadata->canonicalForm);
+  EXPECT_EQ(cache.Size(), 2u);
+
+  cache.Invalidate(formulaWithLink);
+  EXPECT_EQ(cache.Size(), 1u);
+  EXPECT_NE(cache.Get(&context, formulaWithLink), metadata);
+
+  context.Destroy();
+}
+
+TEST_F(FormulaClassifierTest, FormulaClassIsCachedWithMetadata)
+{
+  ScMemoryContext context;
+
+  loader.loadScsFile(context, TEST_FILES_DIR_PATH + "atomicLogicalFormulaTestWithoutClass.scs");
+
+  utils::ScLogger logger;
+  ScAddr const & formula = context.ResolveElementSystemIdentifier("formula");
+  FormulaMetadataCache cache;
+
+  // Structure without class is classified by its variables, so its metadata is computed
+  EXPECT_EQ(cache.GetFormulaClass(&context, &logger, formula), FormulaClassifier::ATOMIC);
+  EXPECT_EQ(cache.Size(), 1u);
+  EXPECT_TRUE(cache.Get(&context, formula)->hasVariables);
+
+  // Class is kept until formula is invalidated
+  ScAddrVector elementsArcs;
+  ScIterator3Ptr const & elementsIterator = context.CreateIterator3(formula, ScType::ConstPermPosArc, ScType::Unknown);
+  while (elementsIterator->Next())
+    elementsArcs.push_back(elementsIterator->Get(1));
+  for (ScAddr const & elementArc : elementsArcs)
+    context.EraseElement(elementArc);
+  EXPECT_EQ(cache.GetFormulaClass(&context, &logger, formula), FormulaClassifier::ATOMIC);
+  cache.Invalidate(formula);
+  EXPECT_EQ(cache.GetFormulaClass(&context, &logger, formula), FormulaClassifier::NONE);
+
+  context.Destroy();
+}
+
 }  // namespace formulaClassifierTest
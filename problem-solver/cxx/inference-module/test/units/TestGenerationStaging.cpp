@@ -0,0 +1,98 @@
+/*
+ * This source file is part of an OSTIS project. For the latest info, see http://ostis.net
+ * Distributed under the MIT License
+ * (See accompanying file COPYING.MIT or copy at http://opensource.org/licenses/MIT)
+ */
+
+#include <sc-memory/test/sc_test.hpp>
+
+#include "generator/GenerationStaging.hpp"
+
+using namespace inference;
+
+namespace generationStagingTest
+{
+using GenerationStagingTest = ScMemoryTest;
+
+/// Generate formula `classNode -> _element` and return variable `_element`
+ScAddr GenerateMembershipFormula(ScMemoryContext & context, ScAddr const & classNode, ScAddr & formula)
+{
+  formula = context.GenerateNode(ScType::ConstNodeStructure);
+  ScAddr const & variable = context.GenerateNode(ScType::VarNode);
+  ScAddr const & arc = context.GenerateConnector(ScType::VarPermPosArc, classNode, variable);
+  for (ScAddr const & element : {classNode, variable, arc})
+    context.GenerateConnector(ScType::ConstPermPosArc, formula, element);
+  return variable;
+}
+
+size_t CountMemberships(ScMemoryContext & context, ScAddr const & classNode, ScAddr const & element)
+{
+  size_t amount = 0;
+  ScIterator3Ptr const & iterator = context.CreateIterator3(classNode, ScType::ConstPermPosArc, element);
+  while (iterator->Next())
+    ++amount;
+  return amount;
+}
+
+TEST_F(GenerationStagingTest, CommitDeduplicatesStagedAndExistingFormulas)
+{
+  ScMemoryContext & context = *m_ctx;
+  ScAddr const & classNode = context.GenerateNode(ScType::ConstNodeClass);
+  ScAddr formula;
+  ScAddr const & variable = GenerateMembershipFormula(context, classNode, formula);
+  ScAddr const & first = context.GenerateNode(ScType::ConstNode);
+  ScAddr const & second = context.GenerateNode(ScType::ConstNode);
+  context.GenerateConnector(ScType::ConstPermPosArc, classNode, second);
+
+  GenerationStaging staging(&context, 2);
+  staging.GetBuffer(0).Stage(formula, {{variable, first}});
+  staging.GetBuffer(0).Stage(formula, {{variable, second}});
+  staging.GetBuffer(1).Stage(formula, {{variable, first}});
+  EXPECT_EQ(CountMemberships(context, classNode, first), 0u);
+
+  EXPECT_EQ(staging.Commit(), 1u);
+  EXPECT_EQ(CountMemberships(context, classNode, first), 1u);
+  EXPECT_EQ(CountMemberships(context, classNode, second), 1u);
+  EXPECT_EQ(staging.GetCommittedElements().size(), 1u);
+  EXPECT_EQ(staging.GetBuffer(0).GetStagedAmount(), 0u);
+  EXPECT_EQ(staging.GetBuffer(1).GetStagedAmount(), 0u);
+}
+
+TEST_F(GenerationStagingTest, RollbackDropsStagedFormulas)
+{
+  ScMemoryContext & context = *m_ctx;
+  ScAddr const & classNode = context.GenerateNode(ScType::ConstNodeClass);
+  ScAddr formula;
+  ScAddr const & variable = GenerateMembershipFormula(context, classNode, formula);
+  ScAddr const & element = context.GenerateNode(ScType::ConstNode);
+
+  GenerationStaging staging(&context, 1);
+  staging.GetBuffer(0).Stage(formula, {{variable, element}});
+  staging.Rollback();
+
+  EXPECT_EQ(staging.Commit(), 0u);
+  EXPECT_EQ(CountMemberships(context, classNode, element), 0u);
+}
+
+TEST_F(GenerationStagingTest, FailedCommitErasesGeneratedFormulas)
+{
+  ScMemoryContext & context = *m_ctx;
+  ScAddr const & classNode = context.GenerateNode(ScType::ConstNodeClass);
+  ScAddr formula;
+  ScAddr const & variable = GenerateMembershipFormula(context, classNode, formula);
+  ScAddr const & element = context.GenerateNode(ScType::ConstNode);
+  ScAddr erasedFormula;
+  ScAddr const & erasedVariable = GenerateMembershipFormula(context, classNode, erasedFormula);
+  context.EraseElement(erasedFormula);
+
+  GenerationStaging staging(&context, 1);
+  staging.GetBuffer(0).Stage(formula, {{variable, element}});
+  staging.GetBuffer(0).Stage(erasedFormula, {{erasedVariable, element}});
+
+  EXPECT_ANY_THROW(staging.Commit());
+  EXPECT_EQ(CountMemberships(context, classNode, element), 0u);
+  EXPECT_TRUE(staging.GetCommittedElements().empty());
+  EXPECT_EQ(staging.GetBuffer(0).GetStagedAmount(), 0u);
+}
+
+}  // namespace generationStagingTest
@@ -5,13 +5,18 @@
  */
 
 #include <inference/direct_inference_agent.hpp>
+#include <inference/cancel_inference_agent.hpp>
+#include <inference/inference_cancellation.hpp>
 #include <inference/inference_keynodes.hpp>
+#include <inference/inference_service.hpp>
 
 #include <sc-memory/test/sc_test.hpp>
 #include <sc-builder/scs_loader.hpp>
 
 #include <sc-agents-common/utils/IteratorUtils.hpp>
 
+#include <thread>
+
 using namespace inference;
 
 namespace directInferenceLogicArgumentsTest
@@ -21,6 +26,8 @@ const std::string TEST_FILES_DIR_PATH = "../test-structures/logic-module/";
 
 using InferenceLogicTest = ScMemoryTest;
 const int WAIT_TIME = 1500;
+const int CONCURRENT_WAIT_TIME = 20000;
+const size_t CONCURRENT_ACTIONS_AMOUNT = 16;
 
 void initialize(ScAgentContext & context)
 {
@@ -172,4 +179,147 @@ TEST_F(InferenceLogicTest, EmptyRuleSetQueue)
   context.Destroy();
 }
 
+// Running action is cancelled by its token, action that is not running can't be cancelled
+TEST_F(InferenceLogicTest, CancelInferenceAction)
+{
+  ScAgentContext context;
+  context.SubscribeAgent<CancelInferenceAgent>();
+
+  ScAddr const & inferenceAction = context.GenerateNode(ScType::ConstNode);
+  InferenceCancellationRegistry & registry = InferenceCancellationRegistry::GetInstance();
+  std::shared_ptr<CancellationToken> const & token = registry.Register(inferenceAction);
+
+  ScAction cancelAction = context.GenerateAction(InferenceKeynodes::action_cancel_inference);
+  cancelAction.SetArguments(inferenceAction);
+  EXPECT_TRUE(cancelAction.InitiateAndWait(WAIT_TIME));
+  EXPECT_TRUE(cancelAction.IsFinishedSuccessfully());
+  EXPECT_TRUE(token->IsCancelled());
+
+  registry.Unregister(inferenceAction);
+  ScAction repeatedCancelAction = context.GenerateAction(InferenceKeynodes::action_cancel_inference);
+  repeatedCancelAction.SetArguments(inferenceAction);
+  EXPECT_TRUE(repeatedCancelAction.InitiateAndWait(WAIT_TIME));
+  EXPECT_TRUE(repeatedCancelAction.IsFinishedUnsuccessfully());
+
+  context.UnsubscribeAgent<CancelInferenceAgent>();
+  context.Destroy();
+}
+
+// Initiated action that is not registered yet is cancelled on registration, its cancellation is removed with it
+TEST_F(InferenceLogicTest, CancelInferenceActionBeforeItIsStarted)
+{
+  ScAgentContext context;
+  context.SubscribeAgent<CancelInferenceAgent>();
+
+  ScAction inferenceAction = context.GenerateAction(InferenceKeynodes::action_direct_inference);
+  inferenceAction.Initiate();
+  InferenceCancellationRegistry & registry = InferenceCancellationRegistry::GetInstance();
+
+  ScAction cancelAction = context.GenerateAction(InferenceKeynodes::action_cancel_inference);
+  cancelAction.SetArguments(inferenceAction);
+  EXPECT_TRUE(cancelAction.InitiateAndWait(WAIT_TIME));
+  EXPECT_TRUE(cancelAction.IsFinishedSuccessfully());
+  EXPECT_EQ(registry.GetPendingCancellationsAmount(), 1u);
+
+  {
+    InferenceCancellationRegistry::Registration const registration(inferenceAction);
+    EXPECT_TRUE(registration.GetToken()->IsCancelled());
+    EXPECT_EQ(registry.GetPendingCancellationsAmount(), 0u);
+  }
+  EXPECT_EQ(registry.Size(), 0u);
+
+  context.UnsubscribeAgent<CancelInferenceAgent>();
+  context.Destroy();
+}
+
+// Generate input structure with its own argument of current_node_class
+ScAddr generateInputStructure(ScMemoryContext & context, ScAddr const & currentNodeClass, ScAddr & argument)
+{
+  ScAddr const & inputStructure = context.GenerateNode(ScType::ConstNodeStructure);
+  argument = context.GenerateNode(ScType::ConstNode);
+  ScAddr const & arc = context.GenerateConnector(ScType::ConstPermPosArc, currentNodeClass, argument);
+  for (ScAddr const & element : {currentNodeClass, argument, arc})
+    context.GenerateConnector(ScType::ConstPermPosArc, inputStructure, element);
+  return inputStructure;
+}
+
+// Actions with disjoint input structures performed in parallel give the same results as performed sequentially
+TEST_F(InferenceLogicTest, ConcurrentActionsMatchSequentialActions)
+{
+  ScAgentContext context;
+
+  loader.loadScsFile(context, TEST_FILES_DIR_PATH + "logicModuleArgumentsTest.scs");
+  // Actions share formulas metadata cache and thread pool of the service as they do in the module
+  InferenceService & service = InferenceService::GetInstance();
+  service.Start();
+  initialize(context);
+
+  ScAddr const & targetTemplate = context.SearchElementBySystemIdentifier("target_template");
+  ScAddr const & rulesSet = context.SearchElementBySystemIdentifier("rules_set");
+  ScAddr const & currentNodeClass = context.SearchElementBySystemIdentifier("current_node_class");
+  ScAddr const & targetNodeClass = context.SearchElementBySystemIdentifier("target_node_class");
+
+  auto const & generateActions = [&](ScAddrVector & actions, ScAddrVector & arguments)
+  {
+    for (size_t i = 0; i < CONCURRENT_ACTIONS_AMOUNT; ++i)
+    {
+      ScAddr argument;
+      ScAddr const & inputStructure = generateInputStructure(context, currentNodeClass, argument);
+      ScAction action = context.GenerateAction(InferenceKeynodes::action_direct_inference);
+      action.SetArguments(targetTemplate, rulesSet, context.GenerateNode(ScType::ConstNode), inputStructure);
+      actions.push_back(action);
+      arguments.push_back(argument);
+    }
+  };
+  auto const & getResults = [&](ScAddrVector const & actions, ScAddrVector const & arguments)
+  {
+    std::vector<std::pair<bool, bool>> results;
+    for (size_t i = 0; i < actions.size(); ++i)
+    {
+      ScAction action = context.ConvertToAction(actions[i]);
+      results.emplace_back(
+          action.IsFinishedSuccessfully(),
+          context.CheckConnector(targetNodeClass, arguments[i], ScType::ConstPermPosArc));
+    }
+    return results;
+  };
+
+  ScAddrVector sequentialActions, sequentialArguments;
+  generateActions(sequentialActions, sequentialArguments);
+  for (ScAddr const & actionAddr : sequentialActions)
+    EXPECT_TRUE(context.ConvertToAction(actionAddr).InitiateAndWait(CONCURRENT_WAIT_TIME));
+
+  ScAddrVector concurrentActions, concurrentArguments;
+  generateActions(concurrentActions, concurrentArguments);
+  std::vector<char> areWaited(CONCURRENT_ACTIONS_AMOUNT, false);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < CONCURRENT_ACTIONS_AMOUNT; ++i)
+  {
+    threads.emplace_back(
+        [&, i]()
+        {
+          ScAgentContext threadContext;
+          areWaited[i] = threadContext.ConvertToAction(concurrentActions[i]).InitiateAndWait(CONCURRENT_WAIT_TIME);
+        });
+  }
+  for (std::thread & thread : threads)
+    thread.join();
+
+  for (char const isWaited : areWaited)
+    EXPECT_TRUE(isWaited);
+  auto const & sequentialResults = getResults(sequentialActions, sequentialArguments);
+  EXPECT_EQ(getResults(concurrentActions, concurrentArguments), sequentialResults);
+  for (auto const & [isFinishedSuccessfully, isArgumentClassified] : sequentialResults)
+  {
+    EXPECT_TRUE(isFinishedSuccessfully);
+    EXPECT_TRUE(isArgumentClassified);
+  }
+  EXPECT_TRUE(service.IsRunning());
+  EXPECT_GT(service.GetWatchedFormulasSetsAmount(), 0u);
+
+  shutdown(context);
+  service.Stop();
+  context.Destroy();
+}
+
 }  // namespace directInferenceLogicArgumentsTest
@@ -0,0 +1,295 @@
+/*
+ * This source file is part of an OSTIS project. For the latest info, see http://ostis.net
+ * Distributed under the MIT License
+ * (See accompanying file COPYING.MIT or copy at http://opensource.org/licenses/MIT)
+ */
+
+#include "inference/replacements_utils.hpp"
+#include "inference/solution_tree_expander.hpp"
+
+#include "generator/CompactReplacementsCodec.hpp"
+#include "generator/SolutionTreeGenerator.hpp"
+
+#include <sc-memory/test/sc_test.hpp>
+
+using namespace inference;
+
+namespace replacementsUtilsTest
+{
+using ReplacementsUtilsTest = ScMemoryTest;
+
+TEST_F(ReplacementsUtilsTest, UniteReplacementsWithSameKeysRemovesDuplicates)
+{
+  ScMemoryContext context;
+  ScAddr const x = context.GenerateNode(ScType::ConstNode);
+  ScAddr const a = context.GenerateNode(ScType::ConstNode);
+  ScAddr const b = context.GenerateNode(ScType::ConstNode);
+  ScAddr const c = context.GenerateNode(ScType::ConstNode);
+
+  Replacements const first = {{x, {a, b, a}}};
+  Replacements const second = {{x, {b, c}}};
+  Replacements unionResult;
+  ReplacementsUtils::UniteReplacements(first, second, unionResult);
+
+  EXPECT_EQ(unionResult.size(), 1u);
+  EXPECT_EQ(unionResult[x], ScAddrVector({a, b, c}));
+}
+
+TEST_F(ReplacementsUtilsTest, UniteReplacementsWithDifferentKeysPadsMissingValues)
+{
+  ScMemoryContext context;
+  ScAddr const x = context.GenerateNode(ScType::ConstNode);
+  ScAddr const y = context.GenerateNode(ScType::ConstNode);
+  ScAddr const a = context.GenerateNode(ScType::ConstNode);
+  ScAddr const b = context.GenerateNode(ScType::ConstNode);
+  ScAddr const c = context.GenerateNode(ScType::ConstNode);
+
+  Replacements const first = {{x, {a, b}}};
+  Replacements const second = {{y, {c}}};
+  Replacements unionResult;
+  ReplacementsUtils::UniteReplacements(first, second, unionResult);
+
+  EXPECT_EQ(unionResult.size(), 2u);
+  EXPECT_EQ(ReplacementsUtils::GetColumnsAmount(unionResult), 3u);
+  EXPECT_EQ(unionResult[x], ScAddrVector({a, b, ScAddr::Empty}));
+  EXPECT_EQ(unionResult[y], ScAddrVector({ScAddr::Empty, ScAddr::Empty, c}));
+}
+
+TEST_F(ReplacementsUtilsTest, UniteReplacementsIntoOperand)
+{
+  ScMemoryContext context;
+  ScAddr const x = context.GenerateNode(ScType::ConstNode);
+  ScAddr const a = context.GenerateNode(ScType::ConstNode);
+  ScAddr const b = context.GenerateNode(ScType::ConstNode);
+
+  Replacements first = {{x, {a}}};
+  Replacements const second = {{x, {a, b}}};
+  ReplacementsUtils::UniteReplacements(first, second, first);
+
+  EXPECT_EQ(first[x], ScAddrVector({a, b}));
+}
+
+TEST_F(ReplacementsUtilsTest, IntersectReplacementsRemovesDuplicates)
+{
+  ScMemoryContext context;
+  ScAddr const x = context.GenerateNode(ScType::ConstNode);
+  ScAddr const y = context.GenerateNode(ScType::ConstNode);
+  ScAddr const a = context.GenerateNode(ScType::ConstNode);
+  ScAddr const b = context.GenerateNode(ScType::ConstNode);
+  ScAddr const c = context.GenerateNode(ScType::ConstNode);
+
+  Replacements const first = {{x, {a, a, b}}, {y, {c, c, c}}};
+  Replacements const second = {{x, {a, b, b}}};
+  Replacements intersection;
+  ReplacementsUtils::IntersectReplacements(first, second, intersection);
+
+  EXPECT_EQ(ReplacementsUtils::GetColumnsAmount(intersection), 2u);
+  EXPECT_EQ(intersection[y], ScAddrVector({c, c}));
+}
+
+TEST_F(ReplacementsUtilsTest, ReplacementsOperationsBySingleCommonVariable)
+{
+  ScMemoryContext context;
+  ScAddr const x = context.GenerateNode(ScType::ConstNode);
+  ScAddr const y = context.GenerateNode(ScType::ConstNode);
+  ScAddr const z = context.GenerateNode(ScType::ConstNode);
+  ScAddr const a = context.GenerateNode(ScType::ConstNode);
+  ScAddr const b = context.GenerateNode(ScType::ConstNode);
+  ScAddr const c = context.GenerateNode(ScType::ConstNode);
+  ScAddr const d = context.GenerateNode(ScType::ConstNode);
+
+  Replacements const first = {{x, {a, b, c, a}}, {y, {d, d, d, c}}};
+  Replacements const second = {{x, {c, a, a, d}}, {z, {b, b, d, a}}};
+  Replacements intersection;
+  ReplacementsUtils::IntersectReplacements(first, second, intersection);
+
+  EXPECT_EQ(intersection.size(), 3u);
+  EXPECT_EQ(intersection[x], ScAddrVector({a, a, c, a, a}));
+  EXPECT_EQ(intersection[y], ScAddrVector({d, d, d, c, c}));
+  EXPECT_EQ(intersection[z], ScAddrVector({b, d, b, b, d}));
+
+  Replacements difference;
+  ReplacementsUtils::SubtractReplacements(first, second, difference);
+
+  EXPECT_EQ(difference.size(), 2u);
+  EXPECT_EQ(difference[x], ScAddrVector({b}));
+  EXPECT_EQ(difference[y], ScAddrVector({d}));
+}
+
+TEST_F(ReplacementsUtilsTest, ReplacementsOperationsWithUnitedOperand)
+{
+  ScMemoryContext context;
+  ScAddr const x = context.GenerateNode(ScType::ConstNode);
+  ScAddr const y = context.GenerateNode(ScType::ConstNode);
+  ScAddr const a = context.GenerateNode(ScType::ConstNode);
+  ScAddr const b = context.GenerateNode(ScType::ConstNode);
+  ScAddr const c = context.GenerateNode(ScType::ConstNode);
+  ScAddr const d = context.GenerateNode(ScType::ConstNode);
+
+  // (A(x) ∨ B(y)) ∧ C(x), value of x is not bound in replacements of B
+  Replacements disjunction;
+  ReplacementsUtils::UniteReplacements({{x, {a}}}, {{y, {b}}}, disjunction);
+  Replacements const conjunctionOperand = {{x, {a, c}}};
+  Replacements intersection;
+  ReplacementsUtils::IntersectReplacements(disjunction, conjunctionOperand, intersection);
+
+  EXPECT_EQ(intersection.size(), 2u);
+  EXPECT_EQ(intersection[x], ScAddrVector({a, a, c}));
+  EXPECT_EQ(intersection[y], ScAddrVector({ScAddr::Empty, b, b}));
+
+  Replacements difference;
+  ReplacementsUtils::SubtractReplacements(conjunctionOperand, disjunction, difference);
+  EXPECT_EQ(ReplacementsUtils::GetColumnsAmount(difference), 0u);
+
+  // Several common variables are joined by hashes, columns with unbound values are compared one by one
+  Replacements const secondOperand = {{x, {a, c, d}}, {y, {b, b, d}}};
+  ReplacementsUtils::IntersectReplacements(disjunction, secondOperand, intersection);
+
+  EXPECT_EQ(intersection[x], ScAddrVector({a, c}));
+  EXPECT_EQ(intersection[y], ScAddrVector({b, b}));
+
+  ReplacementsUtils::SubtractReplacements(secondOperand, disjunction, difference);
+  EXPECT_EQ(difference[x], ScAddrVector({d}));
+  EXPECT_EQ(difference[y], ScAddrVector({d}));
+}
+
+TEST_F(ReplacementsUtilsTest, ReplacementsOperationsInScratchScopes)
+{
+  ScMemoryContext context;
+  ScAddr const x = context.GenerateNode(ScType::ConstNode);
+  ScAddr const y = context.GenerateNode(ScType::ConstNode);
+  ScAddr const a = context.GenerateNode(ScType::ConstNode);
+  ScAddr const b = context.GenerateNode(ScType::ConstNode);
+  ScAddr const c = context.GenerateNode(ScType::ConstNode);
+
+  Replacements const first = {{x, {a, b}}, {y, {c, c}}};
+  Replacements const second = {{x, {b}}};
+  Replacements intersection;
+  Replacements difference;
+  {
+    ReplacementsUtils::ScratchScope const outerScope;
+    std::pmr::memory_resource * const outerResource = ReplacementsUtils::GetScratchResource();
+    EXPECT_NE(outerResource, std::pmr::get_default_resource());
+    ReplacementsUtils::IntersectReplacements(first, second, intersection);
+    {
+      ReplacementsUtils::ScratchScope const innerScope;
+      EXPECT_NE(ReplacementsUtils::GetScratchResource(), outerResource);
+      ReplacementsUtils::SubtractReplacements(first, second, difference);
+    }
+    EXPECT_EQ(ReplacementsUtils::GetScratchResource(), outerResource);
+  }
+  EXPECT_EQ(ReplacementsUtils::GetScratchResource(), std::pmr::get_default_resource());
+
+  EXPECT_EQ(intersection[x], ScAddrVector({b}));
+  EXPECT_EQ(intersection[y], ScAddrVector({c}));
+  EXPECT_EQ(difference[x], ScAddrVector({a}));
+  EXPECT_EQ(difference[y], ScAddrVector({c}));
+}
+
+TEST_F(ReplacementsUtilsTest, ProjectReplacementsRemovesDuplicates)
+{
+  ScMemoryContext context;
+  ScAddr const x = context.GenerateNode(ScType::ConstNode);
+  ScAddr const y = context.GenerateNode(ScType::ConstNode);
+  ScAddr const a = context.GenerateNode(ScType::ConstNode);
+  ScAddr const b = context.GenerateNode(ScType::ConstNode);
+  ScAddr const c = context.GenerateNode(ScType::ConstNode);
+
+  Replacements const replacements = {{x, {a, a, b}}, {y, {b, c, c}}};
+  Replacements projection;
+  ReplacementsUtils::ProjectReplacements(replacements, {x}, projection);
+
+  EXPECT_EQ(projection.size(), 1u);
+  EXPECT_EQ(projection[x], ScAddrVector({a, b}));
+}
+
+TEST_F(ReplacementsUtilsTest, TemplateParamsSkipUnboundVariables)
+{
+  ScMemoryContext context;
+  ScAddr const x = context.GenerateNode(ScType::ConstNode);
+  ScAddr const y = context.GenerateNode(ScType::ConstNode);
+  ScAddr const a = context.GenerateNode(ScType::ConstNode);
+  ScAddr const b = context.GenerateNode(ScType::ConstNode);
+
+  Replacements const replacements = {{x, {a, ScAddr::Empty}}, {y, {ScAddr::Empty, b}}};
+  std::vector<ScTemplateParams> templateParams;
+  ReplacementsUtils::GetReplacementsToScTemplateParams(replacements, templateParams);
+
+  ASSERT_EQ(templateParams.size(), 2u);
+  ScAddr value;
+  EXPECT_TRUE(templateParams[0].Get(x, value));
+  EXPECT_EQ(value, a);
+  EXPECT_FALSE(templateParams[0].Get(y, value));
+  EXPECT_FALSE(templateParams[1].Get(x, value));
+  EXPECT_TRUE(templateParams[1].Get(y, value));
+  EXPECT_EQ(value, b);
+}
+
+TEST_F(ReplacementsUtilsTest, CompactReplacementsKeepUnboundVariables)
+{
+  ScMemoryContext context;
+  ScAddr const x = context.GenerateNode(ScType::VarNode);
+  ScAddr const y = context.GenerateNode(ScType::VarNode);
+  ScAddr const a = context.GenerateNode(ScType::ConstNode);
+  ScAddr const b = context.GenerateNode(ScType::ConstNode);
+
+  Replacements const replacements = {{x, {a, ScAddr::Empty}}, {y, {ScAddr::Empty, b}}};
+  ScAddrVector variables;
+  std::vector<ScAddrVector> rows;
+  EXPECT_TRUE(CompactReplacementsCodec::Decode(CompactReplacementsCodec::Encode(replacements), variables, rows));
+
+  ASSERT_EQ(variables.size(), 2u);
+  ASSERT_EQ(rows.size(), 2u);
+  size_t const xIndex = variables[0] == x ? 0 : 1;
+  EXPECT_EQ(rows[0][xIndex], a);
+  EXPECT_FALSE(rows[0][1 - xIndex].IsValid());
+  EXPECT_FALSE(rows[1][xIndex].IsValid());
+  EXPECT_EQ(rows[1][1 - xIndex], b);
+}
+
+TEST_F(ReplacementsUtilsTest, SolutionNodeWithoutReplacementOfVariableIsNotGenerated)
+{
+  ScMemoryContext context;
+  ScAddr const formula = context.GenerateNode(ScType::ConstNode);
+  ScAddr const x = context.GenerateNode(ScType::VarNode);
+  ScAddr const y = context.GenerateNode(ScType::VarNode);
+  ScAddr const a = context.GenerateNode(ScType::ConstNode);
+
+  SolutionTreeGenerator solutionTreeGenerator(&context);
+  ScTemplateParams templateParams;
+  templateParams.Add(x, a);
+  EXPECT_THROW(solutionTreeGenerator.AddNode(formula, templateParams, {x, y}), utils::ExceptionItemNotFound);
+}
+
+TEST_F(ReplacementsUtilsTest, ExpandCompactSolutionSkipsUnboundVariables)
+{
+  ScMemoryContext context;
+  ScAddr const formula = context.GenerateNode(ScType::ConstNode);
+  ScAddr const x = context.GenerateNode(ScType::VarNode);
+  ScAddr const y = context.GenerateNode(ScType::VarNode);
+  ScAddr const a = context.GenerateNode(ScType::ConstNode);
+  ScAddr const b = context.GenerateNode(ScType::ConstNode);
+
+  SolutionTreeGenerator solutionTreeGenerator(&context);
+  EXPECT_TRUE(solutionTreeGenerator.AddCompactNode(formula, {{x, {a, ScAddr::Empty}}, {y, {ScAddr::Empty, b}}}));
+  ScAddr const outputStructure = context.GenerateNode(ScType::ConstNodeStructure);
+  ScAddr const solution = solutionTreeGenerator.GenerateSolution(outputStructure, true);
+
+  SolutionTreeExpander expander(&context);
+  EXPECT_TRUE(expander.Expand(solution));
+
+  // Padding of united replacements is not bound to variables
+  EXPECT_TRUE(context.CheckConnector(x, a, ScType::ConstTempPosArc));
+  EXPECT_TRUE(context.CheckConnector(y, b, ScType::ConstTempPosArc));
+  for (ScAddr const & variable : {x, y})
+  {
+    size_t valuesAmount = 0;
+    ScIterator3Ptr const & valuesIterator =
+        context.CreateIterator3(variable, ScType::ConstTempPosArc, ScType::Unknown);
+    while (valuesIterator->Next())
+      ++valuesAmount;
+    EXPECT_EQ(valuesAmount, 1u);
+  }
+}
+
+}  // namespace replacementsUtilsTest
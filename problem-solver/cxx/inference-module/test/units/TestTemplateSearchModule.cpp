@@ -123,6 +123,76 @@ TEST_F(TemplateSearchManagerTest, SearchInMultipleStructuresWithContent_SingleRe
       context.SearchElementBySystemIdentifier(firstConstantNode));
 }
 
+TEST_F(TemplateSearchManagerTest, SearchWithContent_LinksResolvedByContentTestCase)
+{
+  ScMemoryContext & context = *m_ctx;
+
+  loader.loadScsFile(context, TEST_FILES_DIR_PATH + "searchWithContentMultipleResultTestStucture.scs");
+
+  ScAddr const & searchTemplateAddr = context.SearchElementBySystemIdentifier(TEST_SEARCH_TEMPLATE_ID);
+  ScAddr const & searchLink = context.SearchElementBySystemIdentifier("search_link");
+  ScAddr const & nodeVariable = context.SearchElementBySystemIdentifier("_node");
+  ScAddr const & firstNode = context.SearchElementBySystemIdentifier("first_constant_node");
+  ScAddr const & secondNode = context.SearchElementBySystemIdentifier("second_constant_node");
+  inference::TemplateSearcherGeneral templateSearcher(&context);
+  ScAddrUnorderedSet variables;
+  templateSearcher.getVariables(searchTemplateAddr, variables);
+
+  // Search is seeded by links with the same content, link with wrong content is not found
+  inference::Replacements searchResults;
+  templateSearcher.searchTemplate(searchTemplateAddr, ScTemplateParams(), variables, searchResults);
+  ASSERT_EQ(inference::ReplacementsUtils::GetColumnsAmount(searchResults), 1u);
+  ScAddr const & foundNode = searchResults.at(nodeVariable)[0];
+  EXPECT_TRUE(foundNode == firstNode || foundNode == secondNode);
+
+  // Link bound by params is checked by content before search
+  ScTemplateParams templateParams;
+  templateParams.Add(searchLink, context.SearchElementBySystemIdentifier("second_correct_result_link"));
+  inference::Replacements boundSearchResults;
+  templateSearcher.searchTemplate(searchTemplateAddr, templateParams, variables, boundSearchResults);
+  ASSERT_EQ(inference::ReplacementsUtils::GetColumnsAmount(boundSearchResults), 1u);
+  EXPECT_EQ(boundSearchResults.at(nodeVariable)[0], secondNode);
+}
+
+TEST_F(TemplateSearchManagerTest, SearchWithContent_LinksResolvedOncePerSearchTestCase)
+{
+  ScMemoryContext & context = *m_ctx;
+
+  loader.loadScsFile(context, TEST_FILES_DIR_PATH + "searchWithContentMultipleResultTestStucture.scs");
+
+  ScAddr const & searchTemplateAddr = context.SearchElementBySystemIdentifier(TEST_SEARCH_TEMPLATE_ID);
+  ScAddr const & searchLink = context.SearchElementBySystemIdentifier("search_link");
+  ScAddr const & nodeVariable = context.SearchElementBySystemIdentifier("_node");
+  ScAddr const & firstNode = context.SearchElementBySystemIdentifier("first_constant_node");
+  ScAddr const & secondNode = context.SearchElementBySystemIdentifier("second_constant_node");
+  inference::TemplateSearcherGeneral templateSearcher(&context);
+  ScAddrUnorderedSet variables;
+  templateSearcher.getVariables(searchTemplateAddr, variables);
+
+  // Links resolved for the first params are reused by the second ones
+  std::vector<ScTemplateParams> templateParamsVector(2);
+  templateParamsVector[0].Add(nodeVariable, firstNode);
+  templateParamsVector[1].Add(nodeVariable, secondNode);
+  inference::Replacements searchResults;
+  templateSearcher.searchTemplate(searchTemplateAddr, templateParamsVector, variables, searchResults);
+  ASSERT_EQ(inference::ReplacementsUtils::GetColumnsAmount(searchResults), 2u);
+  EXPECT_EQ(searchResults.at(nodeVariable), ScAddrVector({firstNode, secondNode}));
+  EXPECT_EQ(searchResults.at(searchLink)[0], context.SearchElementBySystemIdentifier("first_correct_result_link"));
+  EXPECT_EQ(searchResults.at(searchLink)[1], context.SearchElementBySystemIdentifier("second_correct_result_link"));
+
+  // Resolved links are not kept after search, so link generated later is found
+  ScAddr const & thirdNode = context.SearchElementBySystemIdentifier("third_constant_node");
+  ScAddr const & newLink = context.GenerateLink(ScType::ConstNodeLink);
+  context.SetLinkContent(newLink, "text");
+  context.GenerateConnector(ScType::ConstPermPosArc, thirdNode, newLink);
+  templateParamsVector[0] = ScTemplateParams();
+  templateParamsVector[0].Add(nodeVariable, thirdNode);
+  inference::Replacements newSearchResults;
+  templateSearcher.searchTemplate(searchTemplateAddr, templateParamsVector, variables, newSearchResults);
+  ASSERT_EQ(inference::ReplacementsUtils::GetColumnsAmount(newSearchResults), 2u);
+  EXPECT_EQ(newSearchResults.at(searchLink)[0], newLink);
+}
+
 TEST_F(TemplateSearchManagerTest, SearchWithoutContent_NoStructuresTestCase)
 {
   ScMemoryContext & context = *m_ctx;
@@ -222,6 +292,75 @@ TEST_F(TemplateSearchManagerTest, SearchWithContent_EmptyLinkTestCase)
       context.SearchElementBySystemIdentifier(correctResultLinkIdentifier));
 }
 
+TEST_F(TemplateSearchManagerTest, SearchInSmallStructureByItsElementsTest)
+{
+  ScMemoryContext & context = *m_ctx;
+
+  loader.loadScsFile(context, TEST_FILES_DIR_PATH + "searchInSmallStructureTest.scs");
+
+  ScAddr const & searchTemplateAddr = context.SearchElementBySystemIdentifier(TEST_SEARCH_TEMPLATE_ID);
+  ScAddr const & inputStructure = context.SearchElementBySystemIdentifier("input_structure");
+  inference::TemplateSearcherInStructures templateSearcher(&context);
+  templateSearcher.setInputStructures({inputStructure});
+  templateSearcher.SetReplacementsUsingType(inference::REPLACEMENTS_ALL);
+  ScAddrUnorderedSet variables;
+  templateSearcher.getVariables(searchTemplateAddr, variables);
+  inference::Replacements searchResults;
+  templateSearcher.searchTemplate(searchTemplateAddr, ScTemplateParams(), variables, searchResults);
+
+  // Third node is a member of the class, but it is not in the input structure
+  ScAddrVector nodes = searchResults.at(context.SearchElementBySystemIdentifier("_node"));
+  std::sort(nodes.begin(), nodes.end(), ScAddrLessFunc());
+  ScAddrVector expectedNodes{
+      context.SearchElementBySystemIdentifier("first_node"), context.SearchElementBySystemIdentifier("second_node")};
+  std::sort(expectedNodes.begin(), expectedNodes.end(), ScAddrLessFunc());
+  EXPECT_EQ(nodes, expectedNodes);
+  EXPECT_EQ(inference::ReplacementsUtils::GetColumnsAmount(searchResults), 2u);
+
+  // Variable bound by params is not used to take values from input structure
+  ScTemplateParams templateParams;
+  templateParams.Add(
+      context.SearchElementBySystemIdentifier("_node"), context.SearchElementBySystemIdentifier("third_node"));
+  inference::Replacements boundSearchResults;
+  templateSearcher.searchTemplate(searchTemplateAddr, templateParams, variables, boundSearchResults);
+  EXPECT_EQ(inference::ReplacementsUtils::GetColumnsAmount(boundSearchResults), 0u);
+}
+
+TEST_F(TemplateSearchManagerTest, SearchInSmallStructureAfterItGetsNewElementsTest)
+{
+  ScMemoryContext & context = *m_ctx;
+
+  loader.loadScsFile(context, TEST_FILES_DIR_PATH + "searchInSmallStructureTest.scs");
+
+  ScAddr const & searchTemplateAddr = context.SearchElementBySystemIdentifier(TEST_SEARCH_TEMPLATE_ID);
+  ScAddr const & inputStructure = context.SearchElementBySystemIdentifier("input_structure");
+  inference::TemplateSearcherInStructures templateSearcher(&context);
+  templateSearcher.setInputStructures({inputStructure});
+  templateSearcher.SetReplacementsUsingType(inference::REPLACEMENTS_ALL);
+  ScAddrUnorderedSet variables;
+  templateSearcher.getVariables(searchTemplateAddr, variables);
+  inference::Replacements searchResults;
+  templateSearcher.searchTemplate(searchTemplateAddr, ScTemplateParams(), variables, searchResults);
+  EXPECT_EQ(inference::ReplacementsUtils::GetColumnsAmount(searchResults), 2u);
+
+  // Construction of the third node is added to the input structure like generated construction to output structure
+  ScAddr const & testClass = context.SearchElementBySystemIdentifier("test_class");
+  ScAddr const & thirdNode = context.SearchElementBySystemIdentifier("third_node");
+  ScAddr const & thirdValue = context.SearchElementBySystemIdentifier("third_value");
+  ScIterator3Ptr const & classArcIterator = context.CreateIterator3(testClass, ScType::ConstPermPosArc, thirdNode);
+  ASSERT_TRUE(classArcIterator->Next());
+  ScIterator3Ptr const & valueArcIterator = context.CreateIterator3(thirdNode, ScType::ConstPermPosArc, thirdValue);
+  ASSERT_TRUE(valueArcIterator->Next());
+  for (ScAddr const & element : {classArcIterator->Get(1), thirdNode, valueArcIterator->Get(1), thirdValue})
+    context.GenerateConnector(ScType::ConstPermPosArc, inputStructure, element);
+
+  inference::Replacements extendedSearchResults;
+  templateSearcher.searchTemplate(searchTemplateAddr, ScTemplateParams(), variables, extendedSearchResults);
+  EXPECT_EQ(inference::ReplacementsUtils::GetColumnsAmount(extendedSearchResults), 3u);
+  ScAddrVector const & nodes = extendedSearchResults.at(context.SearchElementBySystemIdentifier("_node"));
+  EXPECT_NE(std::find(nodes.cbegin(), nodes.cend(), thirdNode), nodes.cend());
+}
+
 TEST_F(TemplateSearchManagerTest, SearchWithExistedConstructionsTest)
 {
   std::string const & structure1Identifier = "test_structure_1";
@@ -0,0 +1,75 @@
+/*
+ * This source file is part of an OSTIS project. For the latest info, see http://ostis.net
+ * Distributed under the MIT License
+ * (See accompanying file COPYING.MIT or copy at http://opensource.org/licenses/MIT)
+ */
+
+#pragma once
+
+#include <sc-memory/sc_memory.hpp>
+
+#include "sc-memory-profiler/sc_memory_profiler.hpp"
+
+namespace utils
+{
+/**
+ * Wraps sc-memory context and measures every call forwarded to it as a separate call of profiler active on the
+ * current thread. Iterators are measured when they are created, their traversal is not measured
+ */
+class ScMemoryProfiledContext
+{
+public:
+  explicit ScMemoryProfiledContext(ScMemoryContext * context);
+
+  /// Get wrapped context for calls that are not measured
+  ScMemoryContext * Get() const;
+
+  ScAddr GenerateNode(ScType const & nodeType);
+
+  ScAddr GenerateLink(ScType const & linkType = ScType::ConstNodeLink);
+
+  ScAddr GenerateConnector(ScType const & connectorType, ScAddr const & source, ScAddr const & target);
+
+  /// Generate connector between source and target and membership arc from relation to it
+  ScAddr GenerateRelationBetween(
+      ScType const & connectorType,
+      ScAddr const & source,
+      ScAddr const & target,
+      ScAddr const & relation);
+
+  bool CheckConnector(ScAddr const & source, ScAddr const & target, ScType const & connectorType) const;
+
+  bool EraseElement(ScAddr const & element);
+
+  void SearchByTemplate(ScTemplate const & searchTemplate, ScTemplateSearchResult & searchResult) const;
+
+  template <typename ParamType1, typename ParamType2, typename ParamType3>
+  ScIterator3Ptr CreateIterator3(ParamType1 const & param1, ParamType2 const & param2, ParamType3 const & param3)
+      const
+  {
+    ScMemoryProfiler::Scope const profilerScope(ScMemoryCallType::CREATE_ITERATOR);
+    return context->CreateIterator3(param1, param2, param3);
+  }
+
+  template <
+      typename ParamType1,
+      typename ParamType2,
+      typename ParamType3,
+      typename ParamType4,
+      typename ParamType5>
+  ScIterator5Ptr CreateIterator5(
+      ParamType1 const & param1,
+      ParamType2 const & param2,
+      ParamType3 const & param3,
+      ParamType4 const & param4,
+      ParamType5 const & param5) const
+  {
+    ScMemoryProfiler::Scope const profilerScope(ScMemoryCallType::CREATE_ITERATOR);
+    return context->CreateIterator5(param1, param2, param3, param4, param5);
+  }
+
+private:
+  ScMemoryContext * context;
+};
+
+}  // namespace utils
@@ -0,0 +1,125 @@
+/*
+ * This source file is part of an OSTIS project. For the latest info, see http://ostis.net
+ * Distributed under the MIT License
+ * (See accompanying file COPYING.MIT or copy at http://opensource.org/licenses/MIT)
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <sc-memory/sc_memory.hpp>
+
+namespace utils
+{
+enum class ScMemoryCallType : size_t
+{
+  CREATE_ITERATOR,
+  CHECK_CONNECTOR,
+  BUILD_TEMPLATE,
+  SEARCH_BY_TEMPLATE,
+  GENERATE_BY_TEMPLATE,
+  GENERATE_ELEMENT,
+  ERASE_ELEMENT,
+  COUNT
+};
+
+/**
+ * Counts and times sc-memory calls by formulas they are issued for. Calls are measured only on threads
+ * where profiler is activated, so inactive profiling costs one thread local read per call. Calls may be nested, like
+ * iterators created while template is searched: statistics durations exclude nested calls, so they add up to measured
+ * time, and trace events keep whole durations to be shown nested
+ */
+class ScMemoryProfiler
+{
+public:
+  struct CallsStatistics
+  {
+    size_t callsAmount = 0;
+    std::chrono::nanoseconds duration{0};
+  };
+
+  using FormulaStatistics = std::array<CallsStatistics, static_cast<size_t>(ScMemoryCallType::COUNT)>;
+
+  /// Measure sc-memory call from construction until destruction, scopes constructed inside it are nested calls
+  class Scope
+  {
+  public:
+    explicit Scope(ScMemoryCallType type);
+
+    ~Scope();
+
+    Scope(Scope const & other) = delete;
+    Scope & operator=(Scope const & other) = delete;
+
+  private:
+    ScMemoryCallType const type;
+    ScMemoryProfiler * const profiler;
+    Scope * const parent;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::nanoseconds nestedDuration{0};
+  };
+
+  /// Activate profiler on the current thread and attribute calls to formula, previous activation is restored after
+  class Activation
+  {
+  public:
+    Activation(ScMemoryProfiler * profiler, ScAddr const & formula = ScAddr::Empty);
+
+    ~Activation();
+
+    Activation(Activation const & other) = delete;
+    Activation & operator=(Activation const & other) = delete;
+
+  private:
+    ScMemoryProfiler * const previousProfiler;
+    ScAddr const previousFormula;
+  };
+
+  /// @param maxTraceEventsAmount is a maximum amount of calls stored for trace, calls after it are only counted
+  explicit ScMemoryProfiler(size_t maxTraceEventsAmount = 1000000);
+
+  /// Get profiler active on the current thread to activate it on pool workers
+  static ScMemoryProfiler * GetActive();
+
+  /// Get formula that calls on the current thread are attributed to
+  static ScAddr GetActiveFormula();
+
+  static std::string GetCallTypeName(ScMemoryCallType type);
+
+  std::unordered_map<ScAddr, FormulaStatistics, ScAddrHashFunc> GetStatistics() const;
+
+  /// Convert calls to Chrome trace event format, that is supported by Perfetto too
+  std::string ToChromeTrace(ScMemoryContext * context) const;
+
+private:
+  struct TraceEvent
+  {
+    ScMemoryCallType type;
+    ScAddr formula;
+    std::thread::id thread;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::nanoseconds duration;
+  };
+
+  void Record(
+      ScMemoryCallType type,
+      ScAddr const & formula,
+      std::chrono::steady_clock::time_point start,
+      std::chrono::nanoseconds duration,
+      std::chrono::nanoseconds nestedDuration);
+
+  size_t const maxTraceEventsAmount;
+  std::chrono::steady_clock::time_point const creationTime;
+  mutable std::mutex mutex;
+  std::unordered_map<ScAddr, FormulaStatistics, ScAddrHashFunc> statistics;
+  std::vector<TraceEvent> traceEvents;
+};
+
+}  // namespace utils
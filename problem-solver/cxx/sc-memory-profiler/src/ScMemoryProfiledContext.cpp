@@ -0,0 +1,74 @@
+/*
+ * This source file is part of an OSTIS project. For the latest info, see http://ostis.net
+ * Distributed under the MIT License
+ * (See accompanying file COPYING.MIT or copy at http://opensource.org/licenses/MIT)
+ */
+
+#include "sc-memory-profiler/sc_memory_profiled_context.hpp"
+
+using namespace utils;
+
+ScMemoryProfiledContext::ScMemoryProfiledContext(ScMemoryContext * context)
+  : context(context)
+{
+}
+
+ScMemoryContext * ScMemoryProfiledContext::Get() const
+{
+  return context;
+}
+
+ScAddr ScMemoryProfiledContext::GenerateNode(ScType const & nodeType)
+{
+  ScMemoryProfiler::Scope const profilerScope(ScMemoryCallType::GENERATE_ELEMENT);
+  return context->GenerateNode(nodeType);
+}
+
+ScAddr ScMemoryProfiledContext::GenerateLink(ScType const & linkType)
+{
+  ScMemoryProfiler::Scope const profilerScope(ScMemoryCallType::GENERATE_ELEMENT);
+  return context->GenerateLink(linkType);
+}
+
+ScAddr ScMemoryProfiledContext::GenerateConnector(
+    ScType const & connectorType,
+    ScAddr const & source,
+    ScAddr const & target)
+{
+  ScMemoryProfiler::Scope const profilerScope(ScMemoryCallType::GENERATE_ELEMENT);
+  return context->GenerateConnector(connectorType, source, target);
+}
+
+ScAddr ScMemoryProfiledContext::GenerateRelationBetween(
+    ScType const & connectorType,
+    ScAddr const & source,
+    ScAddr const & target,
+    ScAddr const & relation)
+{
+  ScAddr const & connector = GenerateConnector(connectorType, source, target);
+  GenerateConnector(ScType::ConstPermPosArc, relation, connector);
+  return connector;
+}
+
+bool ScMemoryProfiledContext::CheckConnector(
+    ScAddr const & source,
+    ScAddr const & target,
+    ScType const & connectorType) const
+{
+  ScMemoryProfiler::Scope const profilerScope(ScMemoryCallType::CHECK_CONNECTOR);
+  return context->CheckConnector(source, target, connectorType);
+}
+
+bool ScMemoryProfiledContext::EraseElement(ScAddr const & element)
+{
+  ScMemoryProfiler::Scope const profilerScope(ScMemoryCallType::ERASE_ELEMENT);
+  return context->EraseElement(element);
+}
+
+void ScMemoryProfiledContext::SearchByTemplate(
+    ScTemplate const & searchTemplate,
+    ScTemplateSearchResult & searchResult) const
+{
+  ScMemoryProfiler::Scope const profilerScope(ScMemoryCallType::SEARCH_BY_TEMPLATE);
+  context->SearchByTemplate(searchTemplate, searchResult);
+}
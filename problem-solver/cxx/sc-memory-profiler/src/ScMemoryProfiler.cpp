@@ -0,0 +1,180 @@
+/*
+ * This source file is part of an OSTIS project. For the latest info, see http://ostis.net
+ * Distributed under the MIT License
+ * (See accompanying file COPYING.MIT or copy at http://opensource.org/licenses/MIT)
+ */
+
+#include "sc-memory-profiler/sc_memory_profiler.hpp"
+
+#include <cstdio>
+#include <functional>
+
+using namespace utils;
+
+namespace
+{
+void WriteJsonString(std::string & json, std::string const & value)
+{
+  json += '"';
+  for (char const symbol : value)
+  {
+    switch (symbol)
+    {
+    case '"':
+      json += "\\\"";
+      break;
+    case '\\':
+      json += "\\\\";
+      break;
+    case '\n':
+      json += "\\n";
+      break;
+    case '\t':
+      json += "\\t";
+      break;
+    default:
+      if (static_cast<unsigned char>(symbol) < 0x20)
+      {
+        char escaped[7];
+        std::snprintf(escaped, sizeof(escaped), "\\u%04x", symbol);
+        json += escaped;
+      }
+      else
+        json += symbol;
+    }
+  }
+  json += '"';
+}
+
+thread_local ScMemoryProfiler * activeProfiler = nullptr;
+thread_local ScAddr activeFormula;
+thread_local ScMemoryProfiler::Scope * activeScope = nullptr;
+}  // namespace
+
+ScMemoryProfiler::Scope::Scope(ScMemoryCallType type)
+  : type(type)
+  , profiler(activeProfiler)
+  , parent(profiler ? activeScope : nullptr)
+{
+  if (!profiler)
+    return;
+  activeScope = this;
+  start = std::chrono::steady_clock::now();
+}
+
+ScMemoryProfiler::Scope::~Scope()
+{
+  if (!profiler)
+    return;
+  std::chrono::nanoseconds const duration = std::chrono::steady_clock::now() - start;
+  profiler->Record(type, activeFormula, start, duration, nestedDuration);
+  if (parent)
+    parent->nestedDuration += duration;
+  activeScope = parent;
+}
+
+ScMemoryProfiler::Activation::Activation(ScMemoryProfiler * profiler, ScAddr const & formula)
+  : previousProfiler(activeProfiler)
+  , previousFormula(activeFormula)
+{
+  activeProfiler = profiler;
+  activeFormula = formula;
+}
+
+ScMemoryProfiler::Activation::~Activation()
+{
+  activeProfiler = previousProfiler;
+  activeFormula = previousFormula;
+}
+
+ScMemoryProfiler::ScMemoryProfiler(size_t maxTraceEventsAmount)
+  : maxTraceEventsAmount(maxTraceEventsAmount)
+  , creationTime(std::chrono::steady_clock::now())
+{
+}
+
+ScMemoryProfiler * ScMemoryProfiler::GetActive()
+{
+  return activeProfiler;
+}
+
+ScAddr ScMemoryProfiler::GetActiveFormula()
+{
+  return activeFormula;
+}
+
+std::string ScMemoryProfiler::GetCallTypeName(ScMemoryCallType type)
+{
+  switch (type)
+  {
+  case ScMemoryCallType::CREATE_ITERATOR:
+    return "CreateIterator";
+  case ScMemoryCallType::CHECK_CONNECTOR:
+    return "CheckConnector";
+  case ScMemoryCallType::BUILD_TEMPLATE:
+    return "BuildTemplate";
+  case ScMemoryCallType::SEARCH_BY_TEMPLATE:
+    return "SearchByTemplate";
+  case ScMemoryCallType::GENERATE_BY_TEMPLATE:
+    return "GenerateByTemplate";
+  case ScMemoryCallType::GENERATE_ELEMENT:
+    return "GenerateElement";
+  case ScMemoryCallType::ERASE_ELEMENT:
+    return "EraseElement";
+  default:
+    return "Unknown";
+  }
+}
+
+std::unordered_map<ScAddr, ScMemoryProfiler::FormulaStatistics, ScAddrHashFunc> ScMemoryProfiler::GetStatistics() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return statistics;
+}
+
+std::string ScMemoryProfiler::ToChromeTrace(ScMemoryContext * context) const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  std::unordered_map<ScAddr, std::string, ScAddrHashFunc> formulasNames;
+  for (auto const & [formula, formulaStatistics] : statistics)
+  {
+    std::string name = formula.IsValid() ? context->GetElementSystemIdentifier(formula) : "";
+    if (name.empty())
+      name = formula.IsValid() ? std::to_string(formula.Hash()) : "without formula";
+    formulasNames.emplace(formula, std::move(name));
+  }
+
+  std::string trace = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+  for (size_t i = 0; i < traceEvents.size(); ++i)
+  {
+    TraceEvent const & event = traceEvents[i];
+    if (i > 0)
+      trace += ',';
+    auto const startMicroseconds =
+        std::chrono::duration<double, std::micro>(event.start - creationTime).count();
+    auto const durationMicroseconds = std::chrono::duration<double, std::micro>(event.duration).count();
+    trace += "{\"name\":\"" + GetCallTypeName(event.type) + "\",\"cat\":\"sc-memory\",\"ph\":\"X\",\"pid\":1,\"tid\":" +
+             std::to_string(std::hash<std::thread::id>{}(event.thread)) + ",\"ts\":" +
+             std::to_string(startMicroseconds) + ",\"dur\":" + std::to_string(durationMicroseconds) +
+             ",\"args\":{\"formula\":";
+    WriteJsonString(trace, formulasNames.at(event.formula));
+    trace += "}}";
+  }
+  trace += "]}";
+  return trace;
+}
+
+void ScMemoryProfiler::Record(
+    ScMemoryCallType type,
+    ScAddr const & formula,
+    std::chrono::steady_clock::time_point start,
+    std::chrono::nanoseconds duration,
+    std::chrono::nanoseconds nestedDuration)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  CallsStatistics & callsStatistics = statistics[formula][static_cast<size_t>(type)];
+  ++callsStatistics.callsAmount;
+  callsStatistics.duration += duration - nestedDuration;
+  if (traceEvents.size() < maxTraceEventsAmount)
+    traceEvents.push_back({type, formula, std::this_thread::get_id(), start, duration});
+}
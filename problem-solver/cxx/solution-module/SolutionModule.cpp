@@ -7,6 +7,19 @@
 #include "SolutionModule.hpp"
 
 #include "agent/EraseSolutionAgent.hpp"
+#include "agent/EraseSolutionInBackgroundAgent.hpp"
+
+#include "manager/EraseSolutionWorker.hpp"
 
 using namespace solutionModule;
-SC_MODULE_REGISTER(SolutionModule)->Agent<EraseSolutionAgent>();
+SC_MODULE_REGISTER(SolutionModule)->Agent<EraseSolutionAgent>()->Agent<EraseSolutionInBackgroundAgent>();
+
+void SolutionModule::Initialize(ScMemoryContext * context)
+{
+  EraseSolutionWorker::GetInstance().Start(EraseSolutionWorker::GetConfiguredElementsPerSecond(context));
+}
+
+void SolutionModule::Shutdown(ScMemoryContext * context)
+{
+  EraseSolutionWorker::GetInstance().Stop();
+}
@@ -13,5 +13,9 @@ namespace solutionModule
 
 class SolutionModule : public ScModule
 {
+public:
+  void Initialize(ScMemoryContext * context) override;
+
+  void Shutdown(ScMemoryContext * context) override;
 };
 }  // namespace solutionModule
@@ -28,7 +28,7 @@ ScResult EraseSolutionAgent::DoProgram(ScActionInitiatedEvent const & event, ScA
       SC_THROW_EXCEPTION(utils::ExceptionItemNotFound, GetName() << ": solution is not valid");
 
     auto manager = std::make_unique<EraseSolutionManager>(&m_context, &m_logger);
-    manager->eraseSolution(solution);
+    manager->eraseSolutionInBulk(solution);
 
     return action.FinishSuccessfully();
   }
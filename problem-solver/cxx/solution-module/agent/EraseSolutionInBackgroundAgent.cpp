@@ -0,0 +1,51 @@
+/*
+ * This source file is part of an OSTIS project. For the latest info, see http://ostis.net
+ * Distributed under the MIT License
+ * (See accompanying file COPYING.MIT or copy at http://opensource.org/licenses/MIT)
+ */
+
+#include "EraseSolutionInBackgroundAgent.hpp"
+
+#include "keynodes/SolutionKeynodes.hpp"
+
+#include "manager/EraseSolutionManager.hpp"
+#include "manager/EraseSolutionWorker.hpp"
+
+namespace solutionModule
+{
+
+EraseSolutionInBackgroundAgent::EraseSolutionInBackgroundAgent()
+{
+  m_logger = utils::ScLogger(
+      utils::ScLogger::ScLogType::File, "logs/EraseSolutionInBackgroundAgent.log", utils::ScLogLevel::Debug, true);
+}
+
+ScResult EraseSolutionInBackgroundAgent::DoProgram(ScActionInitiatedEvent const & event, ScAction & action)
+{
+  ScAddr const & solution = action.GetArgument(1);
+  try
+  {
+    if (!m_context.IsElement(solution))
+      SC_THROW_EXCEPTION(utils::ExceptionItemNotFound, GetName() << ": solution is not valid");
+
+    if (!EraseSolutionWorker::GetInstance().Enqueue(solution))
+    {
+      m_logger.Warning(GetName(), ": background worker is not running, solution is erased synchronously");
+      auto manager = std::make_unique<EraseSolutionManager>(&m_context, &m_logger);
+      manager->eraseSolutionInBulk(solution);
+    }
+
+    return action.FinishSuccessfully();
+  }
+  catch (utils::ScException const & exception)
+  {
+    m_logger.Error(exception.Message());
+    return action.FinishWithError();
+  }
+}
+
+ScAddr EraseSolutionInBackgroundAgent::GetActionClass() const
+{
+  return SolutionKeynodes::action_erase_solution_in_background;
+}
+}  // namespace solutionModule
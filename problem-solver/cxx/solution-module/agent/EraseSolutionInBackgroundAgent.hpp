@@ -0,0 +1,28 @@
+/*
+ * This source file is part of an OSTIS project. For the latest info, see http://ostis.net
+ * Distributed under the MIT License
+ * (See accompanying file COPYING.MIT or copy at http://opensource.org/licenses/MIT)
+ */
+
+#pragma once
+
+#include <sc-memory/sc_agent.hpp>
+
+namespace solutionModule
+{
+/**
+ * Queues solution to be erased by `EraseSolutionWorker` and finishes without waiting for erasing. Successful finish
+ * means that solution is accepted for erasing, not that it is erased: accepted solutions are erased later, at the
+ * latest when the worker is stopped on module shutdown
+ */
+class EraseSolutionInBackgroundAgent : public ScActionInitiatedAgent
+{
+public:
+  EraseSolutionInBackgroundAgent();
+
+  ScAddr GetActionClass() const override;
+
+  ScResult DoProgram(ScActionInitiatedEvent const & event, ScAction & action) override;
+};
+
+}  // namespace solutionModule
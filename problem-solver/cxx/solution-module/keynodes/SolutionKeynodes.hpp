@@ -14,5 +14,11 @@ class SolutionKeynodes : public ScKeynodes
 {
 public:
   static inline ScKeynode const action_erase_solution{"action_erase_solution"};
+
+  static inline ScKeynode const action_erase_solution_in_background{"action_erase_solution_in_background"};
+
+  static inline ScKeynode const nrel_erased_elements_per_second{"nrel_erased_elements_per_second"};
+
+  static inline ScKeynode const nrel_inference_trace{"nrel_inference_trace"};
 };
 }  // namespace solutionModule
@@ -6,8 +6,17 @@
 
 #include "EraseSolutionManager.hpp"
 
+#include "keynodes/SolutionKeynodes.hpp"
+
+#include <algorithm>
+
 #include <sc-agents-common/utils/IteratorUtils.hpp>
 
+#include <sc-memory-profiler/sc_memory_profiler.hpp>
+
+using utils::ScMemoryCallType;
+using utils::ScMemoryProfiler;
+
 namespace solutionModule
 {
 EraseSolutionManager::EraseSolutionManager(ScMemoryContext * context, utils::ScLogger * logger)
@@ -22,13 +31,131 @@ void EraseSolutionManager::eraseSolution(ScAddr const & solution) const
     SC_THROW_EXCEPTION(utils::ExceptionItemNotFound, "EraseSolutionManager: solution is not valid");
   ScAddrList const & ruleAndSubstitutionPairs = getListFromSet(solution);
   logger->Debug("EraseSolutionManager: Solution has ", ruleAndSubstitutionPairs.size(), " elements");
+  ScAddrVector traceElements;
+  collectTraceElements(solution, traceElements);
   safeEraseElement(solution);
   eraseRuleAndSubstitutionsPairs(ruleAndSubstitutionPairs);
+  for (ScAddr const & traceElement : traceElements)
+    safeEraseElement(traceElement);
+}
+
+void EraseSolutionManager::eraseSolutionInBulk(ScAddr const & solution) const
+{
+  if (context->IsElement(solution) == SC_FALSE)
+    SC_THROW_EXCEPTION(utils::ExceptionItemNotFound, "EraseSolutionManager: solution is not valid");
+  ScAddrVector const & elements = collectSolutionElements(solution);
+  logger->Debug("EraseSolutionManager: Solution has ", elements.size(), " elements to erase");
+  size_t const erasedElementsCount = eraseElements(elements.cbegin(), elements.cend());
+  logger->Debug("EraseSolutionManager: Erased ", erasedElementsCount, " elements");
+}
+
+ScAddrVector EraseSolutionManager::collectSolutionElements(ScAddr const & solution) const
+{
+  ScAddrVector nodes{solution};
+  ScAddrVector connectors;
+  {
+    ScMemoryProfiler::Scope const profilerScope(ScMemoryCallType::CREATE_ITERATOR);
+    ScIterator3Ptr const & solutionNodesIterator =
+        context->CreateIterator3(solution, ScType::ConstPermPosArc, ScType::ConstNode);
+    while (solutionNodesIterator->Next())
+    {
+      ScAddr const & solutionNode = solutionNodesIterator->Get(2);
+      nodes.push_back(solutionNode);
+      ScIterator5Ptr const & substitutionsIterator = context->CreateIterator5(
+          solutionNode, ScType::ConstPermPosArc, ScType::Unknown, ScType::ConstPermPosArc, ScKeynodes::rrel_2);
+      while (substitutionsIterator->Next())
+        collectSubstitutionsElements(substitutionsIterator->Get(2), nodes, connectors);
+    }
+  }
+  collectTraceElements(solution, nodes);
+
+  sortAndRemoveDuplicates(connectors);
+  sortAndRemoveDuplicates(nodes);
+  connectors.insert(connectors.end(), nodes.cbegin(), nodes.cend());
+  return connectors;
+}
+
+void EraseSolutionManager::collectTraceElements(ScAddr const & solution, ScAddrVector & nodes) const
+{
+  ScMemoryProfiler::Scope const profilerScope(ScMemoryCallType::CREATE_ITERATOR);
+  ScIterator5Ptr const & tracesIterator = context->CreateIterator5(
+      solution,
+      ScType::ConstCommonArc,
+      ScType::ConstNodeStructure,
+      ScType::ConstPermPosArc,
+      SolutionKeynodes::nrel_inference_trace);
+  while (tracesIterator->Next())
+  {
+    ScAddr const & trace = tracesIterator->Get(2);
+    nodes.push_back(trace);
+    ScIterator3Ptr const & linksIterator =
+        context->CreateIterator3(trace, ScType::ConstPermPosArc, ScType::ConstNodeLink);
+    while (linksIterator->Next())
+      nodes.push_back(linksIterator->Get(2));
+  }
+}
+
+void EraseSolutionManager::collectSubstitutionsElements(
+    ScAddr const & substitutions,
+    ScAddrVector & nodes,
+    ScAddrVector & connectors) const
+{
+  nodes.push_back(substitutions);
+  ScMemoryProfiler::Scope const profilerScope(ScMemoryCallType::CREATE_ITERATOR);
+  ScIterator3Ptr const & substitutionPairsIterator =
+      context->CreateIterator3(substitutions, ScType::ConstPermPosArc, ScType::ConstNode);
+  while (substitutionPairsIterator->Next())
+  {
+    ScAddr const & substitutionPair = substitutionPairsIterator->Get(2);
+    nodes.push_back(substitutionPair);
+    ScAddr replacement;
+    ScAddr variable;
+    ScIterator5Ptr const & pairElementsIterator = context->CreateIterator5(
+        substitutionPair, ScType::ConstPermPosArc, ScType::Unknown, ScType::ConstPermPosArc, ScType::ConstNodeRole);
+    while (pairElementsIterator->Next())
+    {
+      if (pairElementsIterator->Get(4) == ScKeynodes::rrel_1)
+        replacement = pairElementsIterator->Get(2);
+      else if (pairElementsIterator->Get(4) == ScKeynodes::rrel_2)
+        variable = pairElementsIterator->Get(2);
+    }
+    if (!replacement.IsValid() || !variable.IsValid())
+    {
+      logger->Warning("EraseSolutionManager: replacement or variable is invalid");
+      continue;
+    }
+    ScIterator3Ptr const & connectorsIterator =
+        context->CreateIterator3(variable, ScType::ConstTempPosArc, replacement);
+    while (connectorsIterator->Next())
+      connectors.push_back(connectorsIterator->Get(1));
+  }
+}
+
+size_t EraseSolutionManager::eraseElements(ScAddrVector::const_iterator begin, ScAddrVector::const_iterator end)
+    const
+{
+  size_t erasedElementsCount = 0;
+  for (auto element = begin; element != end; ++element)
+  {
+    ScMemoryProfiler::Scope const profilerScope(ScMemoryCallType::ERASE_ELEMENT);
+    if (context->EraseElement(*element))
+      ++erasedElementsCount;
+  }
+  return erasedElementsCount;
+}
+
+void EraseSolutionManager::sortAndRemoveDuplicates(ScAddrVector & elements)
+{
+  std::sort(elements.begin(), elements.end(), [](ScAddr const & first, ScAddr const & second) {
+    return first.Hash() < second.Hash();
+  });
+  elements.erase(std::unique(elements.begin(), elements.end()), elements.end());
 }
 
 ScAddrList EraseSolutionManager::getListFromSet(ScAddr const & set) const
 {
   ScAddrList setElements;
+  ScMemoryProfiler::Scope const profilerScope(ScMemoryCallType::CREATE_ITERATOR);
   ScIterator3Ptr const & fromSetIterator = context->CreateIterator3(set, ScType::ConstPermPosArc, ScType::ConstNode);
   while (fromSetIterator->Next())
     setElements.push_back(fromSetIterator->Get(2));
@@ -37,6 +164,7 @@ ScAddrList EraseSolutionManager::getListFromSet(ScAddr const & set) const
 
 void EraseSolutionManager::safeEraseElement(ScAddr const & element) const
 {
+  ScMemoryProfiler::Scope const profilerScope(ScMemoryCallType::ERASE_ELEMENT);
   if (context->IsElement(element))
     context->EraseElement(element);
 }
@@ -82,6 +210,7 @@ void EraseSolutionManager::eraseSubstitutions(ScAddr const & substitutions) cons
 void EraseSolutionManager::eraseConnectors(ScAddr const & source, ScType const & connectorType, ScAddr const & target)
     const
 {
+  ScMemoryProfiler::Scope const profilerScope(ScMemoryCallType::CREATE_ITERATOR);
   auto const & connectorsIterator = context->CreateIterator3(source, connectorType, target);
   while (connectorsIterator->Next())
     safeEraseElement(connectorsIterator->Get(1));
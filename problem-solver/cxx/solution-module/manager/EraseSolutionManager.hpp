@@ -17,10 +17,26 @@ public:
 
   void eraseSolution(ScAddr const & solution) const;
 
+  /// Erase solution with all its elements collected in one traversal
+  void eraseSolutionInBulk(ScAddr const & solution) const;
+
 private:
+  /// Worker erases collected elements in batches with its own budget
+  friend class EraseSolutionWorker;
+
   ScMemoryContext * context;
   utils::ScLogger * logger;
 
+  /**
+   * @brief Collect solution, its nodes, substitutions, substitution pairs, temporary arcs between variables and
+   * their replacements, and inference trace
+   * @returns distinct elements, connectors go before nodes so erasing of nodes doesn't invalidate them
+   */
+  ScAddrVector collectSolutionElements(ScAddr const & solution) const;
+
+  /// @returns amount of erased elements
+  size_t eraseElements(ScAddrVector::const_iterator begin, ScAddrVector::const_iterator end) const;
+
   void safeEraseElement(ScAddr const & element) const;
 
   void eraseRuleAndSubstitutionsPairs(ScAddrList const & ruleAndSubstitutionPairs) const;
@@ -30,6 +46,14 @@ private:
   ScAddrList getListFromSet(ScAddr const & set) const;
 
   void eraseConnectors(ScAddr const & source, ScType const & connectorType, ScAddr const & target) const;
+
+  /// Collect trace structures of solution and their links, formulas of trace are kept
+  void collectTraceElements(ScAddr const & solution, ScAddrVector & nodes) const;
+
+  void collectSubstitutionsElements(ScAddr const & substitutions, ScAddrVector & nodes, ScAddrVector & connectors)
+      const;
+
+  static void sortAndRemoveDuplicates(ScAddrVector & elements);
 };
 
 }  // namespace solutionModule
@@ -0,0 +1,162 @@
+/*
+ * This source file is part of an OSTIS project. For the latest info, see http://ostis.net
+ * Distributed under the MIT License
+ * (See accompanying file COPYING.MIT or copy at http://opensource.org/licenses/MIT)
+ */
+
+#include "EraseSolutionWorker.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+
+#include <sc-agents-common/utils/IteratorUtils.hpp>
+
+#include "keynodes/SolutionKeynodes.hpp"
+
+#include "EraseSolutionManager.hpp"
+
+namespace solutionModule
+{
+EraseSolutionWorker & EraseSolutionWorker::GetInstance()
+{
+  static EraseSolutionWorker instance;
+  return instance;
+}
+
+size_t EraseSolutionWorker::GetConfiguredElementsPerSecond(ScMemoryContext * context)
+{
+  ScAddr const & budgetLink = utils::IteratorUtils::getAnyByOutRelation(
+      context,
+      SolutionKeynodes::action_erase_solution_in_background,
+      SolutionKeynodes::nrel_erased_elements_per_second);
+  std::string content;
+  if (!budgetLink.IsValid() || !context->GetElementType(budgetLink).IsLink()
+      || !context->GetLinkContent(budgetLink, content))
+    return DEFAULT_ELEMENTS_PER_SECOND;
+
+  try
+  {
+    size_t position = 0;
+    size_t const elementsPerSecond = std::stoull(content, &position);
+    return position == content.size() ? elementsPerSecond : DEFAULT_ELEMENTS_PER_SECOND;
+  }
+  catch (std::logic_error const &)
+  {
+    return DEFAULT_ELEMENTS_PER_SECOND;
+  }
+}
+
+EraseSolutionWorker::~EraseSolutionWorker()
+{
+  Stop();
+}
+
+void EraseSolutionWorker::Start(size_t elementsPerSecond, size_t batchSize)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  if (isRunning)
+    return;
+  this->elementsPerSecond = elementsPerSecond;
+  this->batchSize = std::max<size_t>(batchSize, 1);
+  isRunning = true;
+  worker = std::thread(&EraseSolutionWorker::Run, this);
+}
+
+void EraseSolutionWorker::Stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!isRunning)
+      return;
+    isRunning = false;
+  }
+  queueCondition.notify_all();
+  if (worker.joinable())
+    worker.join();
+  idleCondition.notify_all();
+}
+
+bool EraseSolutionWorker::IsRunning() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return isRunning;
+}
+
+bool EraseSolutionWorker::Enqueue(ScAddr const & solution)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!isRunning)
+      return false;
+    queuedSolutions.insert(solution);
+  }
+  queueCondition.notify_one();
+  return true;
+}
+
+void EraseSolutionWorker::WaitForIdle()
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  idleCondition.wait(lock, [this]() {
+    return !isRunning || (queuedSolutions.empty() && !isBusy);
+  });
+}
+
+void EraseSolutionWorker::Run()
+{
+  ScMemoryContext context;
+  utils::ScLogger logger(
+      utils::ScLogger::ScLogType::File, "logs/EraseSolutionWorker.log", utils::ScLogLevel::Debug, true);
+  while (true)
+  {
+    ScAddrUnorderedSet solutions;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      isBusy = false;
+      idleCondition.notify_all();
+      queueCondition.wait(lock, [this]() {
+        return !isRunning || !queuedSolutions.empty();
+      });
+      // Solutions queued before stop are erased, so that actions finished after queueing are not lost
+      if (queuedSolutions.empty())
+        break;
+      solutions.swap(queuedSolutions);
+      isBusy = true;
+    }
+    EraseSolutions(context, logger, solutions);
+  }
+}
+
+void EraseSolutionWorker::EraseSolutions(
+    ScMemoryContext & context,
+    utils::ScLogger & logger,
+    ScAddrUnorderedSet const & solutions)
+{
+  EraseSolutionManager manager(&context, &logger);
+  auto const start = std::chrono::steady_clock::now();
+  size_t erasedElementsCount = 0;
+  for (ScAddr const & solution : solutions)
+  {
+    // Solution may be erased by another request while it was queued
+    if (!context.IsElement(solution))
+      continue;
+    ScAddrVector const & elements = manager.collectSolutionElements(solution);
+    logger.Debug("EraseSolutionWorker: Solution has ", elements.size(), " elements to erase");
+    for (size_t batchBegin = 0; batchBegin < elements.size(); batchBegin += batchSize)
+    {
+      size_t const batchEnd = std::min(batchBegin + batchSize, elements.size());
+      erasedElementsCount += manager.eraseElements(elements.cbegin() + batchBegin, elements.cbegin() + batchEnd);
+      // Remaining solutions are erased without budget when worker is stopped
+      if (elementsPerSecond == 0 || !IsRunning())
+        continue;
+      auto const budgetTime =
+          start + std::chrono::microseconds(erasedElementsCount * std::micro::den / elementsPerSecond);
+      std::this_thread::sleep_until(budgetTime);
+    }
+  }
+  logger.Debug("EraseSolutionWorker: Erased ", erasedElementsCount, " elements of ", solutions.size(), " solutions");
+}
+
+}  // namespace solutionModule
@@ -0,0 +1,75 @@
+/*
+ * This source file is part of an OSTIS project. For the latest info, see http://ostis.net
+ * Distributed under the MIT License
+ * (See accompanying file COPYING.MIT or copy at http://opensource.org/licenses/MIT)
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include <sc-memory/sc_memory_headers.hpp>
+
+namespace solutionModule
+{
+/**
+ * Erases queued solutions on a separate thread. Repeated requests for the same solution are coalesced, elements are
+ * erased in batches, and the amount of erased elements per second is limited so that cleanup of large solutions
+ * doesn't block other agents working with sc-memory
+ */
+class EraseSolutionWorker
+{
+public:
+  static constexpr size_t DEFAULT_ELEMENTS_PER_SECOND = 50000;
+  static constexpr size_t DEFAULT_BATCH_SIZE = 1000;
+
+  static EraseSolutionWorker & GetInstance();
+
+  /**
+   * @brief Read budget of erased elements per second from knowledge base, it is set as
+   * `action_erase_solution_in_background => nrel_erased_elements_per_second: [<number>];;`
+   * @returns DEFAULT_ELEMENTS_PER_SECOND if budget is not set or is not a number
+   */
+  static size_t GetConfiguredElementsPerSecond(ScMemoryContext * context);
+
+  ~EraseSolutionWorker();
+
+  /**
+   * @brief Start worker thread
+   * @param elementsPerSecond is a budget of erased elements per second, 0 means no limit
+   * @param batchSize is an amount of elements erased between budget checks
+   */
+  void Start(size_t elementsPerSecond = DEFAULT_ELEMENTS_PER_SECOND, size_t batchSize = DEFAULT_BATCH_SIZE);
+
+  /// Stop accepting solutions and stop worker thread after all queued solutions are erased without budget
+  void Stop();
+
+  bool IsRunning() const;
+
+  /// @returns false if worker is not running and solution was not queued
+  bool Enqueue(ScAddr const & solution);
+
+  /// Block until all queued solutions are erased
+  void WaitForIdle();
+
+private:
+  EraseSolutionWorker() = default;
+
+  void Run();
+
+  void EraseSolutions(ScMemoryContext & context, utils::ScLogger & logger, ScAddrUnorderedSet const & solutions);
+
+  mutable std::mutex mutex;
+  std::condition_variable queueCondition;
+  std::condition_variable idleCondition;
+  std::thread worker;
+  ScAddrUnorderedSet queuedSolutions;
+  bool isRunning = false;
+  bool isBusy = false;
+  size_t elementsPerSecond = DEFAULT_ELEMENTS_PER_SECOND;
+  size_t batchSize = DEFAULT_BATCH_SIZE;
+};
+
+}  // namespace solutionModule
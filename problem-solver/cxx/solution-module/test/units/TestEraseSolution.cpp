@@ -5,12 +5,17 @@
  */
 
 #include "agent/EraseSolutionAgent.hpp"
+#include "agent/EraseSolutionInBackgroundAgent.hpp"
+#include "manager/EraseSolutionManager.hpp"
+#include "manager/EraseSolutionWorker.hpp"
 
 #include <sc-memory/test/sc_test.hpp>
 #include <sc-builder/scs_loader.hpp>
 
 #include <sc-agents-common/utils/IteratorUtils.hpp>
 
+#include <sc-memory-profiler/sc_memory_profiler.hpp>
+
 namespace eraseSolutionAgentTest
 {
 ScsLoader loader;
@@ -71,6 +76,110 @@ TEST_F(EraseSolutionAgentTest, solutionHasSomeElements)
   shutdown(context);
 }
 
+TEST_F(EraseSolutionAgentTest, solutionIsErasedInBulk)
+{
+  ScAgentContext & context = *m_ctx;
+  loader.loadScsFile(context, ERASE_SOLUTION_MODULE_TEST_FILES_DIR_PATH + "actionWithNotEmptySolution.scs");
+
+  ScAddr const & solution = context.SearchElementBySystemIdentifier("solution");
+  ScAddr const & solutionNotForErase = context.SearchElementBySystemIdentifier("solution_not_for_erase");
+  ScAddr const & variable = context.SearchElementBySystemIdentifier("_variable");
+  ScAddrVector solutionElements;
+  for (std::string const & prefix : {"first", "second", "third"})
+  {
+    solutionElements.push_back(context.SearchElementBySystemIdentifier(prefix + "_solution"));
+    solutionElements.push_back(context.SearchElementBySystemIdentifier(prefix + "_substitutions"));
+    solutionElements.push_back(context.SearchElementBySystemIdentifier(prefix + "_substitution_pair_1"));
+    solutionElements.push_back(context.SearchElementBySystemIdentifier(prefix + "_substitution_pair_2"));
+  }
+  utils::ScLogger logger;
+  solutionModule::EraseSolutionManager manager(&context, &logger);
+
+  manager.eraseSolutionInBulk(solution);
+
+  // Solution, its nodes, substitutions and substitution pairs are erased with temporary arcs of replacements
+  EXPECT_FALSE(context.IsElement(solution));
+  for (ScAddr const & element : solutionElements)
+    EXPECT_FALSE(context.IsElement(element));
+  auto const & variableReplacementsIterator =
+      context.CreateIterator3(variable, ScType::ConstTempPosArc, ScType::Unknown);
+  EXPECT_TRUE(variableReplacementsIterator->Next());
+  EXPECT_EQ(variableReplacementsIterator->Get(2), context.SearchElementBySystemIdentifier("fourth_element"));
+  EXPECT_FALSE(variableReplacementsIterator->Next());
+
+  // Replacements and other solutions are kept
+  EXPECT_TRUE(context.IsElement(context.SearchElementBySystemIdentifier("first_element")));
+  EXPECT_TRUE(context.IsElement(solutionNotForErase));
+  EXPECT_TRUE(context.IsElement(context.SearchElementBySystemIdentifier("fourth_substitutions")));
+}
+
+TEST_F(EraseSolutionAgentTest, solutionIsErasedWithTrace)
+{
+  ScAgentContext & context = *m_ctx;
+  loader.loadScsFile(context, ERASE_SOLUTION_MODULE_TEST_FILES_DIR_PATH + "solutionWithTrace.scs");
+
+  ScAddr const & solution = context.SearchElementBySystemIdentifier("solution");
+  ScAddr const & trace = context.SearchElementBySystemIdentifier("trace");
+  ScAddr const & traceJson = context.SearchElementBySystemIdentifier("trace_json");
+  utils::ScLogger logger;
+  solutionModule::EraseSolutionManager manager(&context, &logger);
+
+  manager.eraseSolution(solution);
+
+  // Trace structure and its link are erased, formulas of trace are kept
+  EXPECT_FALSE(context.IsElement(solution));
+  EXPECT_FALSE(context.IsElement(trace));
+  EXPECT_FALSE(context.IsElement(traceJson));
+  EXPECT_TRUE(context.IsElement(context.SearchElementBySystemIdentifier("some_rule")));
+}
+
+TEST_F(EraseSolutionAgentTest, solutionIsErasedInBulkWithTrace)
+{
+  ScAgentContext & context = *m_ctx;
+  loader.loadScsFile(context, ERASE_SOLUTION_MODULE_TEST_FILES_DIR_PATH + "solutionWithTrace.scs");
+
+  ScAddr const & solution = context.SearchElementBySystemIdentifier("solution");
+  ScAddr const & trace = context.SearchElementBySystemIdentifier("trace");
+  ScAddr const & traceJson = context.SearchElementBySystemIdentifier("trace_json");
+  utils::ScLogger logger;
+  solutionModule::EraseSolutionManager manager(&context, &logger);
+
+  manager.eraseSolutionInBulk(solution);
+
+  EXPECT_FALSE(context.IsElement(solution));
+  EXPECT_FALSE(context.IsElement(context.SearchElementBySystemIdentifier("first_substitutions")));
+  EXPECT_FALSE(context.IsElement(trace));
+  EXPECT_FALSE(context.IsElement(traceJson));
+  EXPECT_TRUE(context.IsElement(context.SearchElementBySystemIdentifier("some_rule")));
+}
+
+TEST_F(EraseSolutionAgentTest, erasingIsProfiled)
+{
+  ScAgentContext & context = *m_ctx;
+  loader.loadScsFile(context, ERASE_SOLUTION_MODULE_TEST_FILES_DIR_PATH + "actionWithNotEmptySolution.scs");
+
+  ScAddr const & solution = context.SearchElementBySystemIdentifier("solution");
+  utils::ScLogger logger;
+  solutionModule::EraseSolutionManager manager(&context, &logger);
+
+  utils::ScMemoryProfiler profiler;
+  {
+    utils::ScMemoryProfiler::Activation const activation(&profiler);
+    manager.eraseSolutionInBulk(solution);
+  }
+  EXPECT_FALSE(context.IsElement(solution));
+
+  // Iterator of solution nodes with iterators of 3 substitutions nested in it and iterator of traces, calls are not
+  // attributed to formulas
+  auto const & statistics = profiler.GetStatistics();
+  ASSERT_EQ(statistics.size(), 1u);
+  auto const & callsStatistics = statistics.at(ScAddr::Empty);
+  auto const & iteratorsStatistics =
+      callsStatistics[static_cast<size_t>(utils::ScMemoryCallType::CREATE_ITERATOR)];
+  EXPECT_EQ(iteratorsStatistics.callsAmount, 5u);
+  EXPECT_EQ(callsStatistics[static_cast<size_t>(utils::ScMemoryCallType::ERASE_ELEMENT)].callsAmount, 19u);
+}
+
 TEST_F(EraseSolutionAgentTest, solutionIsInvalid)
 {
   ScAgentContext & context = *m_ctx;
@@ -84,4 +193,65 @@ TEST_F(EraseSolutionAgentTest, solutionIsInvalid)
   shutdown(context);
 }
 
+TEST_F(EraseSolutionAgentTest, solutionIsErasedInBackground)
+{
+  ScAgentContext & context = *m_ctx;
+  loader.loadScsFile(context, ERASE_SOLUTION_MODULE_TEST_FILES_DIR_PATH + "backgroundActionWithNotEmptySolution.scs");
+
+  solutionModule::EraseSolutionWorker & worker = solutionModule::EraseSolutionWorker::GetInstance();
+  worker.Start(1000, 5);
+  context.SubscribeAgent<solutionModule::EraseSolutionInBackgroundAgent>();
+
+  ScAddr const & variable = context.SearchElementBySystemIdentifier("_variable");
+  ScAddr const & conceptSolution = context.SearchElementBySystemIdentifier("concept_solution");
+  EXPECT_EQ(utils::IteratorUtils::getAllWithType(&context, conceptSolution, ScType::ConstNode).size(), 2u);
+
+  // Action is initiated first, so its argument exists when agent checks it. Repeated request is skipped by worker
+  // whether it is coalesced with the queued one or arrives after solution was erased
+  ScAddr const & solution = context.SearchElementBySystemIdentifier("solution");
+  ScAction testActionNode = context.ConvertToAction(context.SearchElementBySystemIdentifier("test_action_node"));
+  EXPECT_TRUE(testActionNode.InitiateAndWait(WAIT_TIME));
+  EXPECT_TRUE(testActionNode.IsFinishedSuccessfully());
+  EXPECT_TRUE(worker.Enqueue(solution));
+
+  worker.WaitForIdle();
+  EXPECT_FALSE(context.IsElement(solution));
+  EXPECT_EQ(utils::IteratorUtils::getAllWithType(&context, conceptSolution, ScType::ConstNode).size(), 1u);
+  auto const & variableReplacementsIterator =
+      context.CreateIterator3(variable, ScType::ConstTempPosArc, ScType::Unknown);
+  EXPECT_TRUE(variableReplacementsIterator->Next());
+  EXPECT_FALSE(variableReplacementsIterator->Next());
+
+  context.UnsubscribeAgent<solutionModule::EraseSolutionInBackgroundAgent>();
+  worker.Stop();
+  EXPECT_FALSE(worker.Enqueue(solution));
+}
+
+TEST_F(EraseSolutionAgentTest, queuedSolutionIsErasedOnStop)
+{
+  ScAgentContext & context = *m_ctx;
+  loader.loadScsFile(context, ERASE_SOLUTION_MODULE_TEST_FILES_DIR_PATH + "actionWithNotEmptySolution.scs");
+
+  // Budget is low enough for solution to be still queued or erased when worker is stopped
+  solutionModule::EraseSolutionWorker & worker = solutionModule::EraseSolutionWorker::GetInstance();
+  worker.Start(10, 1);
+  ScAddr const & solution = context.SearchElementBySystemIdentifier("solution");
+  EXPECT_TRUE(worker.Enqueue(solution));
+  worker.Stop();
+
+  EXPECT_FALSE(context.IsElement(solution));
+  EXPECT_TRUE(context.IsElement(context.SearchElementBySystemIdentifier("solution_not_for_erase")));
+}
+
+TEST_F(EraseSolutionAgentTest, erasedElementsPerSecondIsReadFromKnowledgeBase)
+{
+  ScAgentContext & context = *m_ctx;
+  EXPECT_EQ(
+      solutionModule::EraseSolutionWorker::GetConfiguredElementsPerSecond(&context),
+      solutionModule::EraseSolutionWorker::DEFAULT_ELEMENTS_PER_SECOND);
+
+  loader.loadScsFile(context, ERASE_SOLUTION_MODULE_TEST_FILES_DIR_PATH + "erasedElementsPerSecond.scs");
+  EXPECT_EQ(solutionModule::EraseSolutionWorker::GetConfiguredElementsPerSecond(&context), 250u);
+}
+
 }  // namespace eraseSolutionAgentTest